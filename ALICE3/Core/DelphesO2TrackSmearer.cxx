@@ -36,6 +36,13 @@
 
 #include "ALICE3/Core/DelphesO2TrackSmearer.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <mutex>
+
 namespace o2
 {
 namespace delphes
@@ -43,130 +50,181 @@ namespace delphes
 
 /*****************************************************************/
 
-bool TrackSmearer::loadTable(int pdg, const char* filename, bool forceReload)
+LUTTable::~LUTTable()
 {
-  auto ipdg = getIndexPDG(pdg);
-  if (mLUTHeader[ipdg] && !forceReload) {
-    std::cout << " --- LUT table for PDG " << pdg << " has been already loaded with index " << ipdg << std::endl;
-    return false;
+  if (mMapping) {
+    munmap(mMapping, mMappingSize);
+  }
+}
+
+/*****************************************************************/
+
+std::shared_ptr<LUTTable> LUTTable::open(int pdg, const char* filename, bool forceReload)
+{
+  // tables already loaded in this process, by file name
+  static std::mutex registryMutex;
+  static std::map<std::string, std::weak_ptr<LUTTable>> registry;
+  std::lock_guard<std::mutex> lock(registryMutex);
+  if (!forceReload) {
+    auto loaded = registry.find(filename);
+    if (loaded != registry.end()) {
+      if (auto table = loaded->second.lock(); table && table->mHeader.pdg == pdg) {
+        std::cout << " --- sharing covariance matrix table for PDG " << pdg << ": " << filename << std::endl;
+        return table;
+      }
+    }
   }
-  mLUTHeader[ipdg] = new lutHeader_t;
 
+  std::shared_ptr<LUTTable> table(new LUTTable);
   std::ifstream lutFile(filename, std::ifstream::binary);
   if (!lutFile.is_open()) {
     std::cout << " --- cannot open covariance matrix file for PDG " << pdg << ": " << filename << std::endl;
-    delete mLUTHeader[ipdg];
-    mLUTHeader[ipdg] = nullptr;
-    return false;
+    return nullptr;
   }
-  lutFile.read(reinterpret_cast<char*>(mLUTHeader[ipdg]), sizeof(lutHeader_t));
+  lutFile.read(reinterpret_cast<char*>(&table->mHeader), sizeof(lutHeader_t));
   if (lutFile.gcount() != sizeof(lutHeader_t)) {
     std::cout << " --- troubles reading covariance matrix header for PDG " << pdg << ": " << filename << std::endl;
-    delete mLUTHeader[ipdg];
-    mLUTHeader[ipdg] = nullptr;
-    return false;
+    return nullptr;
   }
-  if (mLUTHeader[ipdg]->version != LUTCOVM_VERSION) {
-    std::cout << " --- LUT header version mismatch: expected/detected = " << LUTCOVM_VERSION << "/" << mLUTHeader[ipdg]->version << std::endl;
-    delete mLUTHeader[ipdg];
-    mLUTHeader[ipdg] = nullptr;
-    return false;
+  if (table->mHeader.version != LUTCOVM_VERSION) {
+    std::cout << " --- LUT header version mismatch: expected/detected = " << LUTCOVM_VERSION << "/" << table->mHeader.version << std::endl;
+    return nullptr;
   }
-  if (mLUTHeader[ipdg]->pdg != pdg) {
-    std::cout << " --- LUT header PDG mismatch: expected/detected = " << pdg << "/" << mLUTHeader[ipdg]->pdg << std::endl;
-    delete mLUTHeader[ipdg];
-    mLUTHeader[ipdg] = nullptr;
-    return false;
+  if (table->mHeader.pdg != pdg) {
+    std::cout << " --- LUT header PDG mismatch: expected/detected = " << pdg << "/" << table->mHeader.pdg << std::endl;
+    return nullptr;
   }
-  const int nnch = mLUTHeader[ipdg]->nchmap.nbins;
-  const int nrad = mLUTHeader[ipdg]->radmap.nbins;
-  const int neta = mLUTHeader[ipdg]->etamap.nbins;
-  const int npt = mLUTHeader[ipdg]->ptmap.nbins;
-  mLUTEntry[ipdg] = new lutEntry_t****[nnch];
-  for (int inch = 0; inch < nnch; ++inch) {
-    mLUTEntry[ipdg][inch] = new lutEntry_t***[nrad];
-    for (int irad = 0; irad < nrad; ++irad) {
-      mLUTEntry[ipdg][inch][irad] = new lutEntry_t**[neta];
-      for (int ieta = 0; ieta < neta; ++ieta) {
-        mLUTEntry[ipdg][inch][irad][ieta] = new lutEntry_t*[npt];
-        for (int ipt = 0; ipt < npt; ++ipt) {
-          mLUTEntry[ipdg][inch][irad][ieta][ipt] = new lutEntry_t;
-          lutFile.read(reinterpret_cast<char*>(mLUTEntry[ipdg][inch][irad][ieta][ipt]), sizeof(lutEntry_t));
-          if (lutFile.gcount() != sizeof(lutEntry_t)) {
-            std::cout << " --- troubles reading covariance matrix entry for PDG " << pdg << ": " << filename << std::endl;
-            return false;
-          }
-        }
-      }
+  const size_t nEntries = static_cast<size_t>(table->mHeader.nchmap.nbins) * table->mHeader.radmap.nbins * table->mHeader.etamap.nbins * table->mHeader.ptmap.nbins;
+  const size_t fileSize = sizeof(lutHeader_t) + nEntries * sizeof(lutEntry_t);
+
+  // the entries follow the header in the file, so that they can be used in place
+  int fd = ::open(filename, O_RDONLY);
+  struct stat fileStat;
+  if (fd >= 0 && fstat(fd, &fileStat) == 0 && static_cast<size_t>(fileStat.st_size) >= fileSize) {
+    void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapping != MAP_FAILED) {
+      table->mMapping = mapping;
+      table->mMappingSize = fileSize;
+      table->mEntries = reinterpret_cast<const lutEntry_t*>(static_cast<const char*>(mapping) + sizeof(lutHeader_t));
     }
   }
-  std::cout << " --- read covariance matrix table for PDG " << pdg << ": " << filename << std::endl;
-  mLUTHeader[ipdg]->print();
-
+  if (fd >= 0) {
+    ::close(fd);
+  }
+  if (!table->mEntries) {
+    table->mBuffer.resize(nEntries);
+    lutFile.read(reinterpret_cast<char*>(table->mBuffer.data()), nEntries * sizeof(lutEntry_t));
+    if (static_cast<size_t>(lutFile.gcount()) != nEntries * sizeof(lutEntry_t)) {
+      std::cout << " --- troubles reading covariance matrix entry for PDG " << pdg << ": " << filename << std::endl;
+      return nullptr;
+    }
+    table->mEntries = table->mBuffer.data();
+  }
   lutFile.close();
+
+  registry[filename] = table;
+  return table;
+}
+
+/*****************************************************************/
+
+bool TrackSmearer::loadTable(int pdg, const char* filename, bool forceReload)
+{
+  auto ipdg = getIndexPDG(pdg);
+  if (mLUT[ipdg] && !forceReload) {
+    std::cout << " --- LUT table for PDG " << pdg << " has been already loaded with index " << ipdg << std::endl;
+    return false;
+  }
+  mLUT[ipdg] = LUTTable::open(pdg, filename, forceReload);
+  if (!mLUT[ipdg]) {
+    return false;
+  }
+  std::cout << " --- read covariance matrix table for PDG " << pdg << ": " << filename << std::endl;
+  mLUT[ipdg]->getHeader()->print();
   return true;
 }
 
 /*****************************************************************/
 
-lutEntry_t*
+TrackSmearer::NchBin TrackSmearer::findNchBin(const lutHeader_t& header, float nch) const
+{
+  NchBin nchBin;
+  nchBin.inch = header.nchmap.find(nch);
+  nchBin.fraction = header.nchmap.fracPositionWithinBin(nch);
+  nchBin.comparisonValue = header.nchmap.log ? log10(nch) : nch;
+  return nchBin;
+}
+
+/*****************************************************************/
+
+const lutEntry_t*
   TrackSmearer::getLUTEntry(int pdg, float nch, float radius, float eta, float pt, float& interpolatedEff)
 {
   auto ipdg = getIndexPDG(pdg);
-  if (!mLUTHeader[ipdg])
+  if (!mLUT[ipdg])
     return nullptr;
-  auto inch = mLUTHeader[ipdg]->nchmap.find(nch);
-  auto irad = mLUTHeader[ipdg]->radmap.find(radius);
-  auto ieta = mLUTHeader[ipdg]->etamap.find(eta);
-  auto ipt = mLUTHeader[ipdg]->ptmap.find(pt);
+  return getLUTEntry(*mLUT[ipdg], findNchBin(mLUT[ipdg]->header(), nch), radius, eta, pt, interpolatedEff);
+} //;
+
+/*****************************************************************/
+
+const lutEntry_t*
+  TrackSmearer::getLUTEntry(const LUTTable& lut, const NchBin& nchBin, float radius, float eta, float pt, float& interpolatedEff) const
+{
+  const auto& header = lut.header();
+  auto inch = nchBin.inch;
+  auto irad = header.radmap.find(radius);
+  auto ieta = header.etamap.find(eta);
+  auto ipt = header.ptmap.find(pt);
+  const lutEntry_t* entry = lut.getEntry(inch, irad, ieta, ipt);
 
   // Interpolate if requested
-  auto fraction = mLUTHeader[ipdg]->nchmap.fracPositionWithinBin(nch);
+  auto fraction = nchBin.fraction;
   if (mInterpolateEfficiency) {
     if (fraction > 0.5) {
       if (mWhatEfficiency == 1) {
-        if (inch < mLUTHeader[ipdg]->nchmap.nbins - 1) {
-          interpolatedEff = (1.5f - fraction) * mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff + (-0.5f + fraction) * mLUTEntry[ipdg][inch + 1][irad][ieta][ipt]->eff;
+        if (inch < header.nchmap.nbins - 1) {
+          interpolatedEff = (1.5f - fraction) * entry->eff + (-0.5f + fraction) * lut.getEntry(inch + 1, irad, ieta, ipt)->eff;
         } else {
-          interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff;
+          interpolatedEff = entry->eff;
         }
       }
       if (mWhatEfficiency == 2) {
-        if (inch < mLUTHeader[ipdg]->nchmap.nbins - 1) {
-          interpolatedEff = (1.5f - fraction) * mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff2 + (-0.5f + fraction) * mLUTEntry[ipdg][inch + 1][irad][ieta][ipt]->eff2;
+        if (inch < header.nchmap.nbins - 1) {
+          interpolatedEff = (1.5f - fraction) * entry->eff2 + (-0.5f + fraction) * lut.getEntry(inch + 1, irad, ieta, ipt)->eff2;
         } else {
-          interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff2;
+          interpolatedEff = entry->eff2;
         }
       }
     } else {
-      float comparisonValue = mLUTHeader[ipdg]->nchmap.log ? log10(nch) : nch;
+      float comparisonValue = nchBin.comparisonValue;
       if (mWhatEfficiency == 1) {
-        if (inch > 0 && comparisonValue < mLUTHeader[ipdg]->nchmap.max) {
-          interpolatedEff = (0.5f + fraction) * mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff + (0.5f - fraction) * mLUTEntry[ipdg][inch - 1][irad][ieta][ipt]->eff;
+        if (inch > 0 && comparisonValue < header.nchmap.max) {
+          interpolatedEff = (0.5f + fraction) * entry->eff + (0.5f - fraction) * lut.getEntry(inch - 1, irad, ieta, ipt)->eff;
         } else {
-          interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff;
+          interpolatedEff = entry->eff;
         }
       }
       if (mWhatEfficiency == 2) {
-        if (inch > 0 && comparisonValue < mLUTHeader[ipdg]->nchmap.max) {
-          interpolatedEff = (0.5f + fraction) * mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff2 + (0.5f - fraction) * mLUTEntry[ipdg][inch - 1][irad][ieta][ipt]->eff2;
+        if (inch > 0 && comparisonValue < header.nchmap.max) {
+          interpolatedEff = (0.5f + fraction) * entry->eff2 + (0.5f - fraction) * lut.getEntry(inch - 1, irad, ieta, ipt)->eff2;
         } else {
-          interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff2;
+          interpolatedEff = entry->eff2;
         }
       }
     }
   } else {
     if (mWhatEfficiency == 1)
-      interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff;
+      interpolatedEff = entry->eff;
     if (mWhatEfficiency == 2)
-      interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff2;
+      interpolatedEff = entry->eff2;
   }
-  return mLUTEntry[ipdg][inch][irad][ieta][ipt];
+  return entry;
 } //;
 
 /*****************************************************************/
 
-bool TrackSmearer::smearTrack(O2Track& o2track, lutEntry_t* lutEntry, float interpolatedEff)
+bool TrackSmearer::smearTrack(O2Track& o2track, const lutEntry_t* lutEntry, float interpolatedEff)
 {
   bool isReconstructed = true;
   // generate efficiency
@@ -228,6 +286,31 @@ bool TrackSmearer::smearTrack(O2Track& o2track, int pdg, float nch)
   return smearTrack(o2track, lutEntry, interpolatedEff);
 }
 
+/*****************************************************************/
+
+void TrackSmearer::smearTracks(std::span<O2Track> o2tracks, int pdg, float nch, std::vector<bool>& isReconstructed)
+{
+  isReconstructed.assign(o2tracks.size(), false);
+  auto ipdg = getIndexPDG(pdg);
+  if (!mLUT[ipdg])
+    return;
+  const LUTTable& lut = *mLUT[ipdg];
+  const NchBin nchBin = findNchBin(lut.header(), nch);
+  const bool isHelium3 = abs(pdg) == 1000020030;
+  for (size_t itrack = 0; itrack < o2tracks.size(); ++itrack) {
+    auto& o2track = o2tracks[itrack];
+    auto pt = o2track.getPt();
+    if (isHelium3) {
+      pt *= 2.f;
+    }
+    float interpolatedEff = 0.0f;
+    auto lutEntry = getLUTEntry(lut, nchBin, 0., o2track.getEta(), pt, interpolatedEff);
+    if (!lutEntry->valid)
+      continue;
+    isReconstructed[itrack] = smearTrack(o2track, lutEntry, interpolatedEff);
+  }
+}
+
 /*****************************************************************/
 // relative uncertainty on pt
 double TrackSmearer::getPtRes(int pdg, float nch, float eta, float pt)
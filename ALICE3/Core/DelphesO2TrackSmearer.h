@@ -25,6 +25,10 @@
 #define ALICE3_CORE_DELPHESO2TRACKSMEARER_H_
 
 #include <map>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
 #include <iostream>
 #include <fstream>
 
@@ -46,7 +50,7 @@ struct map_t {
   float min = 0.;
   float max = 1.e6;
   bool log = false;
-  float eval(int bin)
+  float eval(int bin) const
   {
     float width = (max - min) / nbins;
     float val = min + (bin + 0.5) * width;
@@ -55,7 +59,7 @@ struct map_t {
     return val;
   }
   // function needed to interpolate some dimensions
-  float fracPositionWithinBin(float val)
+  float fracPositionWithinBin(float val) const
   {
     float width = (max - min) / nbins;
     int bin;
@@ -70,7 +74,7 @@ struct map_t {
     return returnVal;
   }
 
-  int find(float val)
+  int find(float val) const
   {
     float width = (max - min) / nbins;
     int bin;
@@ -86,7 +90,7 @@ struct map_t {
       return nbins - 1;
     return bin;
   }                                                                                                            //;
-  void print() { printf("nbins = %d, min = %f, max = %f, log = %s \n", nbins, min, max, log ? "on" : "off"); } //;
+  void print() const { printf("nbins = %d, min = %f, max = %f, log = %s \n", nbins, min, max, log ? "on" : "off"); } //;
 };
 
 struct lutHeader_t {
@@ -98,11 +102,11 @@ struct lutHeader_t {
   map_t radmap;
   map_t etamap;
   map_t ptmap;
-  bool check_version()
+  bool check_version() const
   {
     return (version == LUTCOVM_VERSION);
   } //;
-  void print()
+  void print() const
   {
     printf(" version: %d \n", version);
     printf("     pdg: %d \n", pdg);
@@ -168,6 +172,35 @@ namespace o2
 namespace delphes
 {
 
+/// LUT of one particle species: the header and all the entries in a single contiguous array, in the order of the binary file.
+/// The file is memory-mapped read-only and shared by all the smearers of the process which load the same file.
+class LUTTable
+{
+ public:
+  ~LUTTable();
+  LUTTable(const LUTTable&) = delete;
+  LUTTable& operator=(const LUTTable&) = delete;
+
+  /// Opens a LUT file, reusing the mapping if the file is already loaded in the process
+  static std::shared_ptr<LUTTable> open(int pdg, const char* filename, bool forceReload = false);
+
+  const lutEntry_t* getEntry(int inch, int irad, int ieta, int ipt) const
+  {
+    return mEntries + ((static_cast<size_t>(inch) * mHeader.radmap.nbins + irad) * mHeader.etamap.nbins + ieta) * mHeader.ptmap.nbins + ipt;
+  }
+  const lutHeader_t* getHeader() const { return &mHeader; }
+  const lutHeader_t& header() const { return mHeader; }
+
+ private:
+  LUTTable() = default;
+
+  lutHeader_t mHeader;                  // copy of the file header
+  const lutEntry_t* mEntries = nullptr; // first entry, in the mapping or in mBuffer
+  void* mMapping = nullptr;             // read-only mapping of the whole file
+  size_t mMappingSize = 0;              // size of the mapping
+  std::vector<lutEntry_t> mBuffer;      // entries read from the file, if it cannot be mapped
+};
+
 class TrackSmearer
 {
 
@@ -181,11 +214,14 @@ class TrackSmearer
   void interpolateEfficiency(bool val) { mInterpolateEfficiency = val; }      //;
   void skipUnreconstructed(bool val) { mSkipUnreconstructed = val; }          //;
   void setWhatEfficiency(int val) { mWhatEfficiency = val; }                  //;
-  lutHeader_t* getLUTHeader(int pdg) { return mLUTHeader[getIndexPDG(pdg)]; } //;
-  lutEntry_t* getLUTEntry(int pdg, float nch, float radius, float eta, float pt, float& interpolatedEff);
+  const lutHeader_t* getLUTHeader(int pdg) const { return mLUT[getIndexPDG(pdg)] ? mLUT[getIndexPDG(pdg)]->getHeader() : nullptr; } //;
+  const lutEntry_t* getLUTEntry(int pdg, float nch, float radius, float eta, float pt, float& interpolatedEff);
 
-  bool smearTrack(O2Track& o2track, lutEntry_t* lutEntry, float interpolatedEff);
+  bool smearTrack(O2Track& o2track, const lutEntry_t* lutEntry, float interpolatedEff);
   bool smearTrack(O2Track& o2track, int pdg, float nch);
+  /// Smears tracks of the same species and multiplicity, the multiplicity bin is looked up once for all of them
+  /// \param isReconstructed is filled with the return value of smearTrack for each track
+  void smearTracks(std::span<O2Track> o2tracks, int pdg, float nch, std::vector<bool>& isReconstructed);
   // bool smearTrack(Track& track, bool atDCA = true); // Only in DelphesO2
   double getPtRes(int pdg, float nch, float eta, float pt);
   double getEtaRes(int pdg, float nch, float eta, float pt);
@@ -193,7 +229,7 @@ class TrackSmearer
   double getAbsEtaRes(int pdg, float nch, float eta, float pt);
   double getEfficiency(int pdg, float nch, float eta, float pt);
 
-  int getIndexPDG(int pdg)
+  int getIndexPDG(int pdg) const
   {
     switch (abs(pdg)) {
       case 11:
@@ -220,9 +256,17 @@ class TrackSmearer
   void setdNdEta(float val) { mdNdEta = val; } //;
 
  protected:
+  /// multiplicity bin and interpolation weights, common to all the tracks of an event
+  struct NchBin {
+    int inch = 0;
+    float fraction = 0.5f;
+    float comparisonValue = 0.f;
+  };
+  NchBin findNchBin(const lutHeader_t& header, float nch) const;
+  const lutEntry_t* getLUTEntry(const LUTTable& lut, const NchBin& nchBin, float radius, float eta, float pt, float& interpolatedEff) const;
+
   static constexpr unsigned int nLUTs = 8; // Number of LUT available
-  lutHeader_t* mLUTHeader[nLUTs] = {nullptr};
-  lutEntry_t***** mLUTEntry[nLUTs] = {nullptr};
+  std::shared_ptr<LUTTable> mLUT[nLUTs];
   bool mUseEfficiency = true;
   bool mInterpolateEfficiency = false;
   bool mSkipUnreconstructed = true; // don't smear tracks that are not reco'ed
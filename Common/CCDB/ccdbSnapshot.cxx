@@ -0,0 +1,355 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file ccdbSnapshot.cxx
+/// \brief Local, content-addressed snapshot of the CCDB objects used by a workflow
+
+#include "ccdbSnapshot.h"
+
+#include <TFile.h>
+#include <TMD5.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "CCDB/CcdbApi.h"
+#include "Framework/Logger.h"
+
+namespace o2::common::ccdb
+{
+
+namespace
+{
+void sortByValidity(std::vector<CCDBSnapshotEntry>& entries)
+{
+  std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a.validFrom < b.validFrom; });
+}
+} // namespace
+
+bool CCDBSnapshot::open(std::string const& directory)
+{
+  mDirectory = directory;
+  if (!readIndex(mEntries, mRuns)) {
+    LOGF(error, "No CCDB snapshot index found in %s", directory);
+    mDirectory.clear();
+    return false;
+  }
+  LOGF(info, "Opened CCDB snapshot %s: %zu objects for %zu runs", directory, getNEntries(), mRuns.size());
+  return true;
+}
+
+bool CCDBSnapshot::create(std::string const& directory)
+{
+  std::error_code error;
+  std::filesystem::create_directories(std::filesystem::path(directory) / ObjectDirName, error);
+  if (error) {
+    LOGF(error, "Cannot create the CCDB snapshot directory %s: %s", directory, error.message());
+    return false;
+  }
+  mDirectory = directory;
+  readIndex(mEntries, mRuns); // keep the content of an existing snapshot
+  return true;
+}
+
+int CCDBSnapshot::prefetch(o2::ccdb::CcdbApi& api, std::string const& path, int runNumber, int64_t from, int64_t until, std::map<std::string, std::string> metadata)
+{
+  const std::string objectDir = (std::filesystem::path(mDirectory) / ObjectDirName).string();
+  const std::string tmpName = "tmp_" + std::to_string(getpid()) + ".root";
+  auto& entries = mEntries[path];
+
+  int nAdded = 0;
+  int64_t timestamp = from;
+  for (int iObject = 0; timestamp < until && iObject < MaxObjectsPerRun; iObject++) {
+    auto headers = api.retrieveHeaders(path, metadata, timestamp);
+    if (headers.find("Valid-From") == headers.end() || headers.find("Valid-Until") == headers.end()) {
+      // not fatal: the tasks may treat the object as optional, the missing object is reported when they read it
+      LOGF(warning, "No object for %s at timestamp %lld, not added to the CCDB snapshot", path, timestamp);
+      break;
+    }
+    CCDBSnapshotEntry entry{path, runNumber, std::stoll(headers["Valid-From"]), std::stoll(headers["Valid-Until"]), ""};
+
+    // the object may already be in the snapshot, e.g. valid for several runs
+    auto sameValidity = std::find_if(entries.begin(), entries.end(), [&entry](const auto& other) { return other.validFrom == entry.validFrom && other.validUntil == entry.validUntil; });
+    if (sameValidity == entries.end()) {
+      if (!api.retrieveBlob(path, objectDir, metadata, timestamp, false, tmpName)) {
+        LOGF(error, "Cannot retrieve %s for timestamp %lld", path, timestamp);
+        return -1;
+      }
+      const std::string tmpFile = (std::filesystem::path(objectDir) / tmpName).string();
+      std::unique_ptr<TMD5> md5{TMD5::FileChecksum(tmpFile.c_str())};
+      if (!md5) {
+        LOGF(error, "Cannot compute the checksum of %s", tmpFile);
+        return -1;
+      }
+      entry.hash = md5->AsString();
+      std::error_code error;
+      if (std::filesystem::exists(objectFileName(entry.hash))) {
+        std::filesystem::remove(tmpFile, error); // same content already stored
+      } else {
+        std::filesystem::rename(tmpFile, objectFileName(entry.hash), error);
+      }
+      if (error) {
+        LOGF(error, "Cannot store %s in the CCDB snapshot: %s", path, error.message());
+        return -1;
+      }
+      entries.push_back(entry);
+      nAdded++;
+    }
+    if (entry.validUntil <= timestamp) {
+      break; // degenerate validity, the next query would return the same object
+    }
+    timestamp = entry.validUntil;
+  }
+  sortByValidity(entries);
+  return nAdded;
+}
+
+bool CCDBSnapshot::prefetchRun(o2::ccdb::CcdbApi& api, std::vector<std::string> const& paths, std::vector<std::string> const& pathsWithRunNumber, int runNumber, int64_t sor, int64_t eor)
+{
+  if (hasRun(runNumber)) {
+    return true;
+  }
+  // stored by run number, read by BasicCCDBManager::getRunDuration
+  if (prefetch(api, RunInformationPath, runNumber, runNumber, runNumber + 1) < 0) {
+    return false;
+  }
+  for (const auto& path : paths) {
+    std::map<std::string, std::string> metadata;
+    if (std::find(pathsWithRunNumber.begin(), pathsWithRunNumber.end(), path) != pathsWithRunNumber.end()) {
+      metadata["runNumber"] = std::to_string(runNumber);
+    }
+    const int nAdded = prefetch(api, path, runNumber, sor, eor + 1, metadata);
+    if (nAdded < 0) {
+      return false;
+    }
+    LOGF(info, "Run %d: %d new object(s) for %s", runNumber, nAdded, path);
+  }
+  mRuns[runNumber] = {sor, eor};
+  return writeRunView(runNumber);
+}
+
+bool CCDBSnapshot::writeRunView(int runNumber) const
+{
+  const auto viewDir = std::filesystem::path(getRunViewDirectory(mDirectory, runNumber));
+  for (const auto& [path, entries] : mEntries) {
+    // the object valid in the middle of the run, as read by the tasks at the run change, or the one stored by run number
+    CCDBSnapshotEntry const* entry = findForRun(path, runNumber);
+    if (entry == nullptr) {
+      entry = find(path, runNumber);
+    }
+    if (entry == nullptr) {
+      continue;
+    }
+    auto run = mRuns.find(runNumber);
+    auto nInRun = std::count_if(entries.begin(), entries.end(), [&run](const auto& e) { return e.validFrom <= run->second.second && e.validUntil > run->second.first; });
+    if (nInRun > 1) {
+      LOGF(warning, "%s changes %ld times within run %d, its view holds the object valid in the middle of the run: read it with CCDBSnapshot::getForTimeStamp if the changes matter", path, nInRun - 1, runNumber);
+    }
+
+    // linked next to its final name and renamed, readers see either the previous or the new view
+    const auto fileName = viewDir / path / RunViewFileName;
+    const auto tmpName = viewDir / path / (std::string(RunViewFileName) + ".tmp_" + std::to_string(getpid()));
+    std::error_code error;
+    std::filesystem::create_directories(fileName.parent_path(), error);
+    if (!error) {
+      std::filesystem::remove(tmpName, error);
+      std::filesystem::create_hard_link(objectFileName(entry->hash), tmpName, error);
+      if (error) { // e.g. file system without hard links
+        std::filesystem::copy_file(objectFileName(entry->hash), tmpName, error);
+      }
+    }
+    if (!error) {
+      std::filesystem::rename(tmpName, fileName, error);
+    }
+    if (error) {
+      LOGF(error, "Cannot write the view of run %d for %s: %s", runNumber, path, error.message());
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CCDBSnapshot::writeIndex()
+{
+  const auto lockFile = std::filesystem::path(mDirectory) / LockFileName;
+  int lock = ::open(lockFile.c_str(), O_CREAT | O_RDWR, 0644);
+  if (lock < 0 || flock(lock, LOCK_EX) != 0) {
+    LOGF(error, "Cannot lock the CCDB snapshot index %s", lockFile.string());
+    if (lock >= 0) {
+      close(lock);
+    }
+    return false;
+  }
+
+  // merge with the entries written meanwhile by other jobs
+  std::unordered_map<std::string, std::vector<CCDBSnapshotEntry>> entriesOnDisk;
+  std::map<int, std::pair<int64_t, int64_t>> runsOnDisk;
+  readIndex(entriesOnDisk, runsOnDisk);
+  for (auto& [path, entries] : entriesOnDisk) {
+    auto& merged = mEntries[path];
+    for (auto& entry : entries) {
+      if (std::none_of(merged.begin(), merged.end(), [&entry](const auto& other) { return other.validFrom == entry.validFrom && other.validUntil == entry.validUntil; })) {
+        merged.push_back(std::move(entry));
+      }
+    }
+    sortByValidity(merged);
+  }
+  mRuns.insert(runsOnDisk.begin(), runsOnDisk.end());
+
+  const auto indexFile = std::filesystem::path(mDirectory) / IndexFileName;
+  const auto tmpFile = std::filesystem::path(mDirectory) / (std::string(IndexFileName) + ".tmp_" + std::to_string(getpid()));
+  bool written = false;
+  {
+    std::ofstream out(tmpFile);
+    if (out) {
+      for (const auto& [run, duration] : mRuns) {
+        out << "#run " << run << " " << duration.first << " " << duration.second << "\n";
+      }
+      for (const auto& [path, entries] : mEntries) {
+        for (const auto& entry : entries) {
+          out << entry.path << " " << entry.runNumber << " " << entry.validFrom << " " << entry.validUntil << " " << entry.hash << "\n";
+        }
+      }
+      written = static_cast<bool>(out);
+    }
+  }
+  std::error_code error;
+  if (written) {
+    std::filesystem::rename(tmpFile, indexFile, error); // readers see either the old or the new index
+  }
+  flock(lock, LOCK_UN);
+  close(lock);
+  if (!written || error) {
+    LOGF(error, "Cannot write the CCDB snapshot index %s: %s", indexFile.string(), error.message());
+    return false;
+  }
+  return true;
+}
+
+std::size_t CCDBSnapshot::getNEntries() const
+{
+  std::size_t nEntries = 0;
+  for (const auto& [path, entries] : mEntries) {
+    nEntries += entries.size();
+  }
+  return nEntries;
+}
+
+CCDBSnapshotEntry const* CCDBSnapshot::find(std::string const& path, int64_t timestamp) const
+{
+  auto pathEntries = mEntries.find(path);
+  if (pathEntries == mEntries.end()) {
+    return nullptr;
+  }
+  const auto& entries = pathEntries->second;
+  // last entry starting before the timestamp
+  auto entry = std::upper_bound(entries.begin(), entries.end(), timestamp, [](int64_t ts, const auto& e) { return ts < e.validFrom; });
+  if (entry == entries.begin()) {
+    return nullptr;
+  }
+  --entry;
+  return timestamp < entry->validUntil ? &(*entry) : nullptr;
+}
+
+CCDBSnapshotEntry const* CCDBSnapshot::findForRun(std::string const& path, int runNumber) const
+{
+  auto run = mRuns.find(runNumber);
+  if (run == mRuns.end()) {
+    return nullptr;
+  }
+  return find(path, run->second.first / 2 + run->second.second / 2);
+}
+
+std::pair<int64_t, int64_t> CCDBSnapshot::getRunDuration(int runNumber) const
+{
+  auto run = mRuns.find(runNumber);
+  return run == mRuns.end() ? std::pair<int64_t, int64_t>{0, 0} : run->second;
+}
+
+std::string CCDBSnapshot::getRunViewDirectory(std::string const& directory, int runNumber)
+{
+  return (std::filesystem::path(directory) / RunViewDirName / std::to_string(runNumber)).string();
+}
+
+std::string CCDBSnapshot::getRunUrl(std::string const& directory, int runNumber)
+{
+  const auto viewDir = std::filesystem::absolute(getRunViewDirectory(directory, runNumber));
+  if (!std::filesystem::is_directory(viewDir)) {
+    return "";
+  }
+  return "file://" + viewDir.string();
+}
+
+void* CCDBSnapshot::load(CCDBSnapshotEntry const* entry, TClass* cl)
+{
+  if (entry == nullptr || cl == nullptr) {
+    return nullptr;
+  }
+  auto cached = mObjects.find(entry->hash);
+  if (cached != mObjects.end()) {
+    return cached->second.get();
+  }
+  std::unique_ptr<TFile> file{TFile::Open(objectFileName(entry->hash).c_str(), "READ")};
+  if (!file || file->IsZombie()) {
+    LOGF(error, "Cannot open %s from the CCDB snapshot", entry->path);
+    return nullptr;
+  }
+  void* object = o2::ccdb::CcdbApi::extractFromTFile(*file, cl);
+  if (object == nullptr) {
+    LOGF(error, "Cannot read %s of class %s from the CCDB snapshot", entry->path, cl->GetName());
+    return nullptr;
+  }
+  mObjects.emplace(entry->hash, std::shared_ptr<void>(object, [cl](void* obj) { cl->Destructor(obj); }));
+  return object;
+}
+
+bool CCDBSnapshot::readIndex(std::unordered_map<std::string, std::vector<CCDBSnapshotEntry>>& entries, std::map<int, std::pair<int64_t, int64_t>>& runs) const
+{
+  std::ifstream in(std::filesystem::path(mDirectory) / IndexFileName);
+  if (!in) {
+    return false;
+  }
+  entries.clear();
+  runs.clear();
+  std::string line;
+  while (std::getline(in, line)) {
+    std::istringstream fields(line);
+    if (line.rfind("#run ", 0) == 0) {
+      std::string tag;
+      int run = 0;
+      int64_t sor = 0, eor = 0;
+      if (fields >> tag >> run >> sor >> eor) {
+        runs[run] = {sor, eor};
+      }
+      continue;
+    }
+    CCDBSnapshotEntry entry;
+    if (fields >> entry.path >> entry.runNumber >> entry.validFrom >> entry.validUntil >> entry.hash) {
+      entries[entry.path].push_back(entry);
+    }
+  }
+  for (auto& [path, pathEntries] : entries) {
+    sortByValidity(pathEntries);
+  }
+  return true;
+}
+
+std::string CCDBSnapshot::objectFileName(std::string const& hash) const
+{
+  return (std::filesystem::path(mDirectory) / ObjectDirName / (hash + ".root")).string();
+}
+
+} // namespace o2::common::ccdb
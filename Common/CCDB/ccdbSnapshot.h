@@ -0,0 +1,156 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file ccdbSnapshot.h
+/// \brief Local, content-addressed snapshot of the CCDB objects used by a workflow
+
+#ifndef COMMON_CCDB_CCDBSNAPSHOT_H_
+#define COMMON_CCDB_CCDBSNAPSHOT_H_
+
+#include <TClass.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace o2::ccdb
+{
+class CcdbApi;
+}
+
+namespace o2::common::ccdb
+{
+
+/// One object of the snapshot: CCDB path, validity and the content hash of the stored blob
+struct CCDBSnapshotEntry {
+  std::string path;
+  int runNumber = -1;     ///< run for which the object was fetched (-1 if fetched by timestamp only)
+  int64_t validFrom = 0;  ///< start of validity (ms), inclusive
+  int64_t validUntil = 0; ///< end of validity (ms), exclusive
+  std::string hash;       ///< MD5 of the blob, name of the file in the object directory
+};
+
+// Local stand-in for the CCDB server, filled once per data set and then read by the analysis devices.
+//
+// The snapshot directory contains
+//   objects/<md5>.root             : the blobs as served by the CCDB (with their headers), stored once per content
+//   index.txt                      : one line per object and validity interval, "path run validFrom validUntil md5",
+//                                    plus one "#run run sor eor" line per prefetched run
+//   runs/<run>/<path>/snapshot.root : per-run view in the layout of the CcdbApi snapshots, hard links to the blobs
+//                                    valid in the middle of the run
+// Blobs are never modified once written, and the index and the run views are merged under a lock and replaced
+// atomically, so that several jobs can fill the same snapshot and all the devices of a node can share it read-only.
+//
+// The objects can be read in two ways:
+//  - with getForTimeStamp / getForRun / getRunDuration, which mirror BasicCCDBManager and resolve the object
+//    valid at any timestamp, including objects changing within a run;
+//  - without any change of the task, by pointing its BasicCCDBManager to the view of the current run,
+//    ccdb->setURL(CCDBSnapshot::getRunUrl(directory, run)), at every run change (see eventSelection.cxx).
+//    This also serves the objects read through BasicCCDBManager by O2 helpers (e.g. AggregatedRunInfo),
+//    but a view holds a single object per path.
+//
+// Usage (writer, see the o2-analysis-ccdb-snapshot workflow):
+//   CCDBSnapshot snapshot;
+//   snapshot.create("/path/to/snapshot");
+//   snapshot.prefetchRun(api, {"GLO/Config/GRPMagField", ...}, {"GLO/Config/GRPECS"}, run, sor, eor);
+//   snapshot.writeIndex();
+// Usage (reader):
+//   CCDBSnapshot snapshot;
+//   snapshot.open("/path/to/snapshot");
+//   auto grpmag = snapshot.getForTimeStamp<o2::parameters::GRPMagField>("GLO/Config/GRPMagField", bc.timestamp());
+class CCDBSnapshot
+{
+ public:
+  static constexpr const char* IndexFileName = "index.txt";
+  static constexpr const char* LockFileName = "index.lock";
+  static constexpr const char* ObjectDirName = "objects";
+  static constexpr const char* RunViewDirName = "runs";
+  static constexpr const char* RunViewFileName = "snapshot.root"; ///< as in CcdbApi::getSnapshotFile
+  static constexpr const char* RunInformationPath = "RCT/Info/RunInformation";
+  static constexpr int MaxObjectsPerRun = 10000; ///< protection against objects with degenerate validity
+
+  CCDBSnapshot() = default;
+
+  /// Opens an existing snapshot for reading
+  /// \return false if the directory does not contain a snapshot index
+  bool open(std::string const& directory);
+
+  /// Opens a snapshot for writing, creating the directory if needed; existing entries are kept
+  bool create(std::string const& directory);
+
+  bool isOpen() const { return !mDirectory.empty(); }
+  std::string const& getDirectory() const { return mDirectory; }
+
+  /// Fetches from the CCDB all objects of a path valid in [from, until) and adds them to the snapshot
+  /// \param runNumber is the run for which the objects are fetched, only used for bookkeeping
+  /// \return number of validity intervals added, -1 if the query failed
+  int prefetch(o2::ccdb::CcdbApi& api, std::string const& path, int runNumber, int64_t from, int64_t until, std::map<std::string, std::string> metadata = {});
+
+  /// Fetches all the paths for the duration [sor, eor] of a run, unless the run is already in the snapshot,
+  /// together with the run information (RCT/Info/RunInformation) and the view of the run
+  /// \param pathsWithRunNumber are queried with the runNumber metadata, as done by BasicCCDBManager::getSpecific for e.g. GLO/Config/GRPECS
+  /// \return false if one of the queries failed
+  bool prefetchRun(o2::ccdb::CcdbApi& api, std::vector<std::string> const& paths, std::vector<std::string> const& pathsWithRunNumber, int runNumber, int64_t sor, int64_t eor);
+
+  /// Merges the entries with the index on disk, which may have been updated by other jobs, and replaces it atomically
+  bool writeIndex();
+
+  bool hasRun(int runNumber) const { return mRuns.find(runNumber) != mRuns.end(); }
+  std::size_t getNEntries() const;
+
+  /// \return entry of the path valid at this timestamp, nullptr if there is none
+  CCDBSnapshotEntry const* find(std::string const& path, int64_t timestamp) const;
+  /// \return entry of the path valid in the middle of the run (as BasicCCDBManager::getForRun), nullptr if there is none
+  CCDBSnapshotEntry const* findForRun(std::string const& path, int runNumber) const;
+
+  /// \return object of the path valid at this timestamp, nullptr if it is not in the snapshot
+  /// The object is owned by the snapshot and deserialised only once per content
+  template <typename T>
+  T* getForTimeStamp(std::string const& path, int64_t timestamp)
+  {
+    return static_cast<T*>(load(find(path, timestamp), TClass::GetClass<T>()));
+  }
+
+  /// \return object of the path valid in the middle of the run, nullptr if it is not in the snapshot
+  template <typename T>
+  T* getForRun(std::string const& path, int runNumber)
+  {
+    return static_cast<T*>(load(findForRun(path, runNumber), TClass::GetClass<T>()));
+  }
+
+  /// \return SOR and EOR of a prefetched run, as BasicCCDBManager::getRunDuration, {0, 0} if the run is not in the snapshot
+  std::pair<int64_t, int64_t> getRunDuration(int runNumber) const;
+
+  /// \return directory of the view of a run in a snapshot
+  static std::string getRunViewDirectory(std::string const& directory, int runNumber);
+  /// \return URL to be given to BasicCCDBManager::setURL to read the view of a run, empty if the snapshot has no view of this run
+  static std::string getRunUrl(std::string const& directory, int runNumber);
+
+ private:
+  void* load(CCDBSnapshotEntry const* entry, TClass* cl);
+  bool readIndex(std::unordered_map<std::string, std::vector<CCDBSnapshotEntry>>& entries, std::map<int, std::pair<int64_t, int64_t>>& runs) const;
+  bool writeRunView(int runNumber) const;
+  std::string objectFileName(std::string const& hash) const;
+
+  std::string mDirectory;                                                   ///< snapshot directory, empty if not open
+  std::unordered_map<std::string, std::vector<CCDBSnapshotEntry>> mEntries; ///< entries per path, sorted in validity
+  std::map<int, std::pair<int64_t, int64_t>> mRuns;                         ///< prefetched runs and their duration
+  std::unordered_map<std::string, std::shared_ptr<void>> mObjects;          ///< deserialised objects per content hash
+};
+
+} // namespace o2::common::ccdb
+
+#endif // COMMON_CCDB_CCDBSNAPSHOT_H_
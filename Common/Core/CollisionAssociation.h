@@ -20,8 +20,11 @@
 #ifndef COMMON_CORE_COLLISIONASSOCIATION_H_
 #define COMMON_CORE_COLLISIONASSOCIATION_H_
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <vector>
-#include <memory>
+#include <span>
 #include <utility>
 
 #include "CommonConstants/LHCConstants.h"
@@ -57,6 +60,7 @@ class CollisionAssociation
   void setIncludeUnassigned(bool enable = true) { mIncludeUnassigned = enable; }
   void setFillTableOfCollIdsPerTrack(bool fill = true) { mFillTableOfCollIdsPerTrack = fill; }
   void setBcWindow(int bcWindow = 115) { mBcWindowForOneSigma = bcWindow; }
+  void setUseSortedTimeIndex(bool enable = true) { mUseSortedTimeIndex = enable; }
 
   template <typename TTracks, typename Slice, typename Assoc, typename RevIndices>
   void runStandardAssoc(o2::aod::Collisions const& collisions,
@@ -106,9 +110,11 @@ class CollisionAssociation
     // create reverse index track to collisions if enabled
     std::vector<int> empty{};
     if (mFillTableOfCollIdsPerTrack) {
+      std::vector<int> collId(1);
       for (const auto& track : tracks) {
         if (track.has_collision()) {
-          reverseIndices(std::vector<int>{track.collisionId()});
+          collId[0] = track.collisionId();
+          reverseIndices(collId);
         } else {
           reverseIndices(empty);
         }
@@ -125,6 +131,11 @@ class CollisionAssociation
                         Assoc& association,
                         RevIndices& reverseIndices)
   {
+    if (mUseSortedTimeIndex) {
+      runAssocWithTimeSorted(collisions, tracksUnfiltered, tracks, ambiguousTracks, association, reverseIndices);
+      return;
+    }
+
     // cache globalBC and track time in BC for optimization
     std::vector<int64_t> globalBC;
     std::vector<int64_t> trackBCCache;
@@ -177,8 +188,8 @@ class CollisionAssociation
       trackIterationWindows.push_back(std::make_pair(trackBegin, track));
     }
 
-    // define vector of vectors to store indices of compatible collisions per track
-    std::vector<std::unique_ptr<std::vector<int>>> collsPerTrack(tracksUnfiltered.size());
+    // store the (track, collision) pairs to build the reverse index track to collisions
+    std::vector<std::pair<int, int>> trackCollPairs;
 
     // loop over collisions to find time-compatible tracks
     int64_t bcOffsetMax = mBcWindowForOneSigma * mNumSigmaForTimeCompat + mTimeMargin / o2::constants::lhc::LHCBunchSpacingNS;
@@ -266,10 +277,7 @@ class CollisionAssociation
             LOGP(debug, "Filling track id {} for coll id {}", trackIdx, collIdx);
             association(collIdx, trackIdx);
             if (mFillTableOfCollIdsPerTrack) {
-              if (collsPerTrack[trackIdx] == nullptr) {
-                collsPerTrack[trackIdx] = std::make_unique<std::vector<int>>();
-              }
-              collsPerTrack[trackIdx].get()->push_back(collIdx);
+              trackCollPairs.emplace_back(trackIdx, collIdx);
             }
           }
         }
@@ -277,20 +285,217 @@ class CollisionAssociation
     }
     // create reverse index track to collisions if enabled
     if (mFillTableOfCollIdsPerTrack) {
-      std::vector<int> empty{};
-      for (const auto& track : tracksUnfiltered) {
+      fillReverseIndices(tracksUnfiltered, trackCollPairs, reverseIndices);
+    }
+  }
 
-        const auto trackId = track.globalIndex();
-        if (collsPerTrack[trackId] == nullptr) {
-          reverseIndices(empty);
+  /// Time-based association using an index built once per timeframe.
+  /// The tracks are sorted by their time in BC units, so that the tracks compatible with a collision
+  /// are found with a two-pointer sweep (binary search if collisions are not ordered in BC) instead of
+  /// looping over all tracks for each collision. The produced tables are identical to runAssocWithTime.
+  template <typename TTracksUnfiltered, typename TTracks, typename TAmbiTracks, typename Assoc, typename RevIndices>
+  void runAssocWithTimeSorted(o2::aod::Collisions const& collisions,
+                              TTracksUnfiltered const& tracksUnfiltered,
+                              TTracks const& tracks,
+                              TAmbiTracks const& ambiguousTracks,
+                              Assoc& association,
+                              RevIndices& reverseIndices)
+  {
+    // track -> BC of the ambiguous track, to avoid a linear search over the ambiguous tracks per track
+    constexpr int64_t notAmbiguous = std::numeric_limits<int64_t>::min();
+    std::vector<int64_t> ambiguousTrackBC;
+    if (mIncludeUnassigned) {
+      ambiguousTrackBC.assign(tracksUnfiltered.size(), notAmbiguous);
+      for (const auto& ambTrack : ambiguousTracks) {
+        int64_t trackId = -1;
+        if constexpr (isCentralBarrel) { // FIXME: to be removed as soon as it is possible to use getId<Table>() for joined tables
+          trackId = ambTrack.trackId();
         } else {
-          reverseIndices(*collsPerTrack[trackId].get());
+          trackId = ambTrack.template getId<TTracks>();
+        }
+        if (trackId < 0 || trackId >= static_cast<int64_t>(ambiguousTrackBC.size()) || ambiguousTrackBC[trackId] != notAmbiguous) {
+          continue; // only the first ambiguous track entry is considered, as in the linear search
+        }
+        if constexpr (isCentralBarrel) {
+          if (!ambTrack.has_bc() || ambTrack.bc().size() == 0) {
+            ambiguousTrackBC[trackId] = -1;
+            continue;
+          }
+        }
+        ambiguousTrackBC[trackId] = ambTrack.bc().begin().globalBC();
+      }
+    }
+
+    // structure of arrays with the time information of the tracks, in filtered-index order
+    std::vector<int64_t> trackBCs;
+    std::vector<int64_t> trackBCsWithTime;
+    std::vector<float> trackTimes;
+    std::vector<float> trackTimeResos;
+    std::vector<uint8_t> thresholdTypes;
+    std::vector<int> trackIds;
+    trackBCs.reserve(tracks.size());
+    trackBCsWithTime.reserve(tracks.size());
+    trackTimes.reserve(tracks.size());
+    trackTimeResos.reserve(tracks.size());
+    thresholdTypes.reserve(tracks.size());
+    trackIds.reserve(tracks.size());
+    for (const auto& track : tracks) {
+      int64_t trackBC = -1;
+      if (track.has_collision()) {
+        trackBC = track.collision().bc().globalBC();
+      } else if (mIncludeUnassigned && ambiguousTrackBC[track.globalIndex()] != notAmbiguous) {
+        trackBC = ambiguousTrackBC[track.globalIndex()];
+      }
+      if (trackBC < 0) {
+        continue;
+      }
+
+      float trackTime = track.trackTime();
+      float trackTimeRes = track.trackTimeRes();
+      uint8_t thresholdType = ThresholdGaussian;
+      if constexpr (isCentralBarrel) {
+        if (mUsePvAssociation && track.isPVContributor()) {
+          trackTime = track.collision().collisionTime();        // if PV contributor, we assume the time to be the one of the collision
+          trackTimeRes = o2::constants::lhc::LHCBunchSpacingNS; // 1 BC
+          thresholdType = ThresholdFixed;
+        } else if (TESTBIT(track.flags(), o2::aod::track::TrackTimeResIsRange)) {
+          thresholdType = ThresholdRange;
+        }
+      } else {
+        if constexpr (TTracks::template contains<o2::aod::MFTTracks>()) {
+          thresholdType = ThresholdRange;
+        }
+      }
+      trackBCs.push_back(trackBC);
+      trackBCsWithTime.push_back(trackBC + track.trackTime() / o2::constants::lhc::LHCBunchSpacingNS);
+      trackTimes.push_back(trackTime);
+      trackTimeResos.push_back(trackTimeRes);
+      thresholdTypes.push_back(thresholdType);
+      trackIds.push_back(track.globalIndex());
+    }
+
+    // sort the tracks by their time in BC units: all time windows have the same width,
+    // hence the tracks compatible with a collision are a contiguous range of this array
+    const size_t nTracks = trackIds.size();
+    std::vector<uint32_t> sortedTracks(nTracks);
+    for (size_t iTrack = 0; iTrack < nTracks; ++iTrack) {
+      sortedTracks[iTrack] = iTrack;
+    }
+    std::stable_sort(sortedTracks.begin(), sortedTracks.end(), [&trackBCsWithTime](uint32_t a, uint32_t b) { return trackBCsWithTime[a] < trackBCsWithTime[b]; });
+    std::vector<int64_t> sortedBCsWithTime(nTracks);
+    for (size_t iTrack = 0; iTrack < nTracks; ++iTrack) {
+      sortedBCsWithTime[iTrack] = trackBCsWithTime[sortedTracks[iTrack]];
+    }
+
+    std::vector<std::pair<int, int>> trackCollPairs;
+
+    const int64_t bcOffsetMax = mBcWindowForOneSigma * mNumSigmaForTimeCompat + mTimeMargin / o2::constants::lhc::LHCBunchSpacingNS;
+    size_t first = 0, last = 0; // [first, last) range of sorted tracks compatible with the current collision
+    int64_t lastCollBC = std::numeric_limits<int64_t>::min();
+    std::vector<uint32_t> compatibleTracks;
+    for (const auto& collision : collisions) {
+      const float collTime = collision.collisionTime();
+      const float collTimeRes2 = collision.collisionTimeRes() * collision.collisionTimeRes();
+      const int64_t collBC = collision.bc().globalBC();
+
+      if (collBC >= lastCollBC) {
+        // collisions are sorted in BC: advance the two pointers
+        while (first < nTracks && sortedBCsWithTime[first] < collBC - bcOffsetMax) {
+          ++first;
+        }
+        last = std::max(last, first);
+        while (last < nTracks && sortedBCsWithTime[last] <= collBC + bcOffsetMax) {
+          ++last;
+        }
+      } else {
+        first = std::lower_bound(sortedBCsWithTime.begin(), sortedBCsWithTime.end(), collBC - bcOffsetMax) - sortedBCsWithTime.begin();
+        last = std::upper_bound(sortedBCsWithTime.begin() + first, sortedBCsWithTime.end(), collBC + bcOffsetMax) - sortedBCsWithTime.begin();
+      }
+      lastCollBC = collBC;
+
+      compatibleTracks.clear();
+      for (size_t iSorted = first; iSorted < last; ++iSorted) {
+        const uint32_t iTrack = sortedTracks[iSorted];
+        const int64_t bcOffset = trackBCs[iTrack] - collBC;
+        const float trackTimeRes = trackTimeResos[iTrack];
+        const float deltaTime = trackTimes[iTrack] - collTime + bcOffset * o2::constants::lhc::LHCBunchSpacingNS;
+        float sigmaTimeRes2 = collTimeRes2 + trackTimeRes * trackTimeRes;
+
+        float thresholdTime = 0.;
+        switch (thresholdTypes[iTrack]) {
+          case ThresholdFixed:
+            thresholdTime = trackTimeRes;
+            break;
+          case ThresholdRange:
+            // the track time resolution is a range, not a gaussian resolution
+            thresholdTime = trackTimeRes + mNumSigmaForTimeCompat * std::sqrt(collTimeRes2) + mTimeMargin;
+            break;
+          default:
+            thresholdTime = mNumSigmaForTimeCompat * std::sqrt(sigmaTimeRes2) + mTimeMargin;
+        }
+
+        if (std::abs(deltaTime) < thresholdTime) {
+          compatibleTracks.push_back(iTrack);
+        }
+      }
+
+      // fill in the order of the tracks table, as done by runAssocWithTime
+      std::sort(compatibleTracks.begin(), compatibleTracks.end());
+      const auto collIdx = collision.globalIndex();
+      for (const auto iTrack : compatibleTracks) {
+        const auto trackIdx = trackIds[iTrack];
+        LOGP(debug, "Filling track id {} for coll id {}", trackIdx, collIdx);
+        association(collIdx, trackIdx);
+        if (mFillTableOfCollIdsPerTrack) {
+          trackCollPairs.emplace_back(trackIdx, collIdx);
         }
       }
     }
+    // create reverse index track to collisions if enabled
+    if (mFillTableOfCollIdsPerTrack) {
+      fillReverseIndices(tracksUnfiltered, trackCollPairs, reverseIndices);
+    }
   }
 
  private:
+  /// Fills the reverse index track to collisions from the (track, collision) pairs found by the association.
+  /// The index is built as a flat CSR structure (offsets per track and contiguous collision ids) in two passes,
+  /// to avoid one heap allocation per associated track. The collision order per track is the association order.
+  template <typename TTracksUnfiltered, typename RevIndices>
+  void fillReverseIndices(TTracksUnfiltered const& tracksUnfiltered, std::vector<std::pair<int, int>> const& trackCollPairs, RevIndices& reverseIndices)
+  {
+    const size_t nTracks = tracksUnfiltered.size();
+    // first pass: count the compatible collisions per track
+    std::vector<uint32_t> offsets(nTracks + 1, 0);
+    for (const auto& trackCollPair : trackCollPairs) {
+      ++offsets[trackCollPair.first + 1];
+    }
+    for (size_t iTrack = 0; iTrack < nTracks; ++iTrack) {
+      offsets[iTrack + 1] += offsets[iTrack];
+    }
+    // second pass: fill the collision ids
+    std::vector<int> collIds(trackCollPairs.size());
+    std::vector<uint32_t> fillPositions(offsets.begin(), offsets.end() - 1);
+    for (const auto& [trackIdx, collIdx] : trackCollPairs) {
+      collIds[fillPositions[trackIdx]++] = collIdx;
+    }
+
+    // the table builder takes a std::vector, one buffer is reused for all tracks
+    std::vector<int> collIdsThisTrack;
+    for (const auto& track : tracksUnfiltered) {
+      const auto trackId = track.globalIndex();
+      std::span<const int> collIdsSpan(collIds.data() + offsets[trackId], offsets[trackId + 1] - offsets[trackId]);
+      collIdsThisTrack.assign(collIdsSpan.begin(), collIdsSpan.end());
+      reverseIndices(collIdsThisTrack);
+    }
+  }
+
+  enum TimeThresholdType : uint8_t {
+    ThresholdGaussian = 0, // gaussian time resolution of track and collision
+    ThresholdRange,        // track time resolution is a range
+    ThresholdFixed         // PV contributor, time of the collision
+  };
+
   float mNumSigmaForTimeCompat{4.};                                                  // number of sigma for time compatibility
   float mTimeMargin{500.};                                                           // additional time margin in ns
   int mTrackSelection{o2::aod::track_association::TrackSelection::GlobalTrackWoDCA}; // track selection for central barrel tracks (standard association only)
@@ -298,6 +503,7 @@ class CollisionAssociation
   bool mIncludeUnassigned{true};                                                     // include tracks that were originally not assigned to any collision
   bool mFillTableOfCollIdsPerTrack{false};                                           // fill additional table with vectors of compatible collisions per track
   int mBcWindowForOneSigma{115};                                                     // BC window to be multiplied by the number of sigmas to define maximum window to be considered
+  bool mUseSortedTimeIndex{false};                                                   // use the sorted time index (runAssocWithTimeSorted) in the time-based association
 };
 
 #endif // COMMON_CORE_COLLISIONASSOCIATION_H_
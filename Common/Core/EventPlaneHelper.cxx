@@ -54,11 +54,17 @@ double EventPlaneHelper::GetPhiFV0(int chno, o2::fv0::Geometry* fv0geom)
   return TMath::ATan2(chPos.y + offsetY, chPos.x + offsetX);
 }
 
-double EventPlaneHelper::GetPhiFT0(int chno, o2::ft0::Geometry ft0geom)
+double EventPlaneHelper::GetPhiFT0(int chno, o2::ft0::Geometry& ft0geom)
 {
   /* Calculate the azimuthal angle in FT0 for the channel number 'chno'. The offset
     of FT0-A is taken into account if chno is between 0 and 95. */
 
+  ft0geom.calculateChannelCenter();
+  return GetPhiFT0Center(chno, ft0geom);
+}
+
+double EventPlaneHelper::GetPhiFT0Center(int chno, o2::ft0::Geometry& ft0geom)
+{
   float offsetX = 0.;
   float offsetY = 0.; // No offset for FT0-C (default case).
 
@@ -67,14 +73,13 @@ double EventPlaneHelper::GetPhiFT0(int chno, o2::ft0::Geometry ft0geom)
     offsetY = mOffsetFT0AY;
   }
 
-  ft0geom.calculateChannelCenter();
   auto chPos = ft0geom.getChannelCenter(chno);
   /// printf("Channel id: %d X: %.3f Y: %.3f\n", chno, chPos.X(), chPos.Y());
 
   return TMath::ATan2(chPos.Y() + offsetY, chPos.X() + offsetX);
 }
 
-void EventPlaneHelper::SumQvectors(int det, int chno, float ampl, int nmod, TComplex& Qvec, float& sum, o2::ft0::Geometry ft0geom, o2::fv0::Geometry* fv0geom)
+void EventPlaneHelper::SumQvectors(int det, int chno, float ampl, int nmod, TComplex& Qvec, float& sum, o2::ft0::Geometry& ft0geom, o2::fv0::Geometry* fv0geom)
 {
   /* Calculate the complex Q-vector for the provided detector and channel number,
     before adding it to the total Q-vector given as argument. */
@@ -102,6 +107,76 @@ void EventPlaneHelper::SumQvectors(int det, int chno, float ampl, int nmod, TCom
   sum += ampl;
 }
 
+void EventPlaneHelper::SetChannelTables(o2::ft0::Geometry& ft0geom, o2::fv0::Geometry* fv0geom, const std::vector<int>& harmonics)
+{
+  /* Calculate once the azimuthal angles of all the FIT channels, with the offsets
+    currently set, and store cos(n*phi) and sin(n*phi) for each of the harmonics. */
+  ft0geom.calculateChannelCenter();
+  std::vector<double> phiFT0(NChannelsFT0);
+  std::vector<double> phiFV0(NChannelsFV0);
+  for (int chno = 0; chno < NChannelsFT0; chno++) {
+    phiFT0[chno] = GetPhiFT0Center(chno, ft0geom);
+  }
+  for (int chno = 0; chno < NChannelsFV0; chno++) {
+    phiFV0[chno] = GetPhiFV0(chno, fv0geom);
+  }
+
+  mChannelTables.clear();
+  for (const auto& nmod : harmonics) {
+    if (nmod < 0) {
+      continue;
+    }
+    if (nmod >= static_cast<int>(mChannelTables.size())) {
+      mChannelTables.resize(nmod + 1);
+    }
+    ChannelTable& table = mChannelTables[nmod];
+    table.cosFT0.resize(NChannelsFT0);
+    table.sinFT0.resize(NChannelsFT0);
+    for (int chno = 0; chno < NChannelsFT0; chno++) {
+      table.cosFT0[chno] = TMath::Cos(phiFT0[chno] * nmod);
+      table.sinFT0[chno] = TMath::Sin(phiFT0[chno] * nmod);
+    }
+    table.cosFV0.resize(NChannelsFV0);
+    table.sinFV0.resize(NChannelsFV0);
+    for (int chno = 0; chno < NChannelsFV0; chno++) {
+      table.cosFV0[chno] = TMath::Cos(phiFV0[chno] * nmod);
+      table.sinFV0[chno] = TMath::Sin(phiFV0[chno] * nmod);
+    }
+  }
+}
+
+void EventPlaneHelper::SumQvectors(int det, int chno, float ampl, int nmod, TComplex& Qvec, float& sum) const
+{
+  /* Add the contribution of the provided detector and channel number to the total
+    Q-vector, using the tables filled by SetChannelTables() for this harmonic. */
+  if (nmod < 0 || nmod >= static_cast<int>(mChannelTables.size()) || mChannelTables[nmod].cosFT0.empty()) {
+    printf("No channel table for the harmonic %d. Skip\n", nmod);
+    return;
+  }
+  const ChannelTable& table = mChannelTables[nmod];
+
+  switch (det) {
+    case 0: // FT0.
+      if (chno < 0 || chno >= NChannelsFT0) {
+        printf("Error on FT0 channel number. Skip\n");
+        return;
+      }
+      Qvec += TComplex(ampl * table.cosFT0[chno], ampl * table.sinFT0[chno]);
+      break;
+    case 1: // FV0.
+      if (chno < 0 || chno >= NChannelsFV0) {
+        printf("Error on FV0 channel number. Skip\n");
+        return;
+      }
+      Qvec += TComplex(ampl * table.cosFV0[chno], ampl * table.sinFV0[chno]);
+      break;
+    default:
+      printf("'int det' value does not correspond to any accepted case.\n");
+      return;
+  }
+  sum += ampl;
+}
+
 int EventPlaneHelper::GetCentBin(float cent)
 {
   const float centClasses[] = {0., 5., 10., 20., 30., 40., 50., 60., 80.};
@@ -61,12 +61,19 @@ class EventPlaneHelper
   }
 
   // Methods to calculate the azimuthal angles for each part of FIT, given the channel number.
-  double GetPhiFT0(int chno, o2::ft0::Geometry ft0geom);
+  double GetPhiFT0(int chno, o2::ft0::Geometry& ft0geom);
   double GetPhiFV0(int chno, o2::fv0::Geometry* fv0geom);
 
   // Method to get the Q-vector and sum of amplitudes for any channel in FIT, given
   // the detector and amplitude.
-  void SumQvectors(int det, int chno, float ampl, int nmod, TComplex& Qvec, float& sum, o2::ft0::Geometry ft0geom, o2::fv0::Geometry* fv0geom);
+  void SumQvectors(int det, int chno, float ampl, int nmod, TComplex& Qvec, float& sum, o2::ft0::Geometry& ft0geom, o2::fv0::Geometry* fv0geom);
+
+  // Method to tabulate cos(n*phi) and sin(n*phi) of all the FIT channels for the provided
+  // harmonics, with the current offsets. It must be called again when the offsets change.
+  void SetChannelTables(o2::ft0::Geometry& ft0geom, o2::fv0::Geometry* fv0geom, const std::vector<int>& harmonics);
+
+  // Same as SumQvectors above, using the channel tables instead of the geometry.
+  void SumQvectors(int det, int chno, float ampl, int nmod, TComplex& Qvec, float& sum) const;
 
   // Method to get the bin corresponding to a centrality percentile, according to the
   // centClasses[] array defined in Tasks/qVectorsQA.cxx.
@@ -99,6 +106,21 @@ class EventPlaneHelper
   float GetResolution(const float RefA, const float RefB, int nmode = 2);
 
  private:
+  static constexpr int NChannelsFT0 = 208; // Number of channels in FT0-A and FT0-C.
+  static constexpr int NChannelsFV0 = 48;  // Number of channels in FV0-A.
+
+  // Azimuthal angle of a FT0 channel, the channel centers must be already calculated.
+  double GetPhiFT0Center(int chno, o2::ft0::Geometry& ft0geom);
+
+  // cos(n*phi) and sin(n*phi) of the FIT channels for one harmonic n.
+  struct ChannelTable {
+    std::vector<double> cosFT0;
+    std::vector<double> sinFT0;
+    std::vector<double> cosFV0;
+    std::vector<double> sinFV0;
+  };
+  std::vector<ChannelTable> mChannelTables; //! Channel tables, indexed by harmonic.
+
   double mOffsetFT0AX = 0.;     // X-coordinate of the offset of FT0-A.
   double mOffsetFT0AY = 0.;     // Y-coordinate of the offset of FT0-A.
   double mOffsetFT0CX = 0.;     // X-coordinate of the offset of FT0-C.
@@ -0,0 +1,191 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file GlobalBCIndex.h
+/// \brief Flat sorted index of global BCs with a payload, for exact, closest-BC and window searches
+
+#ifndef COMMON_CORE_GLOBALBCINDEX_H_
+#define COMMON_CORE_GLOBALBCINDEX_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace o2::aod::common
+{
+
+// Replacement for the std::map<globalBC, payload> built in many producers once per
+// time frame (BCs with a given trigger, FIT/ZDC rows per BC, ...).
+// The global BCs and the payloads are kept in two contiguous arrays sorted by global BC,
+// which are filled in one go (tables are usually already sorted in BC) and searched with a
+// branchless binary search. Entries can be disabled individually (e.g. BCs already matched
+// to a collision) without modifying the arrays; searches return disabled entries as well,
+// the caller skips them with isActive() where relevant.
+//
+// Usage:
+//   GlobalBCIndex<int32_t> bcsWithTVX;
+//   for (const auto& bc : bcs) { if (...) bcsWithTVX.add(bc.globalBC(), bc.globalIndex()); }
+//   bcsWithTVX.build();
+//   int entry = bcsWithTVX.findClosest(globalBC);
+template <typename TPayload>
+class GlobalBCIndex
+{
+ public:
+  static constexpr int NotFound = -1;
+
+  void clear()
+  {
+    mGlobalBCs.clear();
+    mPayloads.clear();
+    mActive.clear();
+  }
+
+  void reserve(std::size_t n)
+  {
+    mGlobalBCs.reserve(n);
+    mPayloads.reserve(n);
+  }
+
+  /// Adds an entry, build() has to be called once all entries are added
+  /// If the same global BC is added several times, the last payload is kept, as with std::map::operator[]
+  void add(uint64_t globalBC, TPayload payload)
+  {
+    mGlobalBCs.push_back(globalBC);
+    mPayloads.push_back(std::move(payload));
+  }
+
+  /// Sorts the entries in global BC (only if needed) and removes duplicated global BCs,
+  /// keeping the last added payload
+  void build()
+  {
+    build([](TPayload& kept, TPayload& added) { kept = std::move(added); });
+  }
+
+  /// Same as build(), with the payloads of duplicated global BCs merged in the order
+  /// they were added by merge(TPayload& kept, TPayload& added)
+  template <typename TMerge>
+  void build(TMerge merge)
+  {
+    if (!std::is_sorted(mGlobalBCs.begin(), mGlobalBCs.end())) {
+      std::vector<std::size_t> order(mGlobalBCs.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) { return mGlobalBCs[a] < mGlobalBCs[b]; });
+      std::vector<uint64_t> globalBCs(order.size());
+      std::vector<TPayload> payloads;
+      payloads.reserve(order.size());
+      for (std::size_t i = 0; i < order.size(); i++) {
+        globalBCs[i] = mGlobalBCs[order[i]];
+        payloads.push_back(std::move(mPayloads[order[i]]));
+      }
+      mGlobalBCs.swap(globalBCs);
+      mPayloads.swap(payloads);
+    }
+    std::size_t nUnique = 0;
+    for (std::size_t i = 0; i < mGlobalBCs.size(); i++) {
+      if (nUnique > 0 && mGlobalBCs[nUnique - 1] == mGlobalBCs[i]) {
+        merge(mPayloads[nUnique - 1], mPayloads[i]);
+        continue;
+      }
+      if (nUnique != i) {
+        mGlobalBCs[nUnique] = mGlobalBCs[i];
+        mPayloads[nUnique] = std::move(mPayloads[i]);
+      }
+      nUnique++;
+    }
+    mGlobalBCs.resize(nUnique);
+    mPayloads.resize(nUnique);
+    mActive.assign(nUnique, true);
+  }
+
+  std::size_t size() const { return mGlobalBCs.size(); }
+  bool empty() const { return mGlobalBCs.empty(); }
+
+  uint64_t globalBC(int entry) const { return mGlobalBCs[entry]; }
+  TPayload const& payload(int entry) const { return mPayloads[entry]; }
+  TPayload& payload(int entry) { return mPayloads[entry]; }
+
+  bool isActive(int entry) const { return mActive[entry]; }
+  void deactivate(int entry) { mActive[entry] = false; }
+
+  /// \return first entry with global BC >= globalBC, size() if there is none
+  int lowerBound(uint64_t globalBC) const
+  {
+    std::size_t n = mGlobalBCs.size();
+    if (n == 0) {
+      return 0;
+    }
+    const uint64_t* base = mGlobalBCs.data();
+    while (n > 1) {
+      std::size_t half = n / 2;
+      base = (base[half] < globalBC) ? base + half : base;
+      n -= half;
+    }
+    return static_cast<int>(base - mGlobalBCs.data()) + (*base < globalBC);
+  }
+
+  /// \return first entry with global BC > globalBC, size() if there is none
+  int upperBound(uint64_t globalBC) const
+  {
+    return globalBC == UINT64_MAX ? static_cast<int>(size()) : lowerBound(globalBC + 1);
+  }
+
+  /// \return entries [first, last) with global BC in [minBC, maxBC]
+  std::pair<int, int> window(uint64_t minBC, uint64_t maxBC) const
+  {
+    return {lowerBound(minBC), upperBound(maxBC)};
+  }
+
+  /// \return entry with exactly this global BC, NotFound if there is none
+  int find(uint64_t globalBC) const
+  {
+    int entry = lowerBound(globalBC);
+    return (entry < static_cast<int>(size()) && mGlobalBCs[entry] == globalBC) ? entry : NotFound;
+  }
+
+  /// \return payload of the entry with exactly this global BC, fallback if there is none
+  TPayload findPayload(uint64_t globalBC, TPayload fallback) const
+  {
+    int entry = find(globalBC);
+    return entry != NotFound ? mPayloads[entry] : fallback;
+  }
+
+  /// \return entry with the global BC closest to globalBC, NotFound if the index is empty
+  /// In case of a tie, the later global BC is returned
+  int findClosest(uint64_t globalBC) const
+  {
+    const int n = size();
+    if (n == 0) {
+      return NotFound;
+    }
+    int after = lowerBound(globalBC);
+    if (after == n) {
+      return n - 1;
+    }
+    if (after == 0) {
+      return 0;
+    }
+    uint64_t distAfter = mGlobalBCs[after] - globalBC;
+    uint64_t distBefore = globalBC - mGlobalBCs[after - 1];
+    return distAfter <= distBefore ? after : after - 1;
+  }
+
+ private:
+  std::vector<uint64_t> mGlobalBCs; ///< sorted global BCs
+  std::vector<TPayload> mPayloads;  ///< payloads, same order as mGlobalBCs
+  std::vector<bool> mActive;        ///< bitmap of the entries still to be considered by the caller
+};
+
+} // namespace o2::aod::common
+
+#endif // COMMON_CORE_GLOBALBCINDEX_H_
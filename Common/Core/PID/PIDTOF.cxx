@@ -17,11 +17,115 @@
 ///
 
 #include "PIDTOF.h"
+#include <cmath>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace o2::pid::tof
 {
 
+bool TOFGraphTable::build(const TGraph* graph, int nBins, float tolerance)
+{
+  constexpr int maxBins = 1 << 16;
+  reset();
+  const int nPoints = graph->GetN();
+  if (nPoints < 2 || nBins < 1) {
+    return false;
+  }
+  std::vector<std::pair<double, double>> points(nPoints);
+  for (int i = 0; i < nPoints; ++i) {
+    points[i] = {graph->GetX()[i], graph->GetY()[i]};
+  }
+  std::sort(points.begin(), points.end());
+  const double xMin = points.front().first;
+  const double xMax = points.back().first;
+  if (!(xMax > xMin)) {
+    return false;
+  }
+  const double range = xMax - xMin;
+  mMin = xMin;
+  mMax = xMax;
+  // TGraph::Eval extrapolates linearly from the first and last two points
+  mSlopeLow = (graph->Eval(xMin) - graph->Eval(xMin - range)) / range;
+  mSlopeHigh = (graph->Eval(xMax + range) - graph->Eval(xMax)) / range;
+
+  for (; nBins <= maxBins; nBins *= 2) {
+    mNBins = nBins;
+    mInvWidth = nBins / range;
+    mValues.resize(nBins + 1);
+    for (int i = 0; i <= nBins; ++i) {
+      mValues[i] = graph->Eval(xMin + i * range / nBins);
+    }
+    // Check the table where the interpolation is the least accurate: at the graph points and at the bin centres
+    auto isAccurate = [&](double x) { return std::abs(eval(x) - graph->Eval(x)) <= tolerance; };
+    bool accurate = isAccurate(xMin - 0.5 * range) && isAccurate(xMax + 0.5 * range);
+    for (int i = 0; i < nPoints && accurate; ++i) {
+      accurate = isAccurate(points[i].first);
+    }
+    for (int i = 0; i < nBins && accurate; ++i) {
+      accurate = isAccurate(xMin + (i + 0.5) * range / nBins);
+    }
+    if (accurate) {
+      LOG(info) << "Tabulated graph " << graph->GetName() << " with " << nBins << " bins in [" << xMin << ", " << xMax << "]";
+      return true;
+    }
+  }
+  LOG(warning) << "Could not tabulate graph " << graph->GetName() << " within " << tolerance << " with up to " << maxBins << " bins, using TGraph::Eval";
+  reset();
+  return false;
+}
+
+void TOFFunctionTable::build(const TF2* function, int nBinsX, int nBinsY, float tolerance)
+{
+  reset();
+  if (!function || nBinsX < 1 || nBinsY < 1) {
+    return;
+  }
+  mFunction = function;
+  mMinX = function->GetXmin();
+  mMaxX = function->GetXmax();
+  mMinY = function->GetYmin();
+  mMaxY = function->GetYmax();
+  if (!(mMaxX > mMinX && mMaxY > mMinY)) { // Everything is out of range, the function is always evaluated
+    mMaxX = mMinX;
+    return;
+  }
+  mNBinsX = nBinsX;
+  mNBinsY = nBinsY;
+  const double widthX = (static_cast<double>(mMaxX) - mMinX) / nBinsX;
+  const double widthY = (static_cast<double>(mMaxY) - mMinY) / nBinsY;
+  mInvWidthX = 1. / widthX;
+  mInvWidthY = 1. / widthY;
+  mValues.resize((nBinsX + 1) * (nBinsY + 1));
+  for (int ix = 0; ix <= nBinsX; ++ix) {
+    for (int iy = 0; iy <= nBinsY; ++iy) {
+      mValues[ix * (nBinsY + 1) + iy] = function->Eval(mMinX + ix * widthX, mMinY + iy * widthY);
+    }
+  }
+  // Cells where the interpolation is off (e.g. close to a kink or where the function is steep) fall back to the function.
+  // Each cell is probed on a 3x3 sub-grid, with a safety factor of 2 as the deviation can peak in between the probes
+  constexpr std::array<float, 3> probes{1.f / 6.f, 0.5f, 5.f / 6.f};
+  mExactCells.assign(nBinsX * nBinsY, 0);
+  int nExactCells = 0;
+  for (int ix = 0; ix < nBinsX; ++ix) {
+    for (int iy = 0; iy < nBinsY; ++iy) {
+      bool accurate = true;
+      for (int iProbe = 0; iProbe < 9 && accurate; ++iProbe) {
+        const float fracX = probes[iProbe / 3];
+        const float fracY = probes[iProbe % 3];
+        const float exact = function->Eval(mMinX + (ix + fracX) * widthX, mMinY + (iy + fracY) * widthY);
+        accurate = std::abs(interpolate(ix, iy, fracX, fracY) - exact) <= 0.5f * tolerance;
+      }
+      if (!accurate) {
+        mExactCells[ix * nBinsY + iy] = 1;
+        nExactCells++;
+      }
+    }
+  }
+  LOG(info) << "Tabulated function " << function->GetName() << " with " << nBinsX << "x" << nBinsY << " bins, " << nExactCells << " cells evaluated exactly";
+}
+
 void TOFResoParamsV3::setResolutionParametrizationRun2(std::unordered_map<std::string, float> const& pars)
 {
   std::array<std::string, 13> paramNames{"TrkRes.Pi.P0", "TrkRes.Pi.P1", "TrkRes.Pi.P2", "TrkRes.Pi.P3", "time_resolution",
@@ -34,6 +138,7 @@ void TOFResoParamsV3::setResolutionParametrizationRun2(std::unordered_map<std::s
     }
     mResolution[i] = new TF2(Form("tofResTrack.%s_Run2", particleNames[i]), "-10", 0., 20, -1, 1.); // With negative values the old one is used
   }
+  updateResolutionTables();
   // Print the map
   for (const auto& [key, value] : pars) {
     LOG(info) << "Key: " << key << " Value: " << value;
@@ -55,11 +160,11 @@ void TOFResoParamsV3::setTimeShiftParameters(std::unordered_map<std::string, flo
   if (nPoints <= 0) {
     LOG(fatal) << "TOFResoParamsV3 shift: time must be positive";
   }
-  TGraph graph;
+  TGraph* graph = new TGraph(); // Kept alive, as it is used for the evaluation
   for (int i = 0; i < nPoints; ++i) {
-    graph.AddPoint(pars.at(Form("TimeShift.eta%i", i)), pars.at(Form("TimeShift.cor%i", i)));
+    graph->AddPoint(pars.at(Form("TimeShift.eta%i", i)), pars.at(Form("TimeShift.cor%i", i)));
   }
-  setTimeShiftParameters(&graph, positive);
+  setTimeShiftParameters(graph, positive);
 }
 void TOFResoParamsV3::setTimeShiftParameters(std::string const& filename, std::string const& objname, const bool positive)
 {
@@ -72,6 +177,7 @@ void TOFResoParamsV3::setTimeShiftParameters(std::string const& filename, std::s
     }
     f.Close();
   }
+  updateTimeShiftTable(positive);
   LOG(info) << "Set the Time Shift parameters from file " << filename << " and object " << objname << " for " << (positive ? "positive" : "negative");
 }
 void TOFResoParamsV3::setTimeShiftParameters(TGraph* g, const bool positive)
@@ -85,20 +191,28 @@ void TOFResoParamsV3::setTimeShiftParameters(TGraph* g, const bool positive)
   } else {
     gNegEtaTimeCorr = g;
   }
+  updateTimeShiftTable(positive);
   LOG(info) << "Set the Time Shift parameters from object " << g->GetName() << " " << g->GetTitle() << " for " << (positive ? "positive" : "negative");
 }
-float TOFResoParamsV3::getTimeShift(float eta, int16_t sign) const
+
+void TOFResoParamsV3::updateTimeShiftTable(const bool positive)
 {
-  if (sign > 0) {
-    if (!gPosEtaTimeCorr) {
-      return 0.f;
-    }
-    return gPosEtaTimeCorr->Eval(eta);
+  TOFGraphTable& table = positive ? mPosEtaTimeCorrTable : mNegEtaTimeCorrTable;
+  const TGraph* graph = positive ? gPosEtaTimeCorr : gNegEtaTimeCorr;
+  if (!graph || mTabulationTolerance <= 0.f || !table.build(graph, nTimeShiftTableBins, mTabulationTolerance)) {
+    table.reset();
   }
-  if (!gNegEtaTimeCorr) {
-    return 0.f;
+}
+
+void TOFResoParamsV3::updateResolutionTables()
+{
+  for (int i = 0; i < 9; i++) {
+    if (!mResolution[i] || mTabulationTolerance <= 0.f) {
+      mResolutionTables[i].reset();
+      continue;
+    }
+    mResolutionTables[i].build(mResolution[i], nResolutionTableBinsP, nResolutionTableBinsEta, mTabulationTolerance);
   }
-  return gNegEtaTimeCorr->Eval(eta);
 }
 
 } // namespace o2::pid::tof
@@ -19,6 +19,8 @@
 #ifndef COMMON_CORE_PID_PIDTOF_H_
 #define COMMON_CORE_PID_PIDTOF_H_
 
+#include <algorithm>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -41,7 +43,100 @@ namespace o2::pid::tof
 {
 
 // Utility values
-static constexpr float defaultReturnValue = -999.f; /// Default return value in case TOF measurement is not available
+static constexpr float defaultReturnValue = -999.f;       /// Default return value in case TOF measurement is not available
+static constexpr float defaultTabulationTolerance = 0.5f; /// Suggested max. deviation (ps) of the tabulated response, the tabulation is off unless a tolerance is set
+
+/// \brief Linear interpolation of a TGraph on a uniform grid, to avoid the point search of TGraph::Eval for every track
+class TOFGraphTable
+{
+ public:
+  /// Tabulates the graph over the range of its points, the number of bins is increased until the table agrees with TGraph::Eval within the tolerance
+  /// \param graph Graph to tabulate
+  /// \param nBins Initial number of bins
+  /// \param tolerance Max. absolute deviation from TGraph::Eval, checked at the graph points and at the bin centres
+  /// \return true if the table is usable, otherwise the table is left empty
+  bool build(const TGraph* graph, int nBins, float tolerance);
+  void reset() { mValues.clear(); }
+  bool isValid() const { return !mValues.empty(); }
+
+  float eval(float x) const
+  {
+    if (!(x > mMin)) { // also catches NaN
+      return mValues.front() + (x - mMin) * mSlopeLow;
+    }
+    if (x >= mMax) {
+      return mValues.back() + (x - mMax) * mSlopeHigh;
+    }
+    const float u = (x - mMin) * mInvWidth;
+    const int bin = std::min(static_cast<int>(u), mNBins - 1);
+    const float frac = u - bin;
+    return mValues[bin] + frac * (mValues[bin + 1] - mValues[bin]);
+  }
+
+ private:
+  int mNBins = 0;
+  float mMin = 0.f;
+  float mMax = 0.f;
+  float mInvWidth = 0.f;
+  float mSlopeLow = 0.f;  /// Linear extrapolation below the first point, as in TGraph::Eval
+  float mSlopeHigh = 0.f; /// Linear extrapolation above the last point, as in TGraph::Eval
+  std::vector<float> mValues;
+};
+
+/// \brief Bilinear interpolation of a TF2 on a uniform grid within its range, to avoid evaluating the formula for every track
+/// Cells where the interpolation does not agree with the function within the tolerance, and points out of range, use the function itself.
+/// The agreement is only checked on a sub-grid of each cell, so the tolerance is approximate for functions varying faster than the grid
+class TOFFunctionTable
+{
+ public:
+  /// \param function Function to tabulate, must outlive the table
+  /// \param nBinsX Number of bins along x
+  /// \param nBinsY Number of bins along y
+  /// \param tolerance Max. absolute deviation from the function, checked on a sub-grid of each cell (approximate, see above)
+  void build(const TF2* function, int nBinsX, int nBinsY, float tolerance);
+  void reset()
+  {
+    mFunction = nullptr;
+    mValues.clear();
+    mExactCells.clear();
+  }
+  bool isValid() const { return mFunction != nullptr; }
+
+  float eval(float x, float y) const
+  {
+    if (!(x >= mMinX && x < mMaxX && y >= mMinY && y < mMaxY)) {
+      return mFunction->Eval(x, y);
+    }
+    const float u = (x - mMinX) * mInvWidthX;
+    const float v = (y - mMinY) * mInvWidthY;
+    const int binX = std::min(static_cast<int>(u), mNBinsX - 1);
+    const int binY = std::min(static_cast<int>(v), mNBinsY - 1);
+    if (mExactCells[binX * mNBinsY + binY]) {
+      return mFunction->Eval(x, y);
+    }
+    return interpolate(binX, binY, u - binX, v - binY);
+  }
+
+ private:
+  float interpolate(int binX, int binY, float fracX, float fracY) const
+  {
+    const float* low = &mValues[binX * (mNBinsY + 1) + binY];
+    const float* high = low + (mNBinsY + 1);
+    return (1.f - fracX) * ((1.f - fracY) * low[0] + fracY * low[1]) + fracX * ((1.f - fracY) * high[0] + fracY * high[1]);
+  }
+
+  const TF2* mFunction = nullptr;
+  int mNBinsX = 0;
+  int mNBinsY = 0;
+  float mMinX = 0.f;
+  float mMaxX = 0.f;
+  float mMinY = 0.f;
+  float mMaxY = 0.f;
+  float mInvWidthX = 0.f;
+  float mInvWidthY = 0.f;
+  std::vector<float> mValues;       /// Function values at the grid nodes, x-major
+  std::vector<uint8_t> mExactCells; /// Cells where the function is evaluated directly
+};
 
 /// \brief Next implementation class to store TOF response parameters for exp. times
 class TOFResoParamsV2 : public o2::tof::Parameters<13>
@@ -99,9 +194,9 @@ class TOFResoParamsV2 : public o2::tof::Parameters<13>
       // LOG(info) << "TOFResoParamsV2 shift: no correction mEtaN is " << mEtaN;
       return 0.f;
     }
-    const int& etaIndex = (eta <= mEtaStart) ? 0 : (eta >= mEtaStop ? (mEtaN - 1) : (eta - mEtaStart) * mInvEtaWidth);
+    const int etaIndex = (eta <= mEtaStart) ? 0 : (eta >= mEtaStop ? (mEtaN - 1) : std::min(static_cast<int>((eta - mEtaStart) * mInvEtaWidth), mEtaN - 1));
     // LOG(info) << "TOFResoParamsV2 shift: correction for eta " << eta << " is for index " << etaIndex << " = " << shift;
-    return mContent.at(etaIndex);
+    return mContent[etaIndex];
   }
   // To remove
   float getShift(float eta) const
@@ -137,6 +232,7 @@ class TOFResoParamsV2 : public o2::tof::Parameters<13>
       }
       f.Close();
     }
+    updateTimeShiftTable(positive);
     LOG(info) << "Set the Time Shift parameters from file " << filename << " and object " << objname << " for " << (positive ? "positive" : "negative") << " example of shift at eta 0: " << getTimeShift(0, positive);
   }
   void setTimeShiftParameters(TGraph* g, bool positive)
@@ -146,23 +242,42 @@ class TOFResoParamsV2 : public o2::tof::Parameters<13>
     } else {
       gNegEtaTimeCorr = g;
     }
+    updateTimeShiftTable(positive);
     LOG(info) << "Set the Time Shift parameters from object " << g->GetName() << " " << g->GetTitle() << " for " << (positive ? "positive" : "negative");
   }
   float getTimeShift(float eta, int16_t sign) const
   {
     if (sign > 0) {
+      if (mPosEtaTimeCorrTable.isValid()) {
+        return mPosEtaTimeCorrTable.eval(eta);
+      }
       if (!gPosEtaTimeCorr) {
         return 0.f;
       }
       return gPosEtaTimeCorr->Eval(eta);
     }
+    if (mNegEtaTimeCorrTable.isValid()) {
+      return mNegEtaTimeCorrTable.eval(eta);
+    }
     if (!gNegEtaTimeCorr) {
       return 0.f;
     }
     return gNegEtaTimeCorr->Eval(eta);
   }
 
+  /// Sets the max. deviation (ps) of the tabulated time shift from the TGraph evaluation, 0 (default) disables the tables. Applies to the graphs set afterwards
+  void setTabulationTolerance(float tolerance) { mTabulationTolerance = tolerance; }
+
  private:
+  void updateTimeShiftTable(bool positive)
+  {
+    TOFGraphTable& table = positive ? mPosEtaTimeCorrTable : mNegEtaTimeCorrTable;
+    const TGraph* graph = positive ? gPosEtaTimeCorr : gNegEtaTimeCorr;
+    if (!graph || mTabulationTolerance <= 0.f || !table.build(graph, nTimeShiftTableBins, mTabulationTolerance)) {
+      table.reset();
+    }
+  }
+
   // Charge calibration
   int mEtaN = 0; // Number of eta bins, 0 means no correction
   float mEtaStart = 0.f;
@@ -173,6 +288,12 @@ class TOFResoParamsV2 : public o2::tof::Parameters<13>
   // Time shift for post calibration
   TGraph* gPosEtaTimeCorr = nullptr; /// Time shift correction for positive tracks
   TGraph* gNegEtaTimeCorr = nullptr; /// Time shift correction for negative tracks
+
+  // Tabulated response
+  static constexpr int nTimeShiftTableBins = 1000;
+  float mTabulationTolerance = 0.f; /// Tabulation disabled by default, see setTabulationTolerance
+  TOFGraphTable mPosEtaTimeCorrTable; /// Tabulated time shift for positive tracks
+  TOFGraphTable mNegEtaTimeCorrTable; /// Tabulated time shift for negative tracks
 };
 
 /// \brief Next implementation class to store TOF response parameters for exp. times
@@ -219,9 +340,9 @@ class TOFResoParamsV3 : public o2::tof::Parameters<13>
       // LOG(info) << "TOFResoParamsV3 shift: no correction mEtaN is " << mEtaN;
       return 0.f;
     }
-    const int& etaIndex = (eta <= mEtaStart) ? 0 : (eta >= mEtaStop ? (mEtaN - 1) : (eta - mEtaStart) * mInvEtaWidth);
+    const int etaIndex = (eta <= mEtaStart) ? 0 : (eta >= mEtaStop ? (mEtaN - 1) : std::min(static_cast<int>((eta - mEtaStart) * mInvEtaWidth), mEtaN - 1));
     // LOG(info) << "TOFResoParamsV3 shift: correction for eta " << eta << " is for index " << etaIndex << " = " << shift;
-    return mContent.at(etaIndex);
+    return mContent[etaIndex];
   }
 
   void printMomentumChargeShiftParameters() const
@@ -240,7 +361,17 @@ class TOFResoParamsV3 : public o2::tof::Parameters<13>
   void setTimeShiftParameters(std::unordered_map<std::string, float> const& pars, const bool positive);
   void setTimeShiftParameters(std::string const& filename, std::string const& objname, const bool positive);
   void setTimeShiftParameters(TGraph* g, const bool positive);
-  float getTimeShift(float eta, int16_t sign) const;
+  float getTimeShift(float eta, int16_t sign) const
+  {
+    if (sign > 0) {
+      return mPosEtaTimeCorrTable.isValid() ? mPosEtaTimeCorrTable.eval(eta) : (gPosEtaTimeCorr ? gPosEtaTimeCorr->Eval(eta) : 0.f);
+    }
+    return mNegEtaTimeCorrTable.isValid() ? mNegEtaTimeCorrTable.eval(eta) : (gNegEtaTimeCorr ? gNegEtaTimeCorr->Eval(eta) : 0.f);
+  }
+
+  /// Sets the max. deviation (ps) of the tabulated time shift and resolution from the exact evaluation, 0 (default) disables the tables.
+  /// The time shift tables respect it exactly, the resolution tables approximately. Applies to the parametrizations set afterwards
+  void setTabulationTolerance(float tolerance) { mTabulationTolerance = tolerance; }
 
   void printTimeShiftParameters() const
   {
@@ -282,6 +413,7 @@ class TOFResoParamsV3 : public o2::tof::Parameters<13>
       }
       LOG(info) << "Resolution function for " << particleNames[i] << " is " << mResolution[i]->GetName() << " with formula " << mResolution[i]->GetFormula()->GetExpFormula();
     }
+    updateResolutionTables();
   }
 
   void setResolutionParametrizationRun2(std::unordered_map<std::string, float> const& pars);
@@ -289,6 +421,9 @@ class TOFResoParamsV3 : public o2::tof::Parameters<13>
   template <o2::track::PID::ID pid>
   float getResolution(const float p, const float eta) const
   {
+    if (mResolutionTables[pid].isValid()) {
+      return mResolutionTables[pid].eval(p, eta);
+    }
     return mResolution[pid]->Eval(p, eta);
   }
 
@@ -333,6 +468,17 @@ class TOFResoParamsV3 : public o2::tof::Parameters<13>
   // Time shift for post calibration
   TGraph* gPosEtaTimeCorr = nullptr; /// Time shift correction for positive tracks
   TGraph* gNegEtaTimeCorr = nullptr; /// Time shift correction for negative tracks
+
+  // Tabulated response, built when the parametrization is set
+  void updateTimeShiftTable(const bool positive);
+  void updateResolutionTables();
+  static constexpr int nTimeShiftTableBins = 1000;
+  static constexpr int nResolutionTableBinsP = 2000;
+  static constexpr int nResolutionTableBinsEta = 20;
+  float mTabulationTolerance = 0.f; /// Tabulation disabled by default, see setTabulationTolerance
+  TOFGraphTable mPosEtaTimeCorrTable;                /// Tabulated time shift for positive tracks
+  TOFGraphTable mNegEtaTimeCorrTable;                /// Tabulated time shift for negative tracks
+  std::array<TOFFunctionTable, 9> mResolutionTables; /// Tabulated resolution parametrizations
 };
 
 /// \brief Class to handle the the TOF detector response for the TOF beta measurement
@@ -79,6 +79,7 @@ struct TOFCalibConfig {
     mEnableTimeDependentResponse = opt.cfgEnableTimeDependentResponse.value;
     mCollisionSystem = opt.cfgCollisionSystem.value;
     mAutoSetProcessFunctions = opt.cfgAutoSetProcessFunctions.value;
+    mTabulationTolerance = opt.cfgTabulationTolerance.value;
   }
 
   template <typename VType>
@@ -107,6 +108,7 @@ struct TOFCalibConfig {
     getCfg(initContext, "enableTimeDependentResponse", mEnableTimeDependentResponse, task);
     getCfg(initContext, "collisionSystem", mCollisionSystem, task);
     getCfg(initContext, "autoSetProcessFunctions", mAutoSetProcessFunctions, task);
+    getCfg(initContext, "tabulationTolerance", mTabulationTolerance, task);
   }
   // @brief Set up the configuration from the calibration object from the init function of the task
   template <typename CCDBObject>
@@ -114,6 +116,7 @@ struct TOFCalibConfig {
                  CCDBObject ccdb)
   {
     mInitMode = 1;
+    mRespParamsV3.setTabulationTolerance(mTabulationTolerance); // Before any parametrization is set, as it is tabulated when set
     // First we set the CCDB manager
     ccdb->setURL(mUrl);
     ccdb->setTimestamp(mTimestamp);
@@ -341,6 +344,7 @@ struct TOFCalibConfig {
   bool mEnableTimeDependentResponse;
   int mCollisionSystem;
   bool mAutoSetProcessFunctions;
+  float mTabulationTolerance;
 };
 
 // Part 1 TOF signal definition
@@ -384,6 +388,7 @@ struct tofSignal {
     Configurable<bool> cfgEnableTimeDependentResponse{"enableTimeDependentResponse", false, "Flag to use the collision timestamp to fetch the PID Response"};
     Configurable<int> cfgCollisionSystem{"collisionSystem", -1, "Collision system: -1 (autoset), 0 (pp), 1 (PbPb), 2 (XeXe), 3 (pPb)"};
     Configurable<bool> cfgAutoSetProcessFunctions{"autoSetProcessFunctions", true, "Flag to autodetect the process functions to use"};
+    Configurable<float> cfgTabulationTolerance{"tabulationTolerance", 0.f, "Max. deviation (ps) of the tabulated time shift and resolution from their exact evaluation (approximate for the resolution), suggested value 0.5 (o2::pid::tof::defaultTabulationTolerance). 0 (default) disables the tabulation"};
   } cfg; // Configurables (only defined here and inherited from other tasks)
 
   TOFCalibConfig mTOFCalibConfig; // TOF Calib configuration
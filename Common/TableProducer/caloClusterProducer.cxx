@@ -15,7 +15,6 @@
 /// \author Dmitri Peresunko <Dmitri.Peresunko@cern.ch>
 
 #include <algorithm>
-#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -27,6 +26,7 @@
 #include "Common/DataModel/TrackSelectionTables.h"
 #include "Common/DataModel/CaloClusters.h"
 #include "Common/Core/trackUtilities.h"
+#include "Common/Core/GlobalBCIndex.h"
 #include "ReconstructionDataFormats/TrackParametrization.h"
 #include "DetectorsBase/Propagator.h"
 
@@ -132,28 +132,28 @@ struct CaloClusterProducer {
     } else {
       return;
     }
-    std::map<int64_t, int> bcMap;
+    o2::aod::common::GlobalBCIndex<int> bcMap;
+    bcMap.reserve(bcs.size());
     int bcId = 0;
     for (const auto& bc : bcs) {
-      bcMap[bc.globalBC()] = bcId;
+      bcMap.add(bc.globalBC(), bcId);
       bcId++;
     }
+    bcMap.build();
 
     // If several collisions appear in BC, choose one with largers number of contributors
-    std::map<int64_t, int> colMap;
+    o2::aod::common::GlobalBCIndex<int> colMap;
+    colMap.reserve(colls.size());
     int colId = 0;
     for (const auto& cl : colls) {
-      auto colbc = colMap.find(cl.bc_as<aod::BCsWithTimestamps>().globalBC());
-      if (colbc == colMap.end()) { // single collision per BC
-        colMap[cl.bc_as<aod::BCsWithTimestamps>().globalBC()] = colId;
-      } else { // not unique collision per BC
-        auto coll2 = colls.begin() + colbc->second;
-        if (cl.numContrib() > coll2.numContrib()) {
-          colMap[cl.bc_as<aod::BCsWithTimestamps>().globalBC()] = colId;
-        }
-      }
+      colMap.add(cl.bc_as<aod::BCsWithTimestamps>().globalBC(), colId);
       colId++;
     }
+    colMap.build([&colls](int& keptColId, int& addedColId) {
+      if ((colls.begin() + addedColId).numContrib() > (colls.begin() + keptColId).numContrib()) {
+        keptColId = addedColId;
+      }
+    });
 
     // Fill list of cells and cell TrigRecs per TF as an input for clusterizer
     // clusterize
@@ -273,12 +273,12 @@ struct CaloClusterProducer {
       // Extract primary vertex
       TVector3 vtx = {0., 0., 0.}; // default, if not collision will be found
       int colId = -1;
-      auto coliter = colMap.find(cluTR.getBCData().toLong());
-      if (coliter != colMap.end()) { // get vertex from collision
+      int colEntry = colMap.find(cluTR.getBCData().toLong());
+      if (colEntry != colMap.NotFound) { // get vertex from collision
         // find collision corresponding to current BC
-        auto clvtx = colls.begin() + coliter->second;
+        auto clvtx = colls.begin() + colMap.payload(colEntry);
         vtx.SetXYZ(clvtx.posX(), clvtx.posY(), clvtx.posZ());
-        colId = coliter->second;
+        colId = colMap.payload(colEntry);
       }
 
       bool cpvExist = false;
@@ -384,7 +384,7 @@ struct CaloClusterProducer {
         if (colId == -1) {
           // Ambiguos Collision assignment
           cluambcursor(
-            bcMap[cluTR.getBCData().toLong()],
+            bcMap.findPayload(cluTR.getBCData().toLong(), 0),
             mom.X(), mom.Y(), mom.Z(), e,
             mod, clu.getMultiplicity(), posX, posZ,
             globaPos.X(), globaPos.Y(), globaPos.Z(),
@@ -426,28 +426,28 @@ struct CaloClusterProducer {
     } else {
       return;
     }
-    std::map<int64_t, int> bcMap;
+    o2::aod::common::GlobalBCIndex<int> bcMap;
+    bcMap.reserve(bcs.size());
     int bcId = 0;
     for (auto const& bc : bcs) {
-      bcMap[bc.globalBC()] = bcId;
+      bcMap.add(bc.globalBC(), bcId);
       bcId++;
     }
+    bcMap.build();
 
     // If several collisions appear in BC, choose one with largers number of contributors
-    std::map<int64_t, int> colMap;
+    o2::aod::common::GlobalBCIndex<int> colMap;
+    colMap.reserve(colls.size());
     int colId = 0;
     for (auto const& cl : colls) {
-      auto colbc = colMap.find(cl.bc_as<aod::BCsWithTimestamps>().globalBC());
-      if (colbc == colMap.end()) { // single collision per BC
-        colMap[cl.bc_as<aod::BCsWithTimestamps>().globalBC()] = colId;
-      } else { // not unique collision per BC
-        auto coll2 = colls.begin() + colbc->second;
-        if (cl.numContrib() > coll2.numContrib()) {
-          colMap[cl.bc_as<aod::BCsWithTimestamps>().globalBC()] = colId;
-        }
-      }
+      colMap.add(cl.bc_as<aod::BCsWithTimestamps>().globalBC(), colId);
       colId++;
     }
+    colMap.build([&colls](int& keptColId, int& addedColId) {
+      if ((colls.begin() + addedColId).numContrib() > (colls.begin() + keptColId).numContrib()) {
+        keptColId = addedColId;
+      }
+    });
 
     // Fill list of cells and cell TrigRecs per TF as an input for clusterizer
     // clusterize
@@ -589,12 +589,12 @@ struct CaloClusterProducer {
       // Extract primary vertex
       TVector3 vtx = {0., 0., 0.}; // default, if not collision will be found
       int colId = -1;
-      auto coliter = colMap.find(cluTR.getBCData().toLong());
-      if (coliter != colMap.end()) { // get vertex from collision
+      int colEntry = colMap.find(cluTR.getBCData().toLong());
+      if (colEntry != colMap.NotFound) { // get vertex from collision
         // find collision corresponding to current BC
-        auto clvtx = colls.begin() + coliter->second;
+        auto clvtx = colls.begin() + colMap.payload(colEntry);
         vtx.SetXYZ(clvtx.posX(), clvtx.posY(), clvtx.posZ());
-        colId = coliter->second;
+        colId = colMap.payload(colEntry);
       }
 
       bool cpvExist = false;
@@ -708,7 +708,7 @@ struct CaloClusterProducer {
         if (colId == -1) {
           // Ambiguos Collision assignment
           cluambcursor(
-            bcMap[cluTR.getBCData().toLong()],
+            bcMap.findPayload(cluTR.getBCData().toLong(), 0),
             mom.X(), mom.Y(), mom.Z(), e,
             mod, clu.getMultiplicity(), posX, posZ,
             globaPos.X(), globaPos.Y(), globaPos.Z(),
@@ -769,28 +769,28 @@ struct CaloClusterProducer {
       o2::base::Propagator::initFieldFromGRP(grpo);
     }
 
-    std::map<int64_t, int> bcMap;
+    o2::aod::common::GlobalBCIndex<int> bcMap;
+    bcMap.reserve(bcs.size());
     int bcId = 0;
     for (const auto& bc : bcs) {
-      bcMap[bc.globalBC()] = bcId;
+      bcMap.add(bc.globalBC(), bcId);
       bcId++;
     }
+    bcMap.build();
 
     // If several collisions appear in BC, choose one with largers number of contributors
-    std::map<int64_t, int> colMap;
+    o2::aod::common::GlobalBCIndex<int> colMap;
+    colMap.reserve(colls.size());
     int colId = 0;
     for (const auto& cl : colls) {
-      auto colbc = colMap.find(cl.bc_as<aod::BCsWithTimestamps>().globalBC());
-      if (colbc == colMap.end()) { // single collision per BC
-        colMap[cl.bc_as<aod::BCsWithTimestamps>().globalBC()] = colId;
-      } else { // not unique collision per BC
-        auto coll2 = colls.begin() + colbc->second;
-        if (cl.numContrib() > coll2.numContrib()) {
-          colMap[cl.bc_as<aod::BCsWithTimestamps>().globalBC()] = colId;
-        }
-      }
+      colMap.add(cl.bc_as<aod::BCsWithTimestamps>().globalBC(), colId);
       colId++;
     }
+    colMap.build([&colls](int& keptColId, int& addedColId) {
+      if ((colls.begin() + addedColId).numContrib() > (colls.begin() + keptColId).numContrib()) {
+        keptColId = addedColId;
+      }
+    });
     // Fill list of cells and cell TrigRecs per TF as an input for clusterizer
     // clusterize
     // Fill output table
@@ -983,12 +983,12 @@ struct CaloClusterProducer {
       // Extract primary vertex
       TVector3 vtx = {0., 0., 0.}; // default, if not collision will be found
       int colId = -1;
-      auto coliter = colMap.find(cluTR.getBCData().toLong());
-      if (coliter != colMap.end()) { // get vertex from collision
+      int colEntry = colMap.find(cluTR.getBCData().toLong());
+      if (colEntry != colMap.NotFound) { // get vertex from collision
         // find collision corresponding to current BC
-        auto clvtx = colls.begin() + coliter->second;
+        auto clvtx = colls.begin() + colMap.payload(colEntry);
         vtx.SetXYZ(clvtx.posX(), clvtx.posY(), clvtx.posZ());
-        colId = coliter->second;
+        colId = colMap.payload(colEntry);
       }
 
       bool cpvExist = false;
@@ -1122,7 +1122,7 @@ struct CaloClusterProducer {
         if (colId == -1) {
           // Ambiguos Collision assignment
           cluambcursor(
-            bcMap[cluTR.getBCData().toLong()],
+            bcMap.findPayload(cluTR.getBCData().toLong(), 0),
             mom.X(), mom.Y(), mom.Z(), e,
             mod, clu.getMultiplicity(), posX, posZ,
             globaPos.X(), globaPos.Y(), globaPos.Z(),
@@ -1178,28 +1178,28 @@ struct CaloClusterProducer {
       o2::base::Propagator::initFieldFromGRP(grpo);
     }
 
-    std::map<int64_t, int> bcMap;
+    o2::aod::common::GlobalBCIndex<int> bcMap;
+    bcMap.reserve(bcs.size());
     int bcId = 0;
     for (const auto& bc : bcs) {
-      bcMap[bc.globalBC()] = bcId;
+      bcMap.add(bc.globalBC(), bcId);
       bcId++;
     }
+    bcMap.build();
 
     // If several collisions appear in BC, choose one with largers number of contributors
-    std::map<int64_t, int> colMap;
+    o2::aod::common::GlobalBCIndex<int> colMap;
+    colMap.reserve(colls.size());
     int colId = 0;
     for (const auto& cl : colls) {
-      auto colbc = colMap.find(cl.bc_as<aod::BCsWithTimestamps>().globalBC());
-      if (colbc == colMap.end()) { // single collision per BC
-        colMap[cl.bc_as<aod::BCsWithTimestamps>().globalBC()] = colId;
-      } else { // not unique collision per BC
-        auto coll2 = colls.begin() + colbc->second;
-        if (cl.numContrib() > coll2.numContrib()) {
-          colMap[cl.bc_as<aod::BCsWithTimestamps>().globalBC()] = colId;
-        }
-      }
+      colMap.add(cl.bc_as<aod::BCsWithTimestamps>().globalBC(), colId);
       colId++;
     }
+    colMap.build([&colls](int& keptColId, int& addedColId) {
+      if ((colls.begin() + addedColId).numContrib() > (colls.begin() + keptColId).numContrib()) {
+        keptColId = addedColId;
+      }
+    });
     // Fill list of cells and cell TrigRecs per TF as an input for clusterizer
     // clusterize
     // Fill output table
@@ -1414,12 +1414,12 @@ struct CaloClusterProducer {
       // Extract primary vertex
       TVector3 vtx = {0., 0., 0.}; // default, if not collision will be found
       int colId = -1;
-      auto coliter = colMap.find(cluTR.getBCData().toLong());
-      if (coliter != colMap.end()) { // get vertex from collision
+      int colEntry = colMap.find(cluTR.getBCData().toLong());
+      if (colEntry != colMap.NotFound) { // get vertex from collision
         // find collision corresponding to current BC
-        auto clvtx = colls.begin() + coliter->second;
+        auto clvtx = colls.begin() + colMap.payload(colEntry);
         vtx.SetXYZ(clvtx.posX(), clvtx.posY(), clvtx.posZ());
-        colId = coliter->second;
+        colId = colMap.payload(colEntry);
       }
 
       bool cpvExist = false;
@@ -1558,7 +1558,7 @@ struct CaloClusterProducer {
         if (colId == -1) {
           // Ambiguos Collision assignment
           cluambcursor(
-            bcMap[cluTR.getBCData().toLong()],
+            bcMap.findPayload(cluTR.getBCData().toLong(), 0),
             mom.X(), mom.Y(), mom.Z(), e,
             mod, clu.getMultiplicity(), posX, posZ,
             globaPos.X(), globaPos.Y(), globaPos.Z(),
@@ -14,6 +14,7 @@
 ///
 /// \author Evgeny Kryshen <evgeny.kryshen@cern.ch> and Igor Altsybeev <Igor.Altsybeev@cern.ch>
 
+#include <chrono>
 #include <vector>
 #include <map>
 #include <string>
@@ -25,6 +26,7 @@
 #include "Common/DataModel/EventSelection.h"
 #include "Common/CCDB/EventSelectionParams.h"
 #include "Common/CCDB/TriggerAliases.h"
+#include "Common/CCDB/ccdbSnapshot.h"
 #include "CCDB/BasicCCDBManager.h"
 #include "CommonConstants/LHCConstants.h"
 #include "Framework/HistogramRegistry.h"
@@ -33,6 +35,7 @@
 #include "DataFormatsParameters/GRPECSObject.h"
 #include "ITSMFTBase/DPLAlpideParam.h"
 #include "MetadataHelper.h"
+#include "Common/Core/GlobalBCIndex.h"
 #include "DataFormatsParameters/AggregatedRunInfo.h"
 #include "DataFormatsITSMFT/NoiseMap.h" // missing include in TimeDeadMap.h
 #include "DataFormatsITSMFT/TimeDeadMap.h"
@@ -46,6 +49,27 @@ using namespace o2::aod::evsel;
 
 MetadataHelper metadataInfo; // Metadata helper
 
+// points the CCDB manager to the view of the run in the local snapshot, if one is used (see Common/CCDB/ccdbSnapshot.h)
+void setCcdbSnapshotRun(std::string const& snapshotDir, int run)
+{
+  if (snapshotDir.empty()) {
+    return;
+  }
+  auto url = o2::common::ccdb::CCDBSnapshot::getRunUrl(snapshotDir, run);
+  if (url.empty()) {
+    LOGP(fatal, "Run {} is not in the CCDB snapshot {}", run, snapshotDir);
+  }
+  o2::ccdb::BasicCCDBManager::instance().setURL(url);
+}
+
+// reports the time spent in the CCDB access at the first data frame of a run
+void fillFirstCollisionLatency(HistogramRegistry& histos, int run, std::chrono::steady_clock::time_point start, bool fromSnapshot)
+{
+  double latency = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  histos.get<TH1>(HIST("hFirstCollisionLatency"))->Fill(Form("%d", run), latency);
+  LOGP(info, "CCDB access at the first data frame of run {}: {:.1f} ms ({})", run, latency, fromSnapshot ? "snapshot" : "server");
+}
+
 using BCsWithRun2InfosTimestampsAndMatches = soa::Join<aod::BCs, aod::Run2BCInfos, aod::Timestamps, aod::Run2MatchedToBCSparse>;
 using BCsWithRun3Matchings = soa::Join<aod::BCs, aod::Timestamps, aod::Run3MatchedToBCSparse>;
 using BCsWithBcSelsRun2 = soa::Join<aod::BCs, aod::Timestamps, aod::BcSels, aod::Run2BCInfos, aod::Run2MatchedToBCSparse>;
@@ -66,6 +90,7 @@ struct BcSelectionTask {
   Configurable<int> confTimeFrameEndBorderMargin{"TimeFrameEndBorderMargin", -1, "Number of bcs to cut at the end of the Time Frame. Take from CCDB if -1"};       // o2-linter: disable=name/configurable (temporary fix)
   Configurable<bool> confCheckRunDurationLimits{"checkRunDurationLimits", false, "Check if the BCs are within the run duration limits"};                           // o2-linter: disable=name/configurable (temporary fix)
   Configurable<std::vector<int>> maxInactiveChipsPerLayer{"maxInactiveChipsPerLayer", {8, 8, 8, 111, 111, 195, 195}, "Maximum allowed number of inactive ITS chips per layer"};
+  Configurable<std::string> confCcdbSnapshotDir{"ccdbSnapshotDir", "", "Local CCDB snapshot made with o2-analysis-ccdb-snapshot, read instead of the server in Run 3 (empty: use the server)"}; // o2-linter: disable=name/configurable (temporary fix)
 
   int lastRun = -1;
   int64_t lastTF = -1;
@@ -123,6 +148,7 @@ struct BcSelectionTask {
     histos.add("hLumiTCEafterBCcuts", ";;Luminosity, 1/#mub", kTH1D, {{1, 0., 1.}});
     histos.add("hLumiZEMafterBCcuts", ";;Luminosity, 1/#mub", kTH1D, {{1, 0., 1.}});
     histos.add("hLumiZNCafterBCcuts", ";;Luminosity, 1/#mub", kTH1D, {{1, 0., 1.}});
+    histos.add("hFirstCollisionLatency", "latency of the CCDB access at the first data frame of each run;run;time (ms)", kTH1D, {{1, 0., 1.}});
   }
 
   void processRun2(
@@ -266,6 +292,8 @@ struct BcSelectionTask {
 
     if (run != lastRun) {
       lastRun = run;
+      auto start = std::chrono::steady_clock::now();
+      setCcdbSnapshotRun(confCcdbSnapshotDir, run);
       auto runInfo = o2::parameters::AggregatedRunInfo::buildAggregatedRunInfo(o2::ccdb::BasicCCDBManager::instance(), run);
       // first bc of the first orbit
       bcSOR = runInfo.orbitSOR * nBCsPerOrbit;
@@ -327,13 +355,16 @@ struct BcSelectionTask {
         mapRCT = new std::map<uint64_t, uint32_t>;
         mapRCT->insert(std::pair<uint64_t, uint32_t>(sorTimestamp, 0));
       }
+      fillFirstCollisionLatency(histos, run, start, !confCcdbSnapshotDir.value.empty());
     }
 
     // map from GlobalBC to BcId needed to find triggerBc
-    std::map<uint64_t, int32_t> mapGlobalBCtoBcId;
+    o2::aod::common::GlobalBCIndex<int32_t> mapGlobalBCtoBcId;
+    mapGlobalBCtoBcId.reserve(bcs.size());
     for (const auto& bc : bcs) {
-      mapGlobalBCtoBcId[bc.globalBC()] = bc.globalIndex();
+      mapGlobalBCtoBcId.add(bc.globalBC(), bc.globalIndex());
     }
+    mapGlobalBCtoBcId.build();
 
     int triggerBcShift = confTriggerBcShift;
     if (confTriggerBcShift == 999) {
@@ -357,7 +388,7 @@ struct BcSelectionTask {
 
       uint32_t alias{0};
       // workaround for pp2022 (trigger info is shifted by -294 bcs)
-      int32_t triggerBcId = mapGlobalBCtoBcId[bc.globalBC() + triggerBcShift];
+      int32_t triggerBcId = mapGlobalBCtoBcId.findPayload(bc.globalBC() + triggerBcShift, 0);
       if (triggerBcId && aliases) {
         auto triggerBc = bcs.iteratorAt(triggerBcId);
         uint64_t triggerMask = triggerBc.triggerMask();
@@ -558,6 +589,7 @@ struct EventSelectionTask {
   Configurable<float> confFT0CamplCutVetoOnCollInROF{"FT0CamplPerCollCutVetoOnCollInROF", 5000, "Max allowed FT0C amplitude for each nearby collision inside this ITS ROF"};         // o2-linter: disable=name/configurable (temporary fix)
   Configurable<float> confEpsilonVzDiffVetoInROF{"EpsilonVzDiffVetoInROF", 0.3, "Minumum distance to nearby collisions along z inside this ITS ROF, cm"};                            // o2-linter: disable=name/configurable (temporary fix)
   Configurable<bool> confUseWeightsForOccupancyVariable{"UseWeightsForOccupancyEstimator", 1, "Use or not the delta-time weights for the occupancy estimator"};                      // o2-linter: disable=name/configurable (temporary fix)
+  Configurable<std::string> confCcdbSnapshotDir{"ccdbSnapshotDir", "", "Local CCDB snapshot made with o2-analysis-ccdb-snapshot, read instead of the server in Run 3 (empty: use the server)"}; // o2-linter: disable=name/configurable (temporary fix)
 
   Partition<FullTracks> tracklets = (aod::track::trackType == static_cast<uint8_t>(o2::aod::track::TrackTypeEnum::Run2Tracklet));
 
@@ -575,19 +607,11 @@ struct EventSelectionTask {
   int rofOffset = -1;     // ITS ROF offset, in bc
   int rofLength = -1;     // ITS ROF length, in bc
 
-  int32_t findClosest(int64_t globalBC, std::map<int64_t, int32_t>& bcs)
-  {
-    auto it = bcs.lower_bound(globalBC);
-    int64_t bc1 = it->first;
-    int32_t index1 = it->second;
-    if (it != bcs.begin())
-      --it;
-    int64_t bc2 = it->first;
-    int32_t index2 = it->second;
-    int64_t dbc1 = std::abs(bc1 - globalBC);
-    int64_t dbc2 = std::abs(bc2 - globalBC);
-    return (dbc1 <= dbc2) ? index1 : index2;
-  }
+  // TVX-fired bcs: bc index and FT0 vertex z
+  struct bcWithTVX {
+    int32_t bcId = -1;
+    float vtxZ = 0;
+  };
 
   // helper function to find median time in the vector of TOF or TRD-track times
   float getMedian(std::vector<float> v)
@@ -598,7 +622,8 @@ struct EventSelectionTask {
   }
 
   // helper function to find closest TVX signal in time and in zVtx
-  int64_t findBestGlobalBC(int64_t meanBC, int64_t sigmaBC, int32_t nContrib, float zVtxCol, std::map<int64_t, float>& mapGlobalBcVtxZ)
+  // bcs already matched to a collision are disabled in the index and skipped
+  int64_t findBestGlobalBC(int64_t meanBC, int64_t sigmaBC, int32_t nContrib, float zVtxCol, const o2::aod::common::GlobalBCIndex<bcWithTVX>& mapGlobalBcWithTVX)
   {
     // protection against
     if (sigmaBC < 1)
@@ -611,16 +636,19 @@ struct EventSelectionTask {
     float zVtxSigma = 2.7 * std::pow(nContrib, -0.466) + 0.024;
     zVtxSigma += 1.0; // additional uncertainty due to imperfectections of FT0 time calibration
 
-    auto itMin = mapGlobalBcVtxZ.lower_bound(minBC);
-    auto itMax = mapGlobalBcVtxZ.upper_bound(maxBC);
+    auto [entryMin, entryMax] = mapGlobalBcWithTVX.window(std::max<int64_t>(minBC, 0), std::max<int64_t>(maxBC, 0));
 
     float bestChi2 = 1e+10;
     int64_t bestGlobalBC = 0;
-    for (std::map<int64_t, float>::iterator it = itMin; it != itMax; ++it) {
-      float chi2 = std::pow((it->second - zVtxCol) / zVtxSigma, 2) + std::pow(static_cast<float>(it->first - meanBC) / sigmaBC, 2.);
+    for (int entry = entryMin; entry < entryMax; ++entry) {
+      if (!mapGlobalBcWithTVX.isActive(entry)) {
+        continue;
+      }
+      int64_t globalBC = mapGlobalBcWithTVX.globalBC(entry);
+      float chi2 = std::pow((mapGlobalBcWithTVX.payload(entry).vtxZ - zVtxCol) / zVtxSigma, 2) + std::pow(static_cast<float>(globalBC - meanBC) / sigmaBC, 2.);
       if (chi2 < bestChi2) {
         bestChi2 = chi2;
-        bestGlobalBC = it->first;
+        bestGlobalBC = globalBC;
       }
     }
 
@@ -655,6 +683,7 @@ struct EventSelectionTask {
     histos.add("hColCounterAll", "", kTH1D, {{1, 0., 1.}});
     histos.add("hColCounterTVX", "", kTH1D, {{1, 0., 1.}});
     histos.add("hColCounterAcc", "", kTH1D, {{1, 0., 1.}});
+    histos.add("hFirstCollisionLatency", "latency of the CCDB access at the first data frame of each run;run;time (ms)", kTH1D, {{1, 0., 1.}});
   }
 
   void process(aod::Collisions const& collisions)
@@ -744,6 +773,8 @@ struct EventSelectionTask {
     // extract bc pattern from CCDB for data or anchored MC only
     if (run != lastRun && run >= 500000) {
       lastRun = run;
+      auto start = std::chrono::steady_clock::now();
+      setCcdbSnapshotRun(confCcdbSnapshotDir, run);
       auto runInfo = o2::parameters::AggregatedRunInfo::buildAggregatedRunInfo(o2::ccdb::BasicCCDBManager::instance(), run);
       // first bc of the first orbit
       bcSOR = runInfo.orbitSOR * nBCsPerOrbit;
@@ -759,12 +790,12 @@ struct EventSelectionTask {
       rofOffset = alppar->roFrameBiasInBC;
       rofLength = alppar->roFrameLengthInBC;
       LOGP(debug, "ITS ROF Offset={} ITS ROF Length={}", rofOffset, rofLength);
+      fillFirstCollisionLatency(histos, run, start, !confCcdbSnapshotDir.value.empty());
     } // if run != lastRun
 
     // create maps from globalBC to bc index for TVX-fired bcs
     // to be used for closest TVX searches
-    std::map<int64_t, int32_t> mapGlobalBcWithTVX;
-    std::map<int64_t, float> mapGlobalBcVtxZ;
+    o2::aod::common::GlobalBCIndex<bcWithTVX> mapGlobalBcWithTVX;
     for (const auto& bc : bcs) {
       int64_t globalBC = bc.globalBC();
       // skip non-colliding bcs for data and anchored runs
@@ -772,10 +803,10 @@ struct EventSelectionTask {
         continue;
       }
       if (bc.selection_bit(kIsTriggerTVX)) {
-        mapGlobalBcWithTVX[globalBC] = bc.globalIndex();
-        mapGlobalBcVtxZ[globalBC] = bc.has_ft0() ? bc.ft0().posZ() : 0;
+        mapGlobalBcWithTVX.add(globalBC, {static_cast<int32_t>(bc.globalIndex()), bc.has_ft0() ? bc.ft0().posZ() : 0});
       }
     }
+    mapGlobalBcWithTVX.build();
 
     // protection against empty FT0 maps
     if (mapGlobalBcWithTVX.size() == 0) {
@@ -880,28 +911,28 @@ struct EventSelectionTask {
         // for collisions with TOF tracks:
         // take bc corresponding to TOF track with median time
         int64_t tofGlobalBC = globalBC + TMath::Nint(getMedian(vTrackTimesTOF) / bcNS);
-        std::map<int64_t, int32_t>::iterator it = mapGlobalBcWithTVX.find(tofGlobalBC);
-        if (it != mapGlobalBcWithTVX.end()) {
-          foundGlobalBC = it->first;
-          foundBCindex = it->second;
+        int entry = mapGlobalBcWithTVX.find(tofGlobalBC);
+        if (entry != mapGlobalBcWithTVX.NotFound) {
+          foundGlobalBC = mapGlobalBcWithTVX.globalBC(entry);
+          foundBCindex = mapGlobalBcWithTVX.payload(entry).bcId;
         }
       } else if (nPvTracksTPCnoTOFnoTRD == 0 && nPvTracksTRDnoTOF > 0) {
         // for collisions with TRD tracks but without TOF or ITSTPC-only tracks:
         // take bc corresponding to TRD track with median time
         int64_t trdGlobalBC = globalBC + TMath::Nint(getMedian(vTrackTimesTRDnoTOF) / bcNS);
-        std::map<int64_t, int32_t>::iterator it = mapGlobalBcWithTVX.find(trdGlobalBC);
-        if (it != mapGlobalBcWithTVX.end()) {
-          foundGlobalBC = it->first;
-          foundBCindex = it->second;
+        int entry = mapGlobalBcWithTVX.find(trdGlobalBC);
+        if (entry != mapGlobalBcWithTVX.NotFound) {
+          foundGlobalBC = mapGlobalBcWithTVX.globalBC(entry);
+          foundBCindex = mapGlobalBcWithTVX.payload(entry).bcId;
         }
       } else if (nPvTracksHighPtTPCnoTOFnoTRD > 0) {
         // for collisions with high-pt ITSTPC-nonTOF-nonTRD tracks
         // search in 3*confSigmaBCforHighPtTracks range (3*4 bcs by default)
         int64_t meanBC = globalBC + TMath::Nint(sumHighPtTime / sumHighPtW / bcNS);
-        int64_t bestGlobalBC = findBestGlobalBC(meanBC, confSigmaBCforHighPtTracks, vNcontributors[colIndex], col.posZ(), mapGlobalBcVtxZ);
+        int64_t bestGlobalBC = findBestGlobalBC(meanBC, confSigmaBCforHighPtTracks, vNcontributors[colIndex], col.posZ(), mapGlobalBcWithTVX);
         if (bestGlobalBC > 0) {
           foundGlobalBC = bestGlobalBC;
-          foundBCindex = mapGlobalBcWithTVX[bestGlobalBC];
+          foundBCindex = mapGlobalBcWithTVX.payload(mapGlobalBcWithTVX.find(bestGlobalBC)).bcId;
         }
       }
 
@@ -912,7 +943,7 @@ struct EventSelectionTask {
 
       // erase found global BC with TVX from the pool of bcs for the next loop over low-pt TPCnoTOFnoTRD collisions
       if (foundBCindex >= 0)
-        mapGlobalBcVtxZ.erase(foundGlobalBC);
+        mapGlobalBcWithTVX.deactivate(mapGlobalBcWithTVX.find(foundGlobalBC));
     }
 
     // second loop to match remaining low-pt TPCnoTOFnoTRD collisions
@@ -925,9 +956,9 @@ struct EventSelectionTask {
         int64_t globalBC = bc.globalBC();
         int64_t meanBC = globalBC + TMath::Nint(weightedTime / bcNS);
         int64_t sigmaBC = TMath::CeilNint(weightedSigma / bcNS);
-        int64_t bestGlobalBC = findBestGlobalBC(meanBC, sigmaBC, vNcontributors[colIndex], col.posZ(), mapGlobalBcVtxZ);
+        int64_t bestGlobalBC = findBestGlobalBC(meanBC, sigmaBC, vNcontributors[colIndex], col.posZ(), mapGlobalBcWithTVX);
         vFoundGlobalBC[colIndex] = bestGlobalBC > 0 ? bestGlobalBC : globalBC;
-        vFoundBCindex[colIndex] = bestGlobalBC > 0 ? mapGlobalBcWithTVX[bestGlobalBC] : bc.globalIndex();
+        vFoundBCindex[colIndex] = bestGlobalBC > 0 ? mapGlobalBcWithTVX.payload(mapGlobalBcWithTVX.find(bestGlobalBC)).bcId : bc.globalIndex();
       }
       // fill pileup counter
       vCollisionsPerBc[vFoundBCindex[colIndex]]++;
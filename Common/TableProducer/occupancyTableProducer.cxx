@@ -18,6 +18,7 @@
 #include <vector>
 #include <unordered_map>
 #include <algorithm>
+#include <ctime>
 #include <cmath>
 
 #include "Framework/runDataProcessing.h"
@@ -123,6 +124,47 @@ struct OccupancyTableProducer {
   std::array<std::vector<float>, arraySize> occMultNTracksITSTPCUnfm80;
   std::array<std::vector<float>, arraySize> occMultAllTracksTPCOnlyUnfm80;
 
+  // The counting estimators (contributors, tracks) are integer valued. Per timeframe they are
+  // accumulated in one block of difference arrays over the 80-BC bins, [estimator][bin], and
+  // integrated once with a prefix sum into the occ*Unfm80 vectors. This gives the same values
+  // as adding each collision to all the bins of its drift window.
+  enum OccCountEstimator {
+    kOccPrim = 0,
+    kOccNTrackITS,
+    kOccNTrackTPC,
+    kOccNTrackTRD,
+    kOccNTrackTOF,
+    kOccNTrackSize,
+    kOccNTrackTPCA,
+    kOccNTrackTPCC,
+    kOccNTrackITSTPC,
+    kOccNTrackITSTPCA,
+    kOccNTrackITSTPCC,
+    kOccMultNTracksHasITS,
+    kOccMultNTracksHasTPC,
+    kOccMultNTracksHasTOF,
+    kOccMultNTracksHasTRD,
+    kOccMultNTracksITSOnly,
+    kOccMultNTracksTPCOnly,
+    kOccMultNTracksITSTPC,
+    kOccMultAllTracksTPCOnly,
+    kNOccCountEstimators
+  };
+  static constexpr int nBins80 = nBCinTF / 80;
+  static constexpr int nBinsDrift80 = nBCinDrift / 80;
+  std::array<std::vector<int64_t>, arraySize> occCountsDiff;
+
+  std::array<std::vector<float>*, kNOccCountEstimators> getOccCountVectors(int iTF)
+  {
+    return {&occPrimUnfm80[iTF],
+            &occNTrackITSUnfm80[iTF], &occNTrackTPCUnfm80[iTF], &occNTrackTRDUnfm80[iTF], &occNTrackTOFUnfm80[iTF],
+            &occNTrackSizeUnfm80[iTF], &occNTrackTPCAUnfm80[iTF], &occNTrackTPCCUnfm80[iTF],
+            &occNTrackITSTPCUnfm80[iTF], &occNTrackITSTPCAUnfm80[iTF], &occNTrackITSTPCCUnfm80[iTF],
+            &occMultNTracksHasITSUnfm80[iTF], &occMultNTracksHasTPCUnfm80[iTF], &occMultNTracksHasTOFUnfm80[iTF],
+            &occMultNTracksHasTRDUnfm80[iTF], &occMultNTracksITSOnlyUnfm80[iTF], &occMultNTracksTPCOnlyUnfm80[iTF],
+            &occMultNTracksITSTPCUnfm80[iTF], &occMultAllTracksTPCOnlyUnfm80[iTF]};
+  }
+
   std::vector<float> vecRobustOccT0V0PrimUnfm80;
   std::vector<float> vecRobustOccFDDT0V0PrimUnfm80;
   std::vector<float> vecRobustOccNtrackDetUnfm80;
@@ -164,6 +206,8 @@ struct OccupancyTableProducer {
       occMultNTracksTPCOnlyUnfm80[i].resize(nBCinTF / 80);
       occMultNTracksITSTPCUnfm80[i].resize(nBCinTF / 80);
       occMultAllTracksTPCOnlyUnfm80[i].resize(nBCinTF / 80);
+
+      occCountsDiff[i].resize(kNOccCountEstimators * (nBins80 + 1));
     }
 
     vecRobustOccT0V0PrimUnfm80.resize(nBCinTF / 80);
@@ -183,6 +227,7 @@ struct OccupancyTableProducer {
     recoEvent.add("h_RO_FDDT0V0PrimUnfm80", "h_RO_FDDT0V0PrimUnfm80:median contributors", {HistType::kTH1F, {{12 * 2, -1, 11}}});
     recoEvent.add("h_RO_NtrackDetUnfm80", "h_RO_NtrackDetITS/TPC/TRD/TOF_80:median contributors", {HistType::kTH1F, {{12 * 2, -1, 11}}});
     recoEvent.add("h_RO_multTableUnfm80", "h_RO_multTableExtra_80:median contributors", {HistType::kTH1F, {{12 * 2, -1, 11}}});
+    recoEvent.add("h_cpuTimePerTF", "h_cpuTimePerTF;CPU time per TF (ms)", {HistType::kTH1F, {{1000, 0, 1000}}});
 
     recoEvent.print();
   }
@@ -198,34 +243,34 @@ struct OccupancyTableProducer {
     std::vector<std::array<int, 2>>& medianPosVec,
     const Vecs&... vectors)
   {
-    const int n = sizeof...(Vecs);                             // Number of vectors
+    constexpr int n = sizeof...(Vecs);                         // Number of vectors
     const int size = std::get<0>(std::tie(vectors...)).size(); // Size of the first vector
+    const std::array<const float*, n> columns = {vectors.data()...};
 
+    std::array<float, n> values; // entries of the bin, sorted
+    std::array<int, n> indices;  // index of the vector of each sorted entry
     for (int i = 0; i < size; i++) {
-      std::vector<std::array<double, 2>> data; // first element is entry, second is index
-      int iEntry = 0;
-
-      // Lambda to iterate over all vectors
-      auto collect = [&](const auto& vec) {
-        data.push_back({vec[i], static_cast<double>(iEntry)});
-        iEntry++;
-      };
-      (collect(vectors), ...); // Unpack variadic arguments and apply lambda
-
-      // Sort the data
-      std::sort(data.begin(), data.end(), [](const std::array<double, 2>& a, const std::array<double, 2>& b) {
-        return a[0] < b[0];
-      });
+      // Insertion sort of the n entries: n is small and known at compile time, no allocation
+      for (int iVec = 0; iVec < n; iVec++) {
+        const float value = columns[iVec][i];
+        int j = iVec;
+        for (; j > 0 && values[j - 1] > value; j--) {
+          values[j] = values[j - 1];
+          indices[j] = indices[j - 1];
+        }
+        values[j] = value;
+        indices[j] = iVec;
+      }
 
       double median;
       // Find the median
-      if (n % 2 == 0) {
-        median = (data[(n - 1) / 2][0] + data[(n - 1) / 2 + 1][0]) / 2;
-        medianPosVec[i][0] = static_cast<int>(data[(n - 1) / 2][1] + 0.001);
-        medianPosVec[i][1] = static_cast<int>(data[(n - 1) / 2 + 1][1] + 0.001);
+      if constexpr (n % 2 == 0) {
+        median = (static_cast<double>(values[(n - 1) / 2]) + static_cast<double>(values[(n - 1) / 2 + 1])) / 2;
+        medianPosVec[i][0] = indices[(n - 1) / 2];
+        medianPosVec[i][1] = indices[(n - 1) / 2 + 1];
       } else {
-        median = data[n / 2][0];
-        medianPosVec[i][0] = static_cast<int>(data[n / 2][1] + 0.001);
+        median = values[n / 2];
+        medianPosVec[i][0] = indices[n / 2];
         medianPosVec[i][1] = -10; // For odd entries, only one value can be the median
       }
       medianVector[i] = median;
@@ -278,6 +323,7 @@ struct OccupancyTableProducer {
   void process(o2::aod::BCsWithTimestamps const& BCs, MyCollisions const& collisions, MyTracks const& tracks) // aod::TracksQA const& tracksQA, o2::aod::Origins const& Origins //tables only used during debugging
   {
     // dfCount++;LOG(info) << "DEBUG 1 :: df_" << dfCount ;//<< " :: DF_" << Origins.begin().dataframeID() << " :: collisions.size() = " << collisions.size() << " :: tracks.size() = " << tracks.size() << " :: tracksQA.size() = " << tracksQA.size() << " :: BCs.size() = " << BCs.size();
+    const std::clock_t cpuTimeStart = std::clock();
 
     if (collisions.size() == 0) {
       for (const auto& BC : BCs) { // For BCs and OccIndexTable to have same size for joining
@@ -294,33 +340,13 @@ struct OccupancyTableProducer {
     for (int i = 0; i < arraySize; i++) {
       tfList[i] = -1;
       bcTFMap[i].clear(); // list of BCs used in one time frame;
-      std::fill(occPrimUnfm80[i].begin(), occPrimUnfm80[i].end(), 0.);
       std::fill(occFV0AUnfm80[i].begin(), occFV0AUnfm80[i].end(), 0.);
       std::fill(occFV0CUnfm80[i].begin(), occFV0CUnfm80[i].end(), 0.);
       std::fill(occFT0AUnfm80[i].begin(), occFT0AUnfm80[i].end(), 0.);
       std::fill(occFT0CUnfm80[i].begin(), occFT0CUnfm80[i].end(), 0.);
       std::fill(occFDDAUnfm80[i].begin(), occFDDAUnfm80[i].end(), 0.);
       std::fill(occFDDCUnfm80[i].begin(), occFDDCUnfm80[i].end(), 0.);
-
-      std::fill(occNTrackITSUnfm80[i].begin(), occNTrackITSUnfm80[i].end(), 0.);
-      std::fill(occNTrackTPCUnfm80[i].begin(), occNTrackTPCUnfm80[i].end(), 0.);
-      std::fill(occNTrackTRDUnfm80[i].begin(), occNTrackTRDUnfm80[i].end(), 0.);
-      std::fill(occNTrackTOFUnfm80[i].begin(), occNTrackTOFUnfm80[i].end(), 0.);
-      std::fill(occNTrackSizeUnfm80[i].begin(), occNTrackSizeUnfm80[i].end(), 0.);
-      std::fill(occNTrackTPCAUnfm80[i].begin(), occNTrackTPCAUnfm80[i].end(), 0.);
-      std::fill(occNTrackTPCCUnfm80[i].begin(), occNTrackTPCCUnfm80[i].end(), 0.);
-      std::fill(occNTrackITSTPCUnfm80[i].begin(), occNTrackITSTPCUnfm80[i].end(), 0.);
-      std::fill(occNTrackITSTPCAUnfm80[i].begin(), occNTrackITSTPCAUnfm80[i].end(), 0.);
-      std::fill(occNTrackITSTPCCUnfm80[i].begin(), occNTrackITSTPCCUnfm80[i].end(), 0.);
-
-      std::fill(occMultNTracksHasITSUnfm80[i].begin(), occMultNTracksHasITSUnfm80[i].end(), 0.);
-      std::fill(occMultNTracksHasTPCUnfm80[i].begin(), occMultNTracksHasTPCUnfm80[i].end(), 0.);
-      std::fill(occMultNTracksHasTOFUnfm80[i].begin(), occMultNTracksHasTOFUnfm80[i].end(), 0.);
-      std::fill(occMultNTracksHasTRDUnfm80[i].begin(), occMultNTracksHasTRDUnfm80[i].end(), 0.);
-      std::fill(occMultNTracksITSOnlyUnfm80[i].begin(), occMultNTracksITSOnlyUnfm80[i].end(), 0.);
-      std::fill(occMultNTracksTPCOnlyUnfm80[i].begin(), occMultNTracksTPCOnlyUnfm80[i].end(), 0.);
-      std::fill(occMultNTracksITSTPCUnfm80[i].begin(), occMultNTracksITSTPCUnfm80[i].end(), 0.);
-      std::fill(occMultAllTracksTPCOnlyUnfm80[i].begin(), occMultAllTracksTPCOnlyUnfm80[i].end(), 0.);
+      std::fill(occCountsDiff[i].begin(), occCountsDiff[i].end(), 0); // the counting estimators are integrated from it
     }
 
     std::vector<int64_t> tfIDList;
@@ -395,33 +421,13 @@ struct OccupancyTableProducer {
       }
 
       bcTFMap[tfIDX].push_back(bc.globalIndex());
-      auto& tfOccPrimUnfm80 = occPrimUnfm80[tfIDX];
       auto& tfOccFV0AUnfm80 = occFV0AUnfm80[tfIDX];
       auto& tfOccFV0CUnfm80 = occFV0CUnfm80[tfIDX];
       auto& tfOccFT0AUnfm80 = occFT0AUnfm80[tfIDX];
       auto& tfOccFT0CUnfm80 = occFT0CUnfm80[tfIDX];
       auto& tfOccFDDAUnfm80 = occFDDAUnfm80[tfIDX];
       auto& tfOccFDDCUnfm80 = occFDDCUnfm80[tfIDX];
-
-      auto& tfOccNTrackITSUnfm80 = occNTrackITSUnfm80[tfIDX];
-      auto& tfOccNTrackTPCUnfm80 = occNTrackTPCUnfm80[tfIDX];
-      auto& tfOccNTrackTRDUnfm80 = occNTrackTRDUnfm80[tfIDX];
-      auto& tfOccNTrackTOFUnfm80 = occNTrackTOFUnfm80[tfIDX];
-      auto& tfOccNTrackSizeUnfm80 = occNTrackSizeUnfm80[tfIDX];
-      auto& tfOccNTrackTPCAUnfm80 = occNTrackTPCAUnfm80[tfIDX];
-      auto& tfOccNTrackTPCCUnfm80 = occNTrackTPCCUnfm80[tfIDX];
-      auto& tfOccNTrackITSTPCUnfm80 = occNTrackITSTPCUnfm80[tfIDX];
-      auto& tfOccNTrackITSTPCAUnfm80 = occNTrackITSTPCAUnfm80[tfIDX];
-      auto& tfOccNTrackITSTPCCUnfm80 = occNTrackITSTPCCUnfm80[tfIDX];
-
-      auto& tfOccMultNTracksHasITSUnfm80 = occMultNTracksHasITSUnfm80[tfIDX];
-      auto& tfOccMultNTracksHasTPCUnfm80 = occMultNTracksHasTPCUnfm80[tfIDX];
-      auto& tfOccMultNTracksHasTOFUnfm80 = occMultNTracksHasTOFUnfm80[tfIDX];
-      auto& tfOccMultNTracksHasTRDUnfm80 = occMultNTracksHasTRDUnfm80[tfIDX];
-      auto& tfOccMultNTracksITSOnlyUnfm80 = occMultNTracksITSOnlyUnfm80[tfIDX];
-      auto& tfOccMultNTracksTPCOnlyUnfm80 = occMultNTracksTPCOnlyUnfm80[tfIDX];
-      auto& tfOccMultNTracksITSTPCUnfm80 = occMultNTracksITSTPCUnfm80[tfIDX];
-      auto& tfOccMultAllTracksTPCOnlyUnfm80 = occMultAllTracksTPCOnlyUnfm80[tfIDX];
+      auto& tfOccCountsDiff = occCountsDiff[tfIDX];
 
       // current collision bin in 80/160 grouping.
       int bin80Zero = bcInTF / 80;
@@ -442,35 +448,43 @@ struct OccupancyTableProducer {
       int fNTrackITSTPCA = nTrackITSTPCA, fNTrackITSTPCC = nTrackITSTPCC;
 
       // Processing for grouping of 80 BCs
-      for (int deltaBin = 0; deltaBin < nBCinDrift / 80; deltaBin++) {
-        tfOccPrimUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += fNumContrib * 1;
-        tfOccFV0AUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += fMultFV0A * 1;
-        tfOccFV0CUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += fMultFV0C * 1;
-        tfOccFT0AUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += fMultFT0A * 1;
-        tfOccFT0CUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += fMultFT0C * 1;
-        tfOccFDDAUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += fMultFDDA * 1;
-        tfOccFDDCUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += fMultFDDC * 1;
-
-        tfOccNTrackITSUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += fNTrackITS * 1;
-        tfOccNTrackTPCUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += fNTrackTPC * 1;
-        tfOccNTrackTRDUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += fNTrackTRD * 1;
-        tfOccNTrackTOFUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += fNTrackTOF * 1;
-        tfOccNTrackSizeUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += fNTrackSize * 1;
-        tfOccNTrackTPCAUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += fNTrackTPCA * 1;
-        tfOccNTrackTPCCUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += fNTrackTPCC * 1;
-        tfOccNTrackITSTPCUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += fNTrackITSTPC * 1;
-        tfOccNTrackITSTPCAUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += fNTrackITSTPCA * 1;
-        tfOccNTrackITSTPCCUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += fNTrackITSTPCC * 1;
-
-        tfOccMultNTracksHasITSUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += collision.multNTracksHasITS() * 1;
-        tfOccMultNTracksHasTPCUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += collision.multNTracksHasTPC() * 1;
-        tfOccMultNTracksHasTOFUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += collision.multNTracksHasTOF() * 1;
-        tfOccMultNTracksHasTRDUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += collision.multNTracksHasTRD() * 1;
-        tfOccMultNTracksITSOnlyUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += collision.multNTracksITSOnly() * 1;
-        tfOccMultNTracksTPCOnlyUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += collision.multNTracksTPCOnly() * 1;
-        tfOccMultNTracksITSTPCUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += collision.multNTracksITSTPC() * 1;
-        tfOccMultAllTracksTPCOnlyUnfm80[(bin80Zero + deltaBin) % (nBCinTF / 80)] += collision.multAllTracksTPCOnly() * 1;
+      // the collision contributes to the nBinsDrift80 bins from its own, wrapping around the end of the TF
+      const int binBegin = bin80Zero % nBins80;
+      const int binEnd = binBegin + nBinsDrift80;
+      const int binEndNoWrap = std::min(binEnd, nBins80);
+
+      const std::array<int64_t, kNOccCountEstimators> counts = {
+        fNumContrib,
+        fNTrackITS, fNTrackTPC, fNTrackTRD, fNTrackTOF, fNTrackSize, fNTrackTPCA, fNTrackTPCC,
+        fNTrackITSTPC, fNTrackITSTPCA, fNTrackITSTPCC,
+        collision.multNTracksHasITS(), collision.multNTracksHasTPC(), collision.multNTracksHasTOF(),
+        collision.multNTracksHasTRD(), collision.multNTracksITSOnly(), collision.multNTracksTPCOnly(),
+        collision.multNTracksITSTPC(), collision.multAllTracksTPCOnly()};
+      for (int iEst = 0; iEst < kNOccCountEstimators; iEst++) {
+        int64_t* diff = tfOccCountsDiff.data() + iEst * (nBins80 + 1);
+        diff[binBegin] += counts[iEst];
+        diff[binEndNoWrap] -= counts[iEst];
+        if (binEnd > nBins80) {
+          diff[0] += counts[iEst];
+          diff[binEnd - nBins80] -= counts[iEst];
+        }
       }
+
+      // the FIT amplitudes are not integer, they are added bin by bin to keep the same rounding
+      auto addToDriftWindow = [&](std::vector<float>& occVector, const float& value) {
+        for (int bin = binBegin; bin < binEndNoWrap; bin++) {
+          occVector[bin] += value;
+        }
+        for (int bin = 0; bin < binEnd - nBins80; bin++) {
+          occVector[bin] += value;
+        }
+      };
+      addToDriftWindow(tfOccFV0AUnfm80, fMultFV0A);
+      addToDriftWindow(tfOccFV0CUnfm80, fMultFV0C);
+      addToDriftWindow(tfOccFT0AUnfm80, fMultFT0A);
+      addToDriftWindow(tfOccFT0CUnfm80, fMultFT0C);
+      addToDriftWindow(tfOccFDDAUnfm80, fMultFDDA);
+      addToDriftWindow(tfOccFDDCUnfm80, fMultFDDC);
     }
     // collision Loop is over
 
@@ -496,6 +510,20 @@ struct OccupancyTableProducer {
       LOG(debug) << "DEBUG :: ERROR :: filled TF list and collision size mismatch ::  filledTF_Size = " << totalBCcountSize << " != " << collisions.size() << " = collisions.size()";
     }
 
+    // Integrate the counting estimators of each TF
+    for (uint i = 0; i < tfCounted; i++) {
+      const auto occCountVectors = getOccCountVectors(i);
+      for (int iEst = 0; iEst < kNOccCountEstimators; iEst++) {
+        const int64_t* diff = occCountsDiff[i].data() + iEst * (nBins80 + 1);
+        auto& occVector = *occCountVectors[iEst];
+        int64_t sum = 0;
+        for (int bin = 0; bin < nBins80; bin++) {
+          sum += diff[bin];
+          occVector[bin] = sum;
+        }
+      }
+    }
+
     // Fill the Producers
     for (uint i = 0; i < tfCounted; i++) {
 
@@ -685,6 +713,13 @@ struct OccupancyTableProducer {
       }
     }
 
+    // BCs with collisions per TF, sorted for the lookups below
+    std::array<std::vector<int64_t>, arraySize> sortedBcTFMap;
+    for (int i = 0; i < arraySize; i++) {
+      sortedBcTFMap[i] = bcTFMap[i];
+      std::sort(sortedBcTFMap[i].begin(), sortedBcTFMap[i].end());
+    }
+
     // Create a BC index table.
     int64_t occIDX = -1;
     int idx = -1;
@@ -699,8 +734,7 @@ struct OccupancyTableProducer {
         LOG(error) << "DEBUG :: SEVERE :: BC  Timeframe not in the list";
       }
 
-      auto it = std::find(bcTFMap[idx].begin(), bcTFMap[idx].end(), bc.globalIndex()); // will find the iterator where object is placed.
-      if (it != bcTFMap[idx].end()) {
+      if (std::binary_search(sortedBcTFMap[idx].begin(), sortedBcTFMap[idx].end(), bc.globalIndex())) {
         occIDX = idx; // Element is in the vector
       } else {
         occIDX = -1; // Element is not in the vector
@@ -709,6 +743,10 @@ struct OccupancyTableProducer {
       genOccIndexTable(bc.globalIndex(), occIDX); // BCId, OccId
       genBCTFinfoTable(tfIdThis, bcInTF);
     }
+
+    if (tfCounted > 0) {
+      recoEvent.fill(HIST("h_cpuTimePerTF"), 1000. * (std::clock() - cpuTimeStart) / CLOCKS_PER_SEC / tfCounted);
+    }
   } // Process function ends
 };
 
@@ -39,6 +39,7 @@ struct TrackToCollisionAssociation {
   Configurable<bool> includeUnassigned{"includeUnassigned", false, "consider also tracks which are not assigned to any collision"};
   Configurable<bool> fillTableOfCollIdsPerTrack{"fillTableOfCollIdsPerTrack", false, "fill additional table with vector of collision ids per track"};
   Configurable<int> bcWindowForOneSigma{"bcWindowForOneSigma", 60, "BC window to be multiplied by the number of sigmas to define maximum window to be considered"};
+  Configurable<bool> useSortedTimeIndex{"useSortedTimeIndex", false, "use the time-sorted track index (sort-and-sweep) in the time-based association"};
 
   CollisionAssociation<true> collisionAssociator;
 
@@ -62,6 +63,7 @@ struct TrackToCollisionAssociation {
     collisionAssociator.setUsePvAssociation(usePVAssociation);
     collisionAssociator.setIncludeUnassigned(includeUnassigned);
     collisionAssociator.setFillTableOfCollIdsPerTrack(fillTableOfCollIdsPerTrack);
+    collisionAssociator.setUseSortedTimeIndex(useSortedTimeIndex);
     collisionAssociator.setBcWindow(bcWindowForOneSigma);
   }
 
@@ -0,0 +1,109 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file ccdbSnapshot.cxx
+/// \brief Prefetches the CCDB objects needed to analyse an AO2D into a local CCDB snapshot
+///
+/// The runs and the time range of the input are taken from the BC timestamps. For every run, the objects
+/// of the configured paths valid between SOR and EOR are looked up following their Valid-Until boundaries
+/// and stored in the content-addressed snapshot of Common/CCDB/ccdbSnapshot.h, together with the run
+/// information and a view of the run in the layout of the CcdbApi snapshots. Several jobs can fill the
+/// same snapshot directory concurrently.
+///
+/// The tasks then read the snapshot either through o2::common::ccdb::CCDBSnapshot, which resolves the
+/// objects by timestamp, or with their BasicCCDBManager pointed to the view of the current run
+/// (e.g. o2-analysis-event-selection with ccdbSnapshotDir set), fully offline in both cases.
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "CCDB/BasicCCDBManager.h"
+#include "CCDB/CcdbApi.h"
+#include "Common/CCDB/ccdbSnapshot.h"
+#include "Framework/AnalysisDataModel.h"
+#include "Framework/AnalysisTask.h"
+#include "Framework/HistogramRegistry.h"
+#include "Framework/runDataProcessing.h"
+
+using namespace o2;
+using namespace o2::framework;
+
+struct CcdbSnapshot {
+  Configurable<std::string> ccdbUrl{"ccdbUrl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
+  Configurable<std::string> snapshotDir{"snapshotDir", "ccdb-snapshot", "directory of the snapshot, existing content is kept"};
+  Configurable<std::vector<std::string>> paths{"paths", std::vector<std::string>{"GLO/Config/GRPMagField", "GLO/GRP/GRP", "GLO/Param/MatLUT", "GLO/Config/GRPLHCIF", "GLO/Config/GRPECS", "CTP/Calib/OrbitReset", "EventSelection/EventSelectionParams", "EventSelection/TriggerAliases", "ITS/Config/AlpideParam", "ITS/Calib/TimeDeadMap"}, "CCDB paths to store in the snapshot (RCT/Info/RunInformation is always stored)"};
+  Configurable<std::vector<std::string>> pathsWithRunNumber{"pathsWithRunNumber", std::vector<std::string>{"GLO/Config/GRPECS"}, "paths queried with the runNumber metadata, as read with BasicCCDBManager::getSpecific"};
+
+  HistogramRegistry histos{"Histos", {}, OutputObjHandlingPolicy::AnalysisObject};
+
+  o2::ccdb::CcdbApi ccdbApi;
+  o2::common::ccdb::CCDBSnapshot snapshot;
+  std::set<int> runsDone;
+
+  void init(InitContext&)
+  {
+    ccdbApi.init(ccdbUrl);
+    if (!snapshot.create(snapshotDir)) {
+      LOGF(fatal, "Cannot create the CCDB snapshot in %s", snapshotDir.value);
+    }
+    histos.add("hPrefetchTime", "time to prefetch the objects of a run;run;time (ms)", HistType::kTH1D, {{1, 0., 1.}});
+  }
+
+  void process(aod::BCsWithTimestamps const& bcs)
+  {
+    if (bcs.size() == 0) {
+      return;
+    }
+    int lastRun = -1;
+    for (const auto& bc : bcs) {
+      if (bc.runNumber() == lastRun) {
+        continue;
+      }
+      lastRun = bc.runNumber();
+      if (!runsDone.insert(lastRun).second) {
+        continue;
+      }
+      auto start = std::chrono::steady_clock::now();
+      auto [sor, eor] = o2::ccdb::BasicCCDBManager::getRunDuration(ccdbApi, lastRun);
+      if (!snapshot.prefetchRun(ccdbApi, paths, pathsWithRunNumber, lastRun, sor, eor)) {
+        LOGF(fatal, "Cannot prefetch the CCDB objects of run %d", lastRun);
+      }
+      double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+      histos.get<TH1>(HIST("hPrefetchTime"))->Fill(Form("%d", lastRun), elapsed);
+      LOGF(info, "Prefetched the CCDB objects of run %d (%lld - %lld) in %.1f ms", lastRun, sor, eor, elapsed);
+    }
+    // BC timestamps outside of the run duration
+    for (const auto timestamp : {bcs.iteratorAt(0).timestamp(), bcs.iteratorAt(bcs.size() - 1).timestamp()}) {
+      for (const auto& path : paths.value) {
+        std::map<std::string, std::string> metadata;
+        if (std::find(pathsWithRunNumber->begin(), pathsWithRunNumber->end(), path) != pathsWithRunNumber->end()) {
+          metadata["runNumber"] = std::to_string(lastRun);
+        }
+        if (!snapshot.find(path, timestamp) && snapshot.prefetch(ccdbApi, path, lastRun, timestamp, timestamp + 1, metadata) < 0) {
+          LOGF(fatal, "Cannot prefetch %s for timestamp %lld", path, timestamp);
+        }
+      }
+    }
+    // written for every data frame, so that the snapshot can be used while the input is still being processed
+    if (!snapshot.writeIndex()) {
+      LOGF(fatal, "Cannot write the index of the CCDB snapshot %s", snapshotDir.value);
+    }
+  }
+};
+
+WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
+{
+  return WorkflowSpec{adaptAnalysisTask<CcdbSnapshot>(cfgc)};
+}
@@ -20,8 +20,17 @@
 // are to be queried (from B field to material LUT and others).
 // For now: magnetic field is required, matlut is optional
 //
+// The latency of the first data frame of every run is reported, so that the
+// access to the CCDB server and to a local snapshot made with
+// o2-analysis-ccdb-snapshot (ccdb-url file://<dir>, or ALICEO2_CCDB_LOCALCACHE)
+// can be compared.
+//
 // +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
 
+#include <chrono>
+#include <set>
+#include <string>
+
 #include "Framework/AnalysisDataModel.h"
 #include "Framework/AnalysisTask.h"
 #include "Framework/HistogramRegistry.h"
@@ -58,6 +67,8 @@ struct integrationTestCCDB {
   HistogramRegistry histos{"Histos", {}, OutputObjHandlingPolicy::AnalysisObject};
   o2::base::MatLayerCylSet* lut;
 
+  std::set<int> runsSeen; // runs for which the first-collision latency was already reported
+
   int mRunNumber;
 
   void initMagneticFieldCCDB(aod::BCsWithTimestamps::iterator const& bc)
@@ -99,6 +110,7 @@ struct integrationTestCCDB {
     lut = 0x0;
     const AxisSpec axis{1, 0.0f, 1.0f, ""};
     histos.add<TH1>("hDFs", "hDFs", HistType::kTH1F, {axis});
+    histos.add<TH1>("hFirstCollisionLatency", "latency of the CCDB access for the first data frame of each run;run;time (ms)", HistType::kTH1D, {axis});
   }
 
   void process(aod::BCsWithTimestamps const& bcs)
@@ -107,6 +119,7 @@ struct integrationTestCCDB {
 
     auto bc = bcs.begin(); // first element
     histos.fill(HIST("hDFs"), 0.5f);
+    auto start = std::chrono::steady_clock::now();
 
     ccdb->setURL(ccdburl);
     ccdb->setCaching(true);
@@ -119,6 +132,12 @@ struct integrationTestCCDB {
       LOG(info) << "Material LUT min R: " << lut->getRMin() << " max R: " << lut->getRMax();
     }
     initMagneticFieldCCDB(bc);
+
+    if (runsSeen.insert(bc.runNumber()).second) {
+      double latency = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+      histos.get<TH1>(HIST("hFirstCollisionLatency"))->Fill(Form("%d", bc.runNumber()), latency);
+      LOG(info) << "First-collision latency of run " << bc.runNumber() << ": " << latency << " ms";
+    }
   }
 };
 
@@ -13,14 +13,13 @@
 #include "Zorro.h"
 
 #include <algorithm>
+#include <limits>
 #include <map>
 
 #include <TList.h>
 
 #include "CCDB/BasicCCDBManager.h"
-#include "CommonDataFormat/InteractionRecord.h"
-
-using o2::InteractionRecord;
+#include "CommonConstants/LHCConstants.h"
 
 namespace
 {
@@ -33,8 +32,26 @@ int findBin(TH1* hist, const std::string& label)
   }
   return -1;
 }
+constexpr uint64_t kNoSelectedRange = std::numeric_limits<uint64_t>::max();
+constexpr size_t kMaxTOIsInMask = 64;
 } // namespace
 
+template <typename F>
+void Zorro::forEachOverlappingRange(uint64_t bcGlobalId, uint64_t tolerance, F&& func) const
+{
+  const uint64_t bcMin = bcGlobalId > tolerance ? bcGlobalId - tolerance : 0;
+  const uint64_t bcMax = bcGlobalId + tolerance;
+  // Ranges are sorted by their start and the running maximum of their ends is monotonic as well, so both
+  // boundaries of the candidate ranges are found with a binary search; ranges nested in a previous one are skipped
+  const size_t first = std::lower_bound(mBCrangeRunningMax.begin(), mBCrangeRunningMax.end(), bcMin) - mBCrangeRunningMax.begin();
+  const size_t last = std::upper_bound(mBCrangeMin.begin(), mBCrangeMin.end(), bcMax) - mBCrangeMin.begin();
+  for (size_t i{first}; i < last; ++i) {
+    if (mBCrangeMax[i] >= bcMin) {
+      func(i);
+    }
+  }
+}
+
 void Zorro::populateHistRegistry(o2::framework::HistogramRegistry& histRegistry, int runNumber, std::string folderName)
 {
   int runId{-1};
@@ -173,7 +190,7 @@ std::vector<int> Zorro::initCCDB(o2::ccdb::BasicCCDBManager* ccdb, int runNumber
   mInspectedTVX = mCCDB->getSpecific<TH1D>(mBaseCCDBPath + "InspectedTVX", runTs, metadata);
   setupHelpers(timestamp);
   mLastBCglobalId = 0;
-  mLastSelectedIdx = 0;
+  mLastSelectedIdx = kNoSelectedRange;
   mTOIs.clear();
   mTOIidx.clear();
   while (!tois.empty()) {
@@ -189,6 +206,10 @@ std::vector<int> Zorro::initCCDB(o2::ccdb::BasicCCDBManager* ccdb, int runNumber
     tois = tois.erase(0, pos + 1);
   }
   mTOIcounts.resize(mTOIs.size(), 0);
+  updateTOImasks();
+  if (mTOIs.size() > kMaxTOIsInMask) {
+    LOGF(warning, "Only the first %zu triggers of interest are reported in the TOI bitmasks", kMaxTOIsInMask);
+  }
   LOGF(info, "Zorro initialized for run %d, triggers of interest:", runNumber);
   for (size_t i{0}; i < mTOIs.size(); ++i) {
     LOGF(info, ">>> %s : %i", mTOIs[i].data(), mTOIidx[i]);
@@ -206,36 +227,27 @@ std::vector<int> Zorro::initCCDB(o2::ccdb::BasicCCDBManager* ccdb, int runNumber
 std::bitset<128> Zorro::fetch(uint64_t bcGlobalId, uint64_t tolerance)
 {
   mLastResult.reset();
-  if (bcGlobalId < mBCranges.front().getMin().toLong() - tolerance || bcGlobalId > mBCranges.back().getMax().toLong() + tolerance) {
-    setupHelpers((mOrbitResetTimestamp + int64_t(bcGlobalId * o2::constants::lhc::LHCBunchSpacingNS * 1e-3)) / 1000);
-  }
+  mLastTOImask = 0;
+  checkHelpers(bcGlobalId, tolerance);
 
-  o2::dataformats::IRFrame bcFrame{InteractionRecord::long2IR(bcGlobalId) - tolerance, InteractionRecord::long2IR(bcGlobalId) + tolerance};
-  if (bcGlobalId < mLastBCglobalId) { /// Handle the possible discontinuity in the BC processed by the analyses
-    mLastSelectedIdx = 0;
-  }
-  uint64_t lastSelectedIdx = mLastSelectedIdx;
+  bool firstOverlap{true};
   mLastBCglobalId = bcGlobalId;
-  for (size_t i = mLastSelectedIdx; i < mBCranges.size(); i++) {
-    if (!mBCranges[i].isOutside(bcFrame)) {
-      for (int iMask{0}; iMask < 2; ++iMask) {
-        for (int iTOI{0}; iTOI < 64; ++iTOI) {
-          if (mZorroHelpers->at(i).selMask[iMask] & (1ull << iTOI)) {
-            mLastResult.set(iMask * 64 + iTOI, 1);
-            if (mAnalysedTriggers && !mAccountedBCranges[i]) {
-              mAnalysedTriggers->Fill(iMask * 64 + iTOI);
-            }
-          }
+  forEachOverlappingRange(bcGlobalId, tolerance, [&](size_t i) {
+    mLastResult |= mSelMasks[i];
+    mLastTOImask |= mTOImasks[i];
+    if (firstOverlap) {
+      mLastSelectedIdx = i; /// Used by isSelected to count each selected range only once
+      firstOverlap = false;
+    }
+    if (mAnalysedTriggers && !mAccountedBCranges[i]) {
+      for (size_t iBit{0}; iBit < mSelMasks[i].size(); ++iBit) {
+        if (mSelMasks[i].test(iBit)) {
+          mAnalysedTriggers->Fill(iBit);
         }
       }
-      mAccountedBCranges[i] = true;
-      mLastSelectedIdx = mLastSelectedIdx == lastSelectedIdx-- ? i : mLastSelectedIdx; /// Decrease lastSelectedIdx to make sure this check is valid only in its first instance
-    } else if (mBCranges[i].getMax() < bcFrame.getMin()) {
-      mLastSelectedIdx = i;
-    } else if (mBCranges[i].getMin() > bcFrame.getMax()) {
-      break;
     }
-  }
+    mAccountedBCranges[i] = true;
+  });
   return mLastResult;
 }
 
@@ -243,17 +255,18 @@ bool Zorro::isSelected(uint64_t bcGlobalId, uint64_t tolerance, TH2* ToiHisto)
 {
   uint64_t lastSelectedIdx = mLastSelectedIdx;
   fetch(bcGlobalId, tolerance);
+  const bool newSelection = lastSelectedIdx != mLastSelectedIdx; /// Avoid double counting
   bool retVal{false};
   for (size_t i{0}; i < mTOIidx.size(); ++i) {
     if (mTOIidx[i] < 0) {
       continue;
     } else if (mLastResult.test(mTOIidx[i])) {
-      mTOIcounts[i] += (lastSelectedIdx != mLastSelectedIdx); /// Avoid double counting
-      if (mAnalysedTriggersOfInterest && lastSelectedIdx != mLastSelectedIdx) {
+      mTOIcounts[i] += newSelection;
+      if (mAnalysedTriggersOfInterest && newSelection) {
         mAnalysedTriggersOfInterest->Fill(i);
         mZorroSummary.increaseTOIcounter(mRunNumber, i);
       }
-      if (ToiHisto && lastSelectedIdx != mLastSelectedIdx) {
+      if (ToiHisto && newSelection) {
         ToiHisto->Fill(Form("%d", mRunNumber), Form("%s", mTOIs[i].data()), 1);
       }
       retVal = true;
@@ -281,12 +294,37 @@ std::vector<bool> Zorro::getTriggerOfInterestResults() const
   return results;
 }
 
+uint64_t Zorro::getTriggerOfInterestMask(uint64_t bcGlobalId, uint64_t tolerance)
+{
+  checkHelpers(bcGlobalId, tolerance);
+  uint64_t mask{0};
+  forEachOverlappingRange(bcGlobalId, tolerance, [&](size_t i) { mask |= mTOImasks[i]; });
+  return mask;
+}
+
+void Zorro::getTriggerOfInterestMasks(std::span<const uint64_t> bcGlobalIds, std::span<uint64_t> masks, uint64_t tolerance)
+{
+  if (masks.size() < bcGlobalIds.size()) {
+    LOGF(fatal, "Zorro: output span too small for the TOI masks (%zu < %zu)", masks.size(), bcGlobalIds.size());
+  }
+  for (size_t i{0}; i < bcGlobalIds.size(); ++i) {
+    masks[i] = getTriggerOfInterestMask(bcGlobalIds[i], tolerance);
+  }
+}
+
 bool Zorro::isNotSelectedByAny(uint64_t bcGlobalId, uint64_t tolerance)
 {
   fetch(bcGlobalId, tolerance);
   return mLastResult.none();
 }
 
+void Zorro::checkHelpers(uint64_t bcGlobalId, uint64_t tolerance)
+{
+  if (mBCrangeMin.empty() || bcGlobalId + tolerance < mBCrangeMin.front() || bcGlobalId > mBCrangeRunningMax.back() + tolerance) {
+    setupHelpers((mOrbitResetTimestamp + int64_t(bcGlobalId * o2::constants::lhc::LHCBunchSpacingNS * 1e-3)) / 1000);
+  }
+}
+
 void Zorro::setupHelpers(int64_t timestamp)
 {
   if (mCCDB->isCachedObjectValid(mBaseCCDBPath + "ZorroHelpers", timestamp)) {
@@ -294,10 +332,35 @@ void Zorro::setupHelpers(int64_t timestamp)
   }
   mZorroHelpers = mCCDB->getSpecific<std::vector<ZorroHelper>>(mBaseCCDBPath + "ZorroHelpers", timestamp, {{"runNumber", std::to_string(mRunNumber)}});
   std::sort(mZorroHelpers->begin(), mZorroHelpers->end(), [](const auto& a, const auto& b) { return std::min(a.bcAOD, a.bcEvSel) < std::min(b.bcAOD, b.bcEvSel); });
-  mBCranges.clear();
+  mBCrangeMin.clear();
+  mBCrangeMax.clear();
+  mBCrangeRunningMax.clear();
+  mSelMasks.clear();
   mAccountedBCranges.clear();
-  for (auto helper : *mZorroHelpers) {
-    mBCranges.emplace_back(InteractionRecord::long2IR(std::min(helper.bcAOD, helper.bcEvSel)), InteractionRecord::long2IR(std::max(helper.bcAOD, helper.bcEvSel)));
+  for (const auto& helper : *mZorroHelpers) {
+    mBCrangeMin.push_back(std::min(helper.bcAOD, helper.bcEvSel));
+    mBCrangeMax.push_back(std::max(helper.bcAOD, helper.bcEvSel));
+    mBCrangeRunningMax.push_back(mBCrangeRunningMax.empty() ? mBCrangeMax.back() : std::max(mBCrangeRunningMax.back(), mBCrangeMax.back()));
+    std::bitset<128>& selMask = mSelMasks.emplace_back();
+    for (int iMask{0}; iMask < 2; ++iMask) {
+      for (int iTOI{0}; iTOI < 64; ++iTOI) {
+        selMask.set(iMask * 64 + iTOI, helper.selMask[iMask] & (1ull << iTOI));
+      }
+    }
+  }
+  mAccountedBCranges.resize(mBCrangeMin.size(), false);
+  mLastSelectedIdx = kNoSelectedRange;
+  updateTOImasks();
+}
+
+void Zorro::updateTOImasks()
+{
+  mTOImasks.assign(mSelMasks.size(), 0ull);
+  for (size_t iRange{0}; iRange < mSelMasks.size(); ++iRange) {
+    for (size_t i{0}; i < std::min(mTOIidx.size(), kMaxTOIsInMask); ++i) {
+      if (mTOIidx[i] >= 0 && mSelMasks[iRange].test(mTOIidx[i])) {
+        mTOImasks[iRange] |= 1ull << i;
+      }
+    }
   }
-  mAccountedBCranges.resize(mBCranges.size(), false);
 }
@@ -15,14 +15,15 @@
 #define EVENTFILTERING_ZORRO_H_
 
 #include <bitset>
+#include <cstdint>
 #include <memory>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "TH1D.h"
 #include "TH2D.h"
-#include "CommonDataFormat/IRFrame.h"
 #include "Framework/HistogramRegistry.h"
 #include "ZorroHelper.h"
 #include "ZorroSummary.h"
@@ -54,6 +55,10 @@ class Zorro
   std::vector<int> getTOIcounters() const { return mTOIcounts; }
   std::vector<bool> getTriggerOfInterestResults(uint64_t bcGlobalId, uint64_t tolerance = 100);
   std::vector<bool> getTriggerOfInterestResults() const;
+  /// TOI bitmasks (bit i set if the i-th TOI fired), without accounting and allocations; at most 64 TOIs
+  uint64_t getTriggerOfInterestMask(uint64_t bcGlobalId, uint64_t tolerance = 100);
+  uint64_t getTriggerOfInterestMask() const { return mLastTOImask; }
+  void getTriggerOfInterestMasks(std::span<const uint64_t> bcGlobalIds, std::span<uint64_t> masks, uint64_t tolerance = 100);
 
   void setCCDBpath(std::string path) { mBaseCCDBPath = path; }
   void setBaseCCDBPath(std::string path) { mBaseCCDBPath = path; }
@@ -63,6 +68,12 @@ class Zorro
 
  private:
   void setupHelpers(int64_t timestamp);
+  void checkHelpers(uint64_t bcGlobalId, uint64_t tolerance);
+  void updateTOImasks();
+
+  /// Calls func(i) for each BC range i overlapping [bcGlobalId - tolerance, bcGlobalId + tolerance], in increasing order
+  template <typename F>
+  void forEachOverlappingRange(uint64_t bcGlobalId, uint64_t tolerance, F&& func) const;
 
   ZorroSummary mZorroSummary{"ZorroSummary", "ZorroSummary"};
 
@@ -80,12 +91,17 @@ class Zorro
   int mBCtolerance = 100;
   uint64_t mLastBCglobalId = 0;
   uint64_t mLastSelectedIdx = 0;
+  uint64_t mLastTOImask = 0;
   TH1D* mScalers = nullptr;
   TH1D* mSelections = nullptr;
   TH1D* mInspectedTVX = nullptr;
   std::bitset<128> mLastResult;
-  std::vector<bool> mAccountedBCranges; /// Avoid double accounting of inspected BC ranges
-  std::vector<o2::dataformats::IRFrame> mBCranges;
+  std::vector<bool> mAccountedBCranges;     /// Avoid double accounting of inspected BC ranges
+  std::vector<uint64_t> mBCrangeMin;        /// Start of the BC ranges, sorted
+  std::vector<uint64_t> mBCrangeMax;        /// End of the BC ranges
+  std::vector<uint64_t> mBCrangeRunningMax; /// Largest end of the BC ranges up to a given index, for the binary search
+  std::vector<std::bitset<128>> mSelMasks;  /// Selection bits per BC range
+  std::vector<uint64_t> mTOImasks;          /// TOI bits per BC range
   std::vector<ZorroHelper>* mZorroHelpers = nullptr;
   std::vector<std::string> mTOIs;
   std::vector<int> mTOIidx;
@@ -16,8 +16,10 @@
 #ifndef PWGCF_FEMTODREAM_CORE_FEMTODREAMDETADPHISTAR_H_
 #define PWGCF_FEMTODREAM_CORE_FEMTODREAMDETADPHISTAR_H_
 
+#include <array>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "PWGCF/DataModel/FemtoDerived.h"
 #include "Framework/HistogramRegistry.h"
@@ -63,6 +65,7 @@ class FemtoDreamDetaDphiStar
     atWhichRadiiToSelect = atWhichRadiiToCut;
     radiiTPC = radiiTPCtoCut;
     fillQA = fillTHSparse;
+    resetPhiStarCache();
 
     if constexpr (mPartOneType == o2::aod::femtodreamparticle::ParticleType::kTrack && (mPartTwoType == o2::aod::femtodreamparticle::ParticleType::kTrack || mPartTwoType == o2::aod::femtodreamparticle::ParticleType::kCascadeV0Child || mPartTwoType == o2::aod::femtodreamparticle::ParticleType::kCascadeBachelor)) {
       std::string dirName = static_cast<std::string>(dirNames[0]);
@@ -135,6 +138,27 @@ class FemtoDreamDetaDphiStar
       }
     }
   }
+  /// Compute phi* once for all particles of a slice, before building their pairs
+  /// Particles which are not stored beforehand (e.g. V0 daughters) are added at their first pair.
+  /// Once used, resetPhiStarCache has to be called whenever the particle indices change meaning
+  /// \param parts particles of the slice
+  /// \param lmagfield magnetic field used afterwards in isClosePair
+  template <typename Parts>
+  void cachePhiStar(Parts const& parts, float lmagfield)
+  {
+    magfield = lmagfield;
+    usePhiStarCache = true;
+    for (const auto& part : parts) {
+      getPhiStar(part);
+    }
+  }
+
+  /// Clear the stored phi*, to be called whenever the indices of the particles change meaning (e.g. new collision or dataframe)
+  void resetPhiStarCache()
+  {
+    mPhiStarCache.clear();
+  }
+
   ///  Check if pair is close or not
   template <typename Part1, typename Part2, typename Parts>
   bool isClosePair(Part1 const& part1, Part2 const& part2, Parts const& particles, float lmagfield, float Q3 = 999.)
@@ -151,7 +175,7 @@ class FemtoDreamDetaDphiStar
       }
       auto deta = part1.eta() - part2.eta();
       auto dphi_AT_PV = part1.phi() - part2.phi();
-      auto dphi_AT_SpecificRadii = PhiAtSpecificRadiiTPC(part1, radiiTPC) - PhiAtSpecificRadiiTPC(part2, radiiTPC);
+      auto dphi_AT_SpecificRadii = getPhiAtSpecificRadii(part1) - getPhiAtSpecificRadii(part2);
       bool sameCharge = false;
       auto dphiAvg = AveragePhiStar(part1, part2, 0, &sameCharge);
       if (Q3 == 999) {
@@ -235,7 +259,7 @@ class FemtoDreamDetaDphiStar
         auto daughter = particles.begin() + indexOfDaughter;
         auto deta = part1.eta() - daughter.eta();
         auto dphi_AT_PV = part1.phi() - daughter.phi();
-        auto dphi_AT_SpecificRadii = PhiAtSpecificRadiiTPC(part1, radiiTPC) - PhiAtSpecificRadiiTPC(daughter, radiiTPC);
+        auto dphi_AT_SpecificRadii = getPhiAtSpecificRadii(part1) - getPhiAtSpecificRadii(*daughter);
         bool sameCharge = false;
         auto dphiAvg = AveragePhiStar(part1, *daughter, i, &sameCharge);
         if (Q3 == 999) {
@@ -315,7 +339,7 @@ class FemtoDreamDetaDphiStar
             daughterPhi = part2.prong0Phi();
             deta = part1.eta() - daughterEta;
             dphi_AT_PV = part1.phi() - daughterPhi;
-            dphi_AT_SpecificRadii = PhiAtSpecificRadiiTPC(part1, radiiTPC) - PhiAtSpecificRadiiTPC<true, 0>(part2, radiiTPC);
+            dphi_AT_SpecificRadii = getPhiAtSpecificRadii(part1) - PhiAtSpecificRadiiTPC<true, 0>(part2, radiiTPC);
             dphiAvg = AveragePhiStar<true>(part1, part2, 0, &sameCharge);
             // histdetadpi[0][0]->Fill(deta, dphiAvg);
             break;
@@ -324,7 +348,7 @@ class FemtoDreamDetaDphiStar
             daughterPhi = part2.prong1Phi();
             deta = part1.eta() - daughterEta;
             dphi_AT_PV = part1.phi() - daughterPhi;
-            dphi_AT_SpecificRadii = PhiAtSpecificRadiiTPC(part1, radiiTPC) - PhiAtSpecificRadiiTPC<true, 1>(part2, radiiTPC);
+            dphi_AT_SpecificRadii = getPhiAtSpecificRadii(part1) - PhiAtSpecificRadiiTPC<true, 1>(part2, radiiTPC);
             dphiAvg = AveragePhiStar<true>(part1, part2, 1, &sameCharge);
             // histdetadpi[1][0]->Fill(deta, dphiAvg);
             break;
@@ -333,7 +357,7 @@ class FemtoDreamDetaDphiStar
             daughterPhi = part2.prong2Phi();
             deta = part1.eta() - daughterEta;
             dphi_AT_PV = part1.phi() - daughterPhi;
-            dphi_AT_SpecificRadii = PhiAtSpecificRadiiTPC(part1, radiiTPC) - PhiAtSpecificRadiiTPC<true, 2>(part2, radiiTPC);
+            dphi_AT_SpecificRadii = getPhiAtSpecificRadii(part1) - PhiAtSpecificRadiiTPC<true, 2>(part2, radiiTPC);
             dphiAvg = AveragePhiStar<true>(part1, part2, 2, &sameCharge);
             // histdetadpi[2][0]->Fill(deta, dphiAvg);
             break;
@@ -414,7 +438,7 @@ class FemtoDreamDetaDphiStar
         auto daughter = particles.begin() + indexOfDaughter;
         auto deta = part1.eta() - daughter.eta();
         auto dphi_AT_PV = part1.phi() - daughter.phi();
-        auto dphi_AT_SpecificRadii = PhiAtSpecificRadiiTPC(part1, radiiTPC) - PhiAtSpecificRadiiTPC(daughter, radiiTPC);
+        auto dphi_AT_SpecificRadii = getPhiAtSpecificRadii(part1) - getPhiAtSpecificRadii(*daughter);
         bool sameCharge = false;
         auto dphiAvg = AveragePhiStar(part1, *daughter, i, &sameCharge);
         if (Q3 == 999) {
@@ -507,7 +531,8 @@ class FemtoDreamDetaDphiStar
   static constexpr o2::aod::femtodreamparticle::ParticleType mPartOneType = partOne; ///< Type of particle 1
   static constexpr o2::aod::femtodreamparticle::ParticleType mPartTwoType = partTwo; ///< Type of particle 2
 
-  static constexpr float tmpRadiiTPC[9] = {85., 105., 125., 145., 165., 185., 205., 225., 245.};
+  static constexpr int NRadiiTPC = 9;
+  static constexpr float tmpRadiiTPC[NRadiiTPC] = {85., 105., 125., 145., 165., 185., 205., 225., 245.};
 
   static constexpr uint32_t kSignMinusMask = 1;
   static constexpr uint32_t kSignPlusMask = 1 << 1;
@@ -531,10 +556,47 @@ class FemtoDreamDetaDphiStar
   std::array<std::shared_ptr<THnSparse>, 3> histdetadpi_eta{};
   std::array<std::shared_ptr<THnSparse>, 3> histdetadpi_phi{};
 
+  /// phi* of a particle, computed once for all the pairs it enters
+  struct PhiStarEntry {
+    float magfield = 0.;                       ///< magnetic field used for the computation
+    int charge = 0;                            ///< charge from the cut container
+    float phiAtSpecificRadii = 0.;             ///< phi* at radiiTPC
+    std::array<float, NRadiiTPC> phiAtRadii{}; ///< phi* at the radii of tmpRadiiTPC
+  };
+  std::unordered_map<int64_t, PhiStarEntry> mPhiStarCache; ///< phi* per global index of the particle
+  bool usePhiStarCache = false;                             ///< store phi*, enabled by cachePhiStar
+
+  /// Get the phi* of a particle, computed on first use if the store is enabled
+  template <typename T>
+  PhiStarEntry getPhiStar(const T& part)
+  {
+    if (usePhiStarCache) {
+      auto cached = mPhiStarCache.find(part.globalIndex());
+      if (cached != mPhiStarCache.end() && cached->second.magfield == magfield) {
+        return cached->second;
+      }
+    }
+    PhiStarEntry entry;
+    entry.magfield = magfield;
+    entry.charge = PhiAtRadiiTPC(part, entry.phiAtRadii);
+    if (usePhiStarCache) {
+      entry.phiAtSpecificRadii = PhiAtSpecificRadiiTPC(part, radiiTPC);
+      mPhiStarCache.insert_or_assign(part.globalIndex(), entry);
+    }
+    return entry;
+  }
+
+  /// Get phi* at radiiTPC, from the store if enabled
+  template <typename T>
+  float getPhiAtSpecificRadii(const T& part)
+  {
+    return usePhiStarCache ? getPhiStar(part).phiAtSpecificRadii : PhiAtSpecificRadiiTPC(part, radiiTPC);
+  }
+
   ///  Calculate phi at all required radii stored in tmpRadiiTPC
   /// Magnetic field to be provided in Tesla
   template <typename T>
-  int PhiAtRadiiTPC(const T& part, std::vector<float>& tmpVec)
+  int PhiAtRadiiTPC(const T& part, std::array<float, NRadiiTPC>& tmpVec)
   {
 
     float phi0 = part.phi();
@@ -551,17 +613,17 @@ class FemtoDreamDetaDphiStar
     }
     // End: Get the charge from cutcontainer using masks
     float pt = part.pt();
-    for (size_t i = 0; i < 9; i++) {
+    for (int i = 0; i < NRadiiTPC; i++) {
       if (runOldVersion) {
-        tmpVec.push_back(phi0 - std::asin(0.3 * charge * 0.1 * magfield * tmpRadiiTPC[i] * 0.01 / (2. * pt)));
+        tmpVec[i] = phi0 - std::asin(0.3 * charge * 0.1 * magfield * tmpRadiiTPC[i] * 0.01 / (2. * pt));
       }
       if (!runOldVersion) {
         auto arg = 0.3 * charge * magfield * tmpRadiiTPC[i] * 0.01 / (2. * pt);
         // for very low pT particles, this value goes outside of range -1 to 1 at at large tpc radius; asin fails
         if (std::fabs(arg) < 1) {
-          tmpVec.push_back(phi0 - std::asin(0.3 * charge * magfield * tmpRadiiTPC[i] * 0.01 / (2. * pt)));
+          tmpVec[i] = phi0 - std::asin(0.3 * charge * magfield * tmpRadiiTPC[i] * 0.01 / (2. * pt));
         } else {
-          tmpVec.push_back(999);
+          tmpVec[i] = 999;
         }
       }
     }
@@ -629,7 +691,7 @@ class FemtoDreamDetaDphiStar
   }
 
   template <typename T>
-  int PhiAtRadiiTPCForHF(const T& part, std::vector<float>& tmpVec, int prong)
+  int PhiAtRadiiTPCForHF(const T& part, std::array<float, NRadiiTPC>& tmpVec, int prong)
   {
     int charge = 0;
     float pt = -999.;
@@ -654,17 +716,17 @@ class FemtoDreamDetaDphiStar
         // Handle invalid prong value
         break;
     }
-    for (size_t i = 0; i < 9; i++) {
+    for (int i = 0; i < NRadiiTPC; i++) {
       if (runOldVersion) {
-        tmpVec.push_back(phi0 - std::asin(0.3 * charge * 0.1 * magfield * tmpRadiiTPC[i] * 0.01 / (2. * pt)));
+        tmpVec[i] = phi0 - std::asin(0.3 * charge * 0.1 * magfield * tmpRadiiTPC[i] * 0.01 / (2. * pt));
       }
       if (!runOldVersion) {
         auto arg = 0.3 * charge * magfield * tmpRadiiTPC[i] * 0.01 / (2. * pt);
         // for very low pT particles, this value goes outside of range -1 to 1 at at large tpc radius; asin fails
         if (std::fabs(arg) < 1) {
-          tmpVec.push_back(phi0 - std::asin(0.3 * charge * magfield * tmpRadiiTPC[i] * 0.01 / (2. * pt)));
+          tmpVec[i] = phi0 - std::asin(0.3 * charge * magfield * tmpRadiiTPC[i] * 0.01 / (2. * pt));
         } else {
-          tmpVec.push_back(999);
+          tmpVec[i] = 999;
         }
       }
     }
@@ -675,25 +737,26 @@ class FemtoDreamDetaDphiStar
   template <bool isHF = false, typename T1, typename T2>
   float AveragePhiStar(const T1& part1, const T2& part2, int iHist, bool* sameCharge)
   {
-    std::vector<float> tmpVec1;
-    std::vector<float> tmpVec2;
-    auto charge1 = PhiAtRadiiTPC(part1, tmpVec1);
+    const auto phiStar1 = getPhiStar(part1);
+    const auto& tmpVec1 = phiStar1.phiAtRadii;
+    std::array<float, NRadiiTPC> tmpVec2;
     if constexpr (!isHF) {
-      auto charge2 = PhiAtRadiiTPC(part2, tmpVec2);
-      if (charge1 == charge2) {
+      const auto phiStar2 = getPhiStar(part2);
+      if (phiStar1.charge == phiStar2.charge) {
         *sameCharge = true;
       }
+      tmpVec2 = phiStar2.phiAtRadii;
     } else {
       PhiAtRadiiTPCForHF(part2, tmpVec2, iHist);
       *sameCharge = true; // always true as we checked the condition in the HF task
     }
-    int num = tmpVec1.size();
+    int num = NRadiiTPC;
     int meaningfulEntries = num;
     float dPhiAvg = 0;
     float dphi;
     for (int i = 0; i < num; i++) {
-      if (tmpVec1.at(i) != 999 && tmpVec2.at(i) != 999) {
-        dphi = tmpVec1.at(i) - tmpVec2.at(i);
+      if (tmpVec1[i] != 999 && tmpVec2[i] != 999) {
+        dphi = tmpVec1[i] - tmpVec2[i];
       } else {
         dphi = 0;
         meaningfulEntries = meaningfulEntries - 1;
@@ -259,6 +259,11 @@ struct femtoDreamPairTaskTrackCascade {
       negChildHistos.fillQA<false, false>(negChild, aod::femtodreamparticle::kPt, col.multNtr(), col.multV0M());
       bachChildHistos.fillQA<false, false>(bachChild, aod::femtodreamparticle::kPt, col.multNtr(), col.multV0M());
     }
+    /// phi* of the cascade daughters is stored at their first pair
+    if (Option.CPROn.value) {
+      pairCloseRejectionSE.resetPhiStarCache();
+      pairCloseRejectionSE.cachePhiStar(SliceTrk1, col.magField());
+    }
     /// Now build particle combinations
     for (auto const& [p1, p2] : combinations(CombinationsFullIndexPolicy(SliceTrk1, SliceCascade2))) {
       const auto& posChild = parts.iteratorAt(p2.index() - 3);
@@ -319,6 +324,7 @@ struct femtoDreamPairTaskTrackCascade {
     // use *Partition.mFiltered when passing the partition to mixing object
     // there is an issue when the partition is passed directly
     // workaround for now, change back once it is fixed
+    pairCloseRejectionME.resetPhiStarCache();
     for (auto const& [collision1, collision2] : soa::selfCombinations(policy, Mixing.Depth.value, -1, cols, cols)) {
       // make sure that tracks in same events are not mixed
       if (collision1.globalIndex() == collision2.globalIndex()) {
@@ -326,6 +332,9 @@ struct femtoDreamPairTaskTrackCascade {
       }
       auto SliceTrk1 = part1->sliceByCached(aod::femtodreamparticle::fdCollisionId, collision1.globalIndex(), cache);
       auto SliceCasc2 = part2->sliceByCached(aod::femtodreamparticle::fdCollisionId, collision2.globalIndex(), cache);
+      if (Option.CPROn.value) {
+        pairCloseRejectionME.cachePhiStar(SliceTrk1, collision1.magField());
+      }
       for (auto& [p1, p2] : combinations(CombinationsFullIndexPolicy(SliceTrk1, SliceCasc2))) {
         const auto& posChild = parts.iteratorAt(p2.index() - 3);
         const auto& negChild = parts.iteratorAt(p2.index() - 2);
@@ -342,6 +342,12 @@ struct femtoDreamPairTaskTrackTrack {
       }
     }
 
+    if (Option.CPROn.value) {
+      pairCloseRejectionSE.resetPhiStarCache();
+      pairCloseRejectionSE.cachePhiStar(SliceTrk1, col.magField());
+      pairCloseRejectionSE.cachePhiStar(SliceTrk2, col.magField());
+    }
+
     /// Now build the combinations
     float rand = 0.;
     if (Option.SameSpecies.value) {
@@ -454,12 +460,17 @@ struct femtoDreamPairTaskTrackTrack {
   template <bool isMC, typename CollisionType, typename PartType, typename PartitionType, typename BinningType>
   void doMixedEvent_NotMasked(CollisionType& cols, PartType& parts, PartitionType& part1, PartitionType& part2, BinningType policy)
   {
+    pairCloseRejectionME.resetPhiStarCache();
     for (auto const& [collision1, collision2] : soa::selfCombinations(policy, Mixing.Depth.value, -1, cols, cols)) {
       auto SliceTrk1 = part1->sliceByCached(aod::femtodreamparticle::fdCollisionId, collision1.globalIndex(), cache);
       auto SliceTrk2 = part2->sliceByCached(aod::femtodreamparticle::fdCollisionId, collision2.globalIndex(), cache);
       if (SliceTrk1.size() == 0 || SliceTrk2.size() == 0) {
         continue;
       }
+      if (Option.CPROn.value) {
+        pairCloseRejectionME.cachePhiStar(SliceTrk1, collision1.magField());
+        pairCloseRejectionME.cachePhiStar(SliceTrk2, collision1.magField());
+      }
       for (auto& [p1, p2] : combinations(CombinationsFullIndexPolicy(SliceTrk1, SliceTrk2))) {
         if (Option.CPROn.value) {
           if (pairCloseRejectionME.isClosePair(p1, p2, parts, collision1.magField())) {
@@ -474,6 +485,7 @@ struct femtoDreamPairTaskTrackTrack {
   template <bool isMC, typename CollisionType, typename PartType, typename PartitionType, typename BinningType>
   void doMixedEvent_Masked(CollisionType& cols, PartType& parts, PartitionType& part1, PartitionType& part2, BinningType policy)
   {
+    pairCloseRejectionME.resetPhiStarCache();
     if (!Option.SameSpecies.value && !Option.MixEventWithPairs.value) {
       // If the two particles are not the same species and the events which are mixed should contain at least one particle of interest, create two paritition of collisions that contain at least one of the two particle of interest and mix them
       // Make sure there is a check that we do not mix a event with itself in case it contains both partilces
@@ -491,6 +503,10 @@ struct femtoDreamPairTaskTrackTrack {
         }
         auto SliceTrk1 = part1->sliceByCached(aod::femtodreamparticle::fdCollisionId, collision1.globalIndex(), cache);
         auto SliceTrk2 = part2->sliceByCached(aod::femtodreamparticle::fdCollisionId, collision2.globalIndex(), cache);
+        if (Option.CPROn.value) {
+          pairCloseRejectionME.cachePhiStar(SliceTrk1, collision1.magField());
+          pairCloseRejectionME.cachePhiStar(SliceTrk2, collision1.magField());
+        }
 
         for (auto& [p1, p2] : combinations(CombinationsFullIndexPolicy(SliceTrk1, SliceTrk2))) {
           if (Option.CPROn.value) {
@@ -509,6 +525,10 @@ struct femtoDreamPairTaskTrackTrack {
         for (auto const& [collision1, collision2] : selfCombinations(policy, Mixing.Depth.value, -1, *partition.mFiltered, *partition.mFiltered)) {
           auto SliceTrk1 = part1->sliceByCached(aod::femtodreamparticle::fdCollisionId, collision1.globalIndex(), cache);
           auto SliceTrk2 = part2->sliceByCached(aod::femtodreamparticle::fdCollisionId, collision2.globalIndex(), cache);
+          if (Option.CPROn.value) {
+            pairCloseRejectionME.cachePhiStar(SliceTrk1, collision1.magField());
+            pairCloseRejectionME.cachePhiStar(SliceTrk2, collision1.magField());
+          }
           for (auto& [p1, p2] : combinations(CombinationsFullIndexPolicy(SliceTrk1, SliceTrk2))) {
             if (Option.CPROn.value) {
               if (pairCloseRejectionME.isClosePair(p1, p2, parts, collision1.magField())) {
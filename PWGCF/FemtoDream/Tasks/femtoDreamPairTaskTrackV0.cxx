@@ -330,6 +330,11 @@ struct femtoDreamPairTaskTrackV0 {
         negChildHistos.fillQA<false, false>(negChild, aod::femtodreamparticle::kPt, col.multNtr(), col.multV0M());
       }
     }
+    /// phi* of the V0 daughters is stored at their first pair
+    if (Option.CPROn.value) {
+      pairCloseRejectionSE.resetPhiStarCache();
+      pairCloseRejectionSE.cachePhiStar(SliceTrk1, col.magField());
+    }
     /// Now build particle combinations
     for (auto const& [p1, p2] : combinations(CombinationsFullIndexPolicy(SliceTrk1, SliceV02))) {
       const auto& posChild = parts.iteratorAt(p2.index() - 2);
@@ -379,6 +384,7 @@ struct femtoDreamPairTaskTrackV0 {
   template <bool isMC, typename CollisionType, typename PartType, typename PartitionType, typename BinningType>
   void doMixedEvent_Masked(CollisionType const& cols, PartType const& parts, PartitionType& part1, PartitionType& part2, BinningType policy)
   {
+    pairCloseRejectionME.resetPhiStarCache();
 
     if (Option.MixEventWithPairs.value) {
       Partition<CollisionType> PartitionMaskedCol = ncheckbit(aod::femtodreamcollision::bitmaskTrackOne, BitMask) && ncheckbit(aod::femtodreamcollision::bitmaskTrackTwo, BitMask) && aod::femtodreamcollision::downsample == true;
@@ -393,6 +399,9 @@ struct femtoDreamPairTaskTrackV0 {
         }
         auto SliceTrk1 = part1->sliceByCached(aod::femtodreamparticle::fdCollisionId, collision1.globalIndex(), cache);
         auto SliceV02 = part2->sliceByCached(aod::femtodreamparticle::fdCollisionId, collision2.globalIndex(), cache);
+        if (Option.CPROn.value) {
+          pairCloseRejectionME.cachePhiStar(SliceTrk1, collision1.magField());
+        }
         for (auto& [p1, p2] : combinations(CombinationsFullIndexPolicy(SliceTrk1, SliceV02))) {
           const auto& posChild = parts.iteratorAt(p2.index() - 2);
           const auto& negChild = parts.iteratorAt(p2.index() - 1);
@@ -430,6 +439,9 @@ struct femtoDreamPairTaskTrackV0 {
         }
         auto SliceTrk1 = part1->sliceByCached(aod::femtodreamparticle::fdCollisionId, collision1.globalIndex(), cache);
         auto SliceV02 = part2->sliceByCached(aod::femtodreamparticle::fdCollisionId, collision2.globalIndex(), cache);
+        if (Option.CPROn.value) {
+          pairCloseRejectionME.cachePhiStar(SliceTrk1, collision1.magField());
+        }
         for (auto& [p1, p2] : combinations(CombinationsFullIndexPolicy(SliceTrk1, SliceV02))) {
           const auto& posChild = parts.iteratorAt(p2.index() - 2);
           const auto& negChild = parts.iteratorAt(p2.index() - 1);
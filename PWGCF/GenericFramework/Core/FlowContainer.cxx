@@ -142,6 +142,12 @@ int FlowContainer::FillProfile(const char* hname, double multi, double corr, dou
     printf("Could not find bin %s\n", hname);
     return -1;
   }
+  return FillProfile(yin, multi, corr, w, rn);
+};
+int FlowContainer::FillProfile(int yin, double multi, double corr, double w, double rn)
+{
+  if (!fProf || yin < 1)
+    return -1;
   fProf->Fill(multi, yin, corr, w);
   if (fNRandom) {
     double rnind = rn * fNRandom;
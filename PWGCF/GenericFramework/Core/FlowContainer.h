@@ -51,6 +51,8 @@ class FlowContainer : public TNamed
   int GetNMultiBins() { return fProf->GetNbinsX(); }
   double GetMultiAtBin(int bin) { return fProf->GetXaxis()->GetBinCenter(bin); }
   int FillProfile(const char* hname, double multi, double y, double w, double rn);
+  int FillProfile(int yBin, double multi, double y, double w, double rn); // yBin as returned by GetProfileBin, to avoid label lookup per fill
+  int GetProfileBin(const char* hname) { return fProf ? fProf->GetYaxis()->FindBin(hname) : 0; }
   TProfile2D* GetProfile() { return fProf; }
   void OverrideProfileErrors(TProfile2D* inpf);
   void ReadAndMerge(const char* infile);
@@ -96,11 +96,13 @@ int GFW::CreateRegions()
   }
   if (nRegions)
     fInitialized = true;
+  fCorrCacheValid = false;
   return nRegions;
 };
 void GFW::Fill(double eta, int ptin, double phi, double weight, int mask, double SecondWeight)
 {
   // if(!fInitialized) return;
+  fCorrCacheValid = false;
   for (int i = 0; i < static_cast<int>(fRegions.size()); ++i) {
     if (fRegions.at(i).EtaMin < eta && fRegions.at(i).EtaMax > eta && (fRegions.at(i).BitMask & mask))
       fCumulants.at(i).FillArray(ptin, phi, weight, SecondWeight);
@@ -116,10 +118,26 @@ complex<double> GFW::TwoRec(int n1, int n2, int p1, int p2, int ptbin, GFWCumula
 };
 complex<double> GFW::RecursiveCorr(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumulant* qol, int ptbin, vector<int>& hars)
 {
-  vector<int> pows;
-  for (int i = 0; i < static_cast<int>(hars.size()); i++)
-    pows.push_back(1);
-  return RecursiveCorr(qpoi, qref, qol, ptbin, hars, pows);
+  fPowsBuf.assign(hars.size(), 1);
+  return RecursiveCorr(qpoi, qref, qol, ptbin, hars, fPowsBuf);
+};
+const vector<int>& GFW::CorrKey(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumulant* qol, int ptbin, const vector<int>& hars, const vector<int>& pows)
+{
+  fCorrKey.clear();
+  fCorrKey.push_back(static_cast<int>(qpoi - fCumulants.data()));
+  fCorrKey.push_back(static_cast<int>(qref - fCumulants.data()));
+  fCorrKey.push_back(qol ? static_cast<int>(qol - fCumulants.data()) : -1);
+  fCorrKey.push_back(ptbin);
+  fCorrKey.insert(fCorrKey.end(), hars.begin(), hars.end());
+  fCorrKey.insert(fCorrKey.end(), pows.begin(), pows.end());
+  return fCorrKey;
+};
+void GFW::ValidateCorrCache()
+{
+  if (fCorrCacheValid)
+    return;
+  fCorrCache.clear();
+  fCorrCacheValid = true;
 };
 
 complex<double> GFW::RecursiveCorr(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumulant* qol, int ptbin, vector<int>& hars, vector<int>& pows)
@@ -131,6 +149,10 @@ complex<double> GFW::RecursiveCorr(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumu
     return qpoi->Vec(hars.at(0), pows.at(0), ptbin);
   if (hars.size() < 3)
     return TwoRec(hars.at(0), hars.at(1), pows.at(0), pows.at(1), ptbin, qpoi, qref, qol);
+  // Higher orders are memoised, as the same terms show up in the recursion of many configs
+  auto cached = fCorrCache.find(CorrKey(qpoi, qref, qol, ptbin, hars, pows));
+  if (cached != fCorrCache.end())
+    return cached->second;
   int harlast = hars.at(hars.size() - 1);
   int powlast = pows.at(pows.size() - 1);
   hars.erase(hars.end() - 1);
@@ -160,6 +182,7 @@ complex<double> GFW::RecursiveCorr(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumu
   }
   hars.push_back(harlast);
   pows.push_back(powlast);
+  fCorrCache.emplace(CorrKey(qpoi, qref, qol, ptbin, hars, pows), formula);
   return formula;
 };
 void GFW::Clear()
@@ -168,6 +191,7 @@ void GFW::Clear()
     CreateRegions();
   for (auto ptr = fCumulants.begin(); ptr != fCumulants.end(); ++ptr)
     ptr->ResetQs();
+  fCorrCacheValid = false;
 };
 GFW::CorrConfig GFW::GetCorrelatorConfig(string config, string head, bool ptdif)
 {
@@ -258,9 +282,10 @@ complex<double> GFW::Calculate(int poi, int ref, vector<int> hars, int ptbin)
   GFWCumulant* qref = &fCumulants.at(ref);
   GFWCumulant* qpoi = &fCumulants.at(poi);
   GFWCumulant* qovl = qpoi;
+  ValidateCorrCache();
   return RecursiveCorr(qpoi, qref, qovl, ptbin, hars);
 };
-complex<double> GFW::Calculate(CorrConfig corconf, int ptbin, bool SetHarmsToZero)
+complex<double> GFW::Calculate(const CorrConfig& corconf, int ptbin, bool SetHarmsToZero)
 {
   // if(!fInitialized) return complex<double>(0,0); //First check if initialised, if not -- initialize, and if it fails, return
   if (corconf.Regs.size() == 0)
@@ -296,15 +321,31 @@ complex<double> GFW::Calculate(CorrConfig corconf, int ptbin, bool SetHarmsToZer
       qovl = &fCumulants.at(ovl);
     else if (ref == poi)
       qovl = qref; // If ref and poi are the same, then the same is for overlap. Only, when OL not explicitly defined
-    if (SetHarmsToZero) {
-      for (int j = 0; j < static_cast<int>(corconf.Hars.at(i).size()); j++) {
-        corconf.Hars.at(i).at(j) = 0;
-      }
-    }
-    retval *= RecursiveCorr(qpoi, qref, qovl, ptInd, corconf.Hars.at(i));
+    if (SetHarmsToZero)
+      fHarsBuf.assign(corconf.Hars.at(i).size(), 0);
+    else
+      fHarsBuf.assign(corconf.Hars.at(i).begin(), corconf.Hars.at(i).end());
+    ValidateCorrCache();
+    retval *= RecursiveCorr(qpoi, qref, qovl, ptInd, fHarsBuf);
   }
   return retval;
 };
+void GFW::Calculate(const vector<CorrConfig>& configs, int nPtBins, vector<complex<double>>& dn, vector<complex<double>>& val)
+{
+  int nResults = 0;
+  for (const CorrConfig& corconf : configs)
+    nResults += corconf.pTDif ? nPtBins : 1;
+  dn.resize(nResults);
+  val.resize(nResults);
+  int iRes = 0;
+  for (const CorrConfig& corconf : configs) {
+    int nBins = corconf.pTDif ? nPtBins : 1;
+    for (int ptbin = 0; ptbin < nBins; ptbin++, iRes++) {
+      dn[iRes] = Calculate(corconf, ptbin, true);
+      val[iRes] = (dn[iRes] == complex<double>(0, 0)) ? complex<double>(0, 0) : Calculate(corconf, ptbin, false);
+    }
+  }
+};
 vector<pair<int, vector<int>>> GFW::GetHarmonicsSingleConfig(const CorrConfig& incfg)
 {
   vector<pair<int, vector<int>>> retPair;
@@ -341,6 +382,7 @@ void GFW::InitializePowerArrays()
 complex<double> GFW::Calculate(int poi, vector<int> hars)
 {
   GFWCumulant* qpoi = &fCumulants.at(poi);
+  ValidateCorrCache();
   return RecursiveCorr(qpoi, qpoi, qpoi, 0, hars);
 };
 int GFW::FindRegionByName(string refName)
@@ -26,6 +26,8 @@ If used, modified, or distributed, please aknowledge the author of this code.
 #include <utility>
 #include <algorithm>
 #include <complex>
+#include <functional>
+#include <unordered_map>
 
 class GFW
 {
@@ -65,12 +67,32 @@ class GFW
   void Clear();
   GFWCumulant GetCumulant(int index) { return fCumulants.at(index); }
   CorrConfig GetCorrelatorConfig(std::string config, std::string head = "", bool ptdif = false);
-  std::complex<double> Calculate(CorrConfig corconf, int ptbin, bool SetHarmsToZero);
+  std::complex<double> Calculate(const CorrConfig& corconf, int ptbin, bool SetHarmsToZero);
+  // Evaluates all configs for the current event. For each config (and each of nPtBins bins if pT-differential), the denominator
+  // (harmonics set to zero) and the correlator are stored consecutively in dn and val; sub-terms shared between configs are computed once
+  void Calculate(const std::vector<CorrConfig>& configs, int nPtBins, std::vector<std::complex<double>>& dn, std::vector<std::complex<double>>& val);
   void InitializePowerArrays();
 
  protected:
   bool fInitialized;
   std::vector<CorrConfig> fListOfCFGs;
+  // Per-event memo of recursive terms, keyed by (poi, ref, overlap, pT bin, harmonics, powers). Invalidated by Fill() and Clear()
+  struct CorrKeyHash {
+    std::size_t operator()(const std::vector<int>& key) const
+    {
+      std::size_t seed = key.size();
+      for (const int& k : key)
+        seed ^= std::hash<int>{}(k) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      return seed;
+    }
+  };
+  std::unordered_map<std::vector<int>, std::complex<double>, CorrKeyHash> fCorrCache; //! cache of the recursive correlators of the current event
+  std::vector<int> fCorrKey;                                                            //! key buffer, reused for lookups
+  std::vector<int> fHarsBuf;                                                            //! harmonics of the current subevent
+  std::vector<int> fPowsBuf;                                                            //! unit powers of the current subevent
+  bool fCorrCacheValid = false;                                                         //! whether fCorrCache belongs to the current event
+  void ValidateCorrCache();
+  const std::vector<int>& CorrKey(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumulant* qol, int ptbin, const std::vector<int>& hars, const std::vector<int>& pows);
   std::complex<double> TwoRec(int n1, int n2, int p1, int p2, int ptbin, GFWCumulant*, GFWCumulant*, GFWCumulant*);
   std::complex<double> RecursiveCorr(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumulant* qol, int ptbin, std::vector<int>& hars, std::vector<int>& pows); // POI, Ref. flow, overlapping region
   std::complex<double> RecursiveCorr(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumulant* qol, int ptbin, std::vector<int>& hars);                         // POI, Ref. flow, overlapping region
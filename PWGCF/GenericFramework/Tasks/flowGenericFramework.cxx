@@ -161,6 +161,10 @@ struct FlowGenericFramework {
   // define global variables
   GFW* fGFW = new GFW();
   std::vector<GFW::CorrConfig> corrconfigs;
+  std::vector<std::complex<double>> corrDenominators; // per config and pT bin, filled once per event
+  std::vector<std::complex<double>> corrValues;
+  std::vector<int> profileBins; // y-bins of the FlowContainer profile, same ordering as corrValues
+  std::vector<int> profileBinsGen;
   TRandom3* fRndm = new TRandom3(0);
   TAxis* fPtAxis;
   int lastRun = -1;
@@ -298,11 +302,13 @@ struct FlowGenericFramework {
       fFC->SetName("FlowContainer");
       fFC->SetXAxis(fPtAxis);
       fFC->Initialize(oba, multAxis, cfgNbootstrap);
+      resolveProfileBins(fFC.object.get(), profileBins);
     }
     if (doprocessMCGen) {
       fFCgen->SetName("FlowContainer_gen");
       fFCgen->SetXAxis(fPtAxis);
       fFCgen->Initialize(oba, multAxis, cfgNbootstrap);
+      resolveProfileBins(fFCgen.object.get(), profileBinsGen);
     }
     delete oba;
     fFCpt->setUseCentralMoments(cfgUseCentralMoments);
@@ -363,6 +369,19 @@ struct FlowGenericFramework {
     }
   }
 
+  void resolveProfileBins(FlowContainer* fc, std::vector<int>& bins)
+  {
+    bins.clear();
+    for (const auto& corrconf : corrconfigs) {
+      if (!corrconf.pTDif) {
+        bins.push_back(fc->GetProfileBin(corrconf.Head.c_str()));
+        continue;
+      }
+      for (int i = 1; i <= fPtAxis->GetNbins(); i++)
+        bins.push_back(fc->GetProfileBin(Form("%s_pt_%i", corrconf.Head.c_str(), i)));
+    }
+  }
+
   int getMagneticField(uint64_t timestamp)
   {
     // TODO done only once (and not per run). Will be replaced by CCDBConfigurable
@@ -674,26 +693,30 @@ struct FlowGenericFramework {
     fFCpt->fillCMProfiles(centmult, rndm);
     if (!cfgUseGapMethod)
       fFCpt->fillVnPtStdProfiles(centmult, rndm);
+    fGFW->Calculate(corrconfigs, fPtAxis->GetNbins(), corrDenominators, corrValues);
+    const auto& bins = (dt == kGen) ? profileBinsGen : profileBins;
+    uint iRes = 0;
     for (uint l_ind = 0; l_ind < corrconfigs.size(); ++l_ind) {
       if (!corrconfigs.at(l_ind).pTDif) {
-        auto dnx = fGFW->Calculate(corrconfigs.at(l_ind), 0, kTRUE).real();
+        const uint res = iRes++;
+        auto dnx = corrDenominators[res].real();
         if (dnx == 0)
           continue;
-        auto val = fGFW->Calculate(corrconfigs.at(l_ind), 0, kFALSE).real() / dnx;
+        auto val = corrValues[res].real() / dnx;
         if (std::abs(val) < 1) {
-          (dt == kGen) ? fFCgen->FillProfile(corrconfigs.at(l_ind).Head.c_str(), centmult, val, dnx, rndm) : fFC->FillProfile(corrconfigs.at(l_ind).Head.c_str(), centmult, val, dnx, rndm);
+          (dt == kGen) ? fFCgen->FillProfile(bins[res], centmult, val, dnx, rndm) : fFC->FillProfile(bins[res], centmult, val, dnx, rndm);
           if (cfgUseGapMethod)
             fFCpt->fillVnPtProfiles(centmult, val, dnx, rndm, configs.GetpTCorrMasks()[l_ind]);
         }
         continue;
       }
-      for (int i = 1; i <= fPtAxis->GetNbins(); i++) {
-        auto dnx = fGFW->Calculate(corrconfigs.at(l_ind), i - 1, kTRUE).real();
+      for (int i = 1; i <= fPtAxis->GetNbins(); i++, iRes++) {
+        auto dnx = corrDenominators[iRes].real();
         if (dnx == 0)
           continue;
-        auto val = fGFW->Calculate(corrconfigs.at(l_ind), i - 1, kFALSE).real() / dnx;
+        auto val = corrValues[iRes].real() / dnx;
         if (std::abs(val) < 1)
-          (dt == kGen) ? fFCgen->FillProfile(Form("%s_pt_%i", corrconfigs.at(l_ind).Head.c_str(), i), centmult, val, dnx, rndm) : fFC->FillProfile(Form("%s_pt_%i", corrconfigs.at(l_ind).Head.c_str(), i), centmult, val, dnx, rndm);
+          (dt == kGen) ? fFCgen->FillProfile(bins[iRes], centmult, val, dnx, rndm) : fFC->FillProfile(bins[iRes], centmult, val, dnx, rndm);
       }
     }
     return;
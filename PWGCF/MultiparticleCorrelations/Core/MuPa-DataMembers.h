@@ -345,6 +345,25 @@ struct InternalValidation {
   int fMultRangeInternalValidation[2] = {0, 0};       // min and max values for uniform multiplicity distribution in on-the-fly analysis (convention: min <= M < max)
 } iv;
 
+// *) Test0 correlator plan, compiled once from labels in CompileTest0Plan():
+struct Test0PlanTerm { // coefficient * Q(harmonic, power) * value of the child node (or 1 if there is no child)
+  double fCoefficient = 0.;
+  int fHarmonic = 0;
+  int fPower = 0;
+  int fChild = -1;
+};
+struct Test0PlanNode { // generic correlator for one sorted set of harmonics, as a sum of terms
+  int fFirstTerm = 0;
+  int fNTerms = 0;
+};
+struct Test0PlanCorrelator { // one requested correlator, with its harmonics parsed from the label
+  int fOrder = 0;
+  int fIndex = 0;
+  int fHarmonics[gMaxCorrelator] = {0};
+  int fNode = -1;
+  int fWeightNode = -1;
+};
+
 // *) Test0:
 struct Test0 {
   TList* fTest0List = NULL;                                                     // list to hold all objects for Test0
@@ -357,6 +376,11 @@ struct Test0 {
   bool fUseDefaultLabels = false;                                               // use default labels hardwired in GetDefaultObjArrayWithLabels(), the choice is made with cfWhichDefaultLabels
   TString fWhichDefaultLabels = "";                                             // only for testing purposes, select one set of default labels, see GetDefaultObjArrayWithLabels for supported options
   TH1I* fTest0LabelsPlaceholder = NULL;                                         // store all Test0 labels in this histogram
+  bool fPlanCompiled = false;                                                   // plan below was compiled from labels
+  std::vector<Test0PlanTerm> fPlanTerms;                                        //! all terms, grouped per node
+  std::vector<Test0PlanNode> fPlanNodes;                                        //! all nodes, sub-correlators always precede the correlators using them
+  std::vector<Test0PlanCorrelator> fPlanCorrelators;                            //! requested correlators, ordered as [order][index]
+  std::vector<TComplex> fPlanValues;                                            //! value of each node in the current event (or kine bin)
 } t0;                                                                           // "t0" labels an instance of this group of histograms
 
 // *) Eta separations:
@@ -5884,7 +5884,8 @@ void BookTest0Histograms()
   // b) Book placeholder and make sure all labels are stored in the placeholder;
   // c) Retrieve labels from placeholder;
   // d) Book what needs to be booked;
-  // e) Few quick insanity checks on booking.
+  // e) Few quick insanity checks on booking;
+  // f) Compile the plan to evaluate all requested correlators.
 
   if (tc.fVerbose) {
     StartFunction(__FUNCTION__);
@@ -5979,6 +5980,9 @@ void BookTest0Histograms()
     LOGF(fatal, "\033[1;31m%s at line %d\033[0m", __FUNCTION__, __LINE__); // ordering in enum eAsFunctionOf is not the same as in TString fResultsProXaxisTitle[eAsFunctionOf_N]
   }
 
+  // f) Compile the plan to evaluate all requested correlators:
+  this->CompileTest0Plan();
+
   if (tc.fVerbose) {
     ExitFunction(__FUNCTION__);
   }
@@ -9818,37 +9822,82 @@ void CalculateKineCorrelations(eAsFunctionOf AFO_variable)
 
 //============================================================
 
-void CalculateTest0()
+int CompileTest0PlanNode(std::vector<int> harmonics, std::map<std::vector<int>, int>& nodeIds)
 {
-  // Calculate Test0.
+  // Return the index of the plan node for the generic correlator with the given harmonics, compiling first the node and all its sub-correlators if needed.
+
+  // Remark 1: The generic correlator is expanded over the set partitions of its harmonics, by summing over the block which contains the last harmonic:
+  //             N(n_1,...,n_k) = sum_{B, k in B} (-1)^(|B|-1) (|B|-1)! Q(sum_{i in B} n_i, |B|) N({n_i, i not in B}),
+  //           which is the same expansion as in Recursion() and One(), Two(), ..., Six().
+  // Remark 2: Generic correlator is symmetric under permutations of harmonics, therefore nodes are keyed by sorted harmonics. This way, the same
+  //           sub-correlators (e.g. all the ones in the weights, with all harmonics set to 0) are shared among all requested correlators.
+
+  std::sort(harmonics.begin(), harmonics.end());
+  auto node = nodeIds.find(harmonics);
+  if (node != nodeIds.end()) {
+    return node->second;
+  }
+
+  // Terms with the same Q-vector and the same sub-correlator (from repeated harmonics) are merged:
+  std::map<std::tuple<int, int, int>, double> terms; // [harmonic, power, child] => coefficient
+  const int last = harmonics.size() - 1;
+  for (int mask = 0; mask < (1 << last); mask++) {
+    int harmonic = harmonics[last];
+    int power = 1;
+    std::vector<int> rest;
+    for (int i = 0; i < last; i++) {
+      if (mask & (1 << i)) {
+        harmonic += harmonics[i];
+        power++;
+      } else {
+        rest.push_back(harmonics[i]);
+      }
+    }
+    int child = rest.empty() ? -1 : CompileTest0PlanNode(rest, nodeIds); // sub-correlators get smaller indices than this node
+    terms[std::make_tuple(harmonic, power, child)] += (power % 2 == 1 ? 1. : -1.) * TMath::Factorial(power - 1);
+  }
 
-  // a) Flush 'n' fill the generic Q-vectors;
-  // b) Calculate correlations;
-  // c) Flush the generic Q-vectors.
+  Test0PlanNode planNode;
+  planNode.fFirstTerm = t0.fPlanTerms.size();
+  planNode.fNTerms = terms.size();
+  for (const auto& [key, coefficient] : terms) {
+    Test0PlanTerm term;
+    term.fCoefficient = coefficient;
+    term.fHarmonic = std::get<0>(key);
+    term.fPower = std::get<1>(key);
+    term.fChild = std::get<2>(key);
+    t0.fPlanTerms.push_back(term);
+  }
+  t0.fPlanNodes.push_back(planNode);
+  nodeIds[harmonics] = t0.fPlanNodes.size() - 1;
+
+  return t0.fPlanNodes.size() - 1;
+
+} // int CompileTest0PlanNode(std::vector<int> harmonics, std::map<std::vector<int>, int>& nodeIds)
+
+//============================================================
+
+void CompileTest0Plan()
+{
+  // Compile the plan to evaluate all Test0 correlators (and their weights) from Q-vectors. This is done only once, so that labels
+  // are not parsed again in each event, and sub-correlators shared by different correlators are evaluated only once per event.
+
+  // a) Sanitize the labels (If necessary. Locally this is irrelevant);
+  // b) Extract harmonics from labels and compile the nodes for each correlator and its weight.
 
   if (tc.fVerbose) {
     StartFunction(__FUNCTION__);
   }
 
-  // a) Flush 'n' fill the generic Q-vectors:
-  ResetQ();
-  for (int h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
-    for (int wp = 0; wp < gMaxCorrelator + 1; wp++) // weight power
-    {
-      qv.fQ[h][wp] = qv.fQvector[h][wp];
-    }
-  }
-
-  // b) Calculate correlations:
-  double correlation = 0.; // still has to be divided with 'weight' later, to get average correlation
-  double weight = 0.;
-  int n[gMaxCorrelator] = {0}; // array holding harmonics
+  t0.fPlanTerms.clear();
+  t0.fPlanNodes.clear();
+  t0.fPlanCorrelators.clear();
+  std::map<std::vector<int>, int> nodeIds; // sorted harmonics => index of node in t0.fPlanNodes
 
   for (int mo = 0; mo < gMaxCorrelator; mo++) {
     for (int mi = 0; mi < gMaxIndex; mi++) {
-      // TBI 20210913 I do not have to loop each time all the way up to gMaxCorrelator and gMaxIndex, but nevermind now, it's not a big efficiency loss.
 
-      // Sanitize the labels (If necessary. Locally this is irrelevant):
+      // a) Sanitize the labels (If necessary. Locally this is irrelevant):
       if (!t0.fTest0Labels[mo][mi]) // I do not stream them.
       {
         for (int v = 0; v < eAsFunctionOf_N; v++) {
@@ -9858,193 +9907,166 @@ void CalculateTest0()
           }
         }
       } // if(!t0_afTest0Labels[mo][mi])
+      if (!t0.fTest0Labels[mo][mi]) {
+        continue;
+      }
 
-      if (t0.fTest0Labels[mo][mi]) {
-        // Extract harmonics from TString, FS is " ":
-        for (int h = 0; h <= mo; h++) {
-          TObjArray* oa = t0.fTest0Labels[mo][mi]->Tokenize(" ");
-          if (!oa) {
-            LOGF(fatal, "\033[1;31m%s at line %d\033[0m", __FUNCTION__, __LINE__);
-          }
-          n[h] = TString(oa->At(h)->GetName()).Atoi();
-          delete oa; // yes, otherwise it's a memory leak
-        }
+      // b) Extract harmonics from TString, FS is " ":
+      Test0PlanCorrelator correlator;
+      correlator.fOrder = mo + 1;
+      correlator.fIndex = mi;
+      TObjArray* oa = t0.fTest0Labels[mo][mi]->Tokenize(" ");
+      if (!oa || oa->GetEntries() < mo + 1) {
+        LOGF(fatal, "\033[1;31m%s at line %d : t0.fTest0Labels[mo][mi]->Data() = %s\033[0m", __FUNCTION__, __LINE__, t0.fTest0Labels[mo][mi]->Data());
+      }
+      for (int h = 0; h <= mo; h++) {
+        correlator.fHarmonics[h] = TString(oa->At(h)->GetName()).Atoi();
+      }
+      delete oa; // yes, otherwise it's a memory leak
 
-        switch (mo + 1) // which order? yes, mo+1
-        {
-          case 1:
-            if (ebye.fSelectedTracks < 1) {
-              return;
-            }
-            correlation = One(n[0]).Re();
-            weight = One(0).Re();
-            break;
+      correlator.fNode = CompileTest0PlanNode(std::vector<int>(correlator.fHarmonics, correlator.fHarmonics + mo + 1), nodeIds);
+      correlator.fWeightNode = CompileTest0PlanNode(std::vector<int>(mo + 1, 0), nodeIds);
+      t0.fPlanCorrelators.push_back(correlator);
+    } // for(int mi=0;mi<gMaxIndex;mi++)
+  } // for(int mo=0;mo<gMaxCorrelator;mo++)
 
-          case 2:
-            if (ebye.fSelectedTracks < 2) {
-              return;
-            }
-            correlation = Two(n[0], n[1]).Re();
-            weight = Two(0, 0).Re();
-            break;
+  t0.fPlanValues.resize(t0.fPlanNodes.size());
+  t0.fPlanCompiled = true;
+  LOGF(info, "\033[1;32m%s : %zu correlators compiled into %zu nodes with %zu terms\033[0m", __FUNCTION__, t0.fPlanCorrelators.size(), t0.fPlanNodes.size(), t0.fPlanTerms.size());
 
-          case 3:
-            if (ebye.fSelectedTracks < 3) {
-              return;
-            }
-            correlation = Three(n[0], n[1], n[2]).Re();
-            weight = Three(0, 0, 0).Re();
-            break;
+  if (tc.fVerbose) {
+    ExitFunction(__FUNCTION__);
+  }
 
-          case 4:
-            if (ebye.fSelectedTracks < 4) {
-              return;
-            }
-            correlation = Four(n[0], n[1], n[2], n[3]).Re();
-            weight = Four(0, 0, 0, 0).Re();
-            break;
+} // void CompileTest0Plan()
 
-          case 5:
-            if (ebye.fSelectedTracks < 5) {
-              return;
-            }
-            correlation = Five(n[0], n[1], n[2], n[3], n[4]).Re();
-            weight = Five(0, 0, 0, 0, 0).Re();
-            break;
+//============================================================
 
-          case 6:
-            if (ebye.fSelectedTracks < 6) {
-              return;
-            }
-            correlation = Six(n[0], n[1], n[2], n[3], n[4], n[5]).Re();
-            weight = Six(0, 0, 0, 0, 0, 0).Re();
-            break;
+void EvaluateTest0Plan(const TComplex (*q)[gMaxCorrelator + 1])
+{
+  // Evaluate all nodes of the Test0 plan for the given Q-vectors, e.g. qv.fQvector or qv.fqvector[qvKine][bin], and store their values in t0.fPlanValues.
+  // Nodes are ordered so that sub-correlators are always evaluated before the correlators using them.
 
-          case 7:
-            if (ebye.fSelectedTracks < 7) {
-              return;
-            }
-            correlation = Seven(n[0], n[1], n[2], n[3], n[4], n[5], n[6]).Re();
-            weight = Seven(0, 0, 0, 0, 0, 0, 0).Re();
-            break;
+  for (std::size_t node = 0; node < t0.fPlanNodes.size(); node++) {
+    TComplex value(0., 0.);
+    const Test0PlanTerm* term = t0.fPlanTerms.data() + t0.fPlanNodes[node].fFirstTerm;
+    for (int t = 0; t < t0.fPlanNodes[node].fNTerms; t++, term++) {
+      // Using the fact that Q{-n,p} = Q{n,p}^*, like in Q(int n, int wp):
+      TComplex qTerm = term->fHarmonic >= 0 ? q[term->fHarmonic][term->fPower] : TComplex::Conjugate(q[-term->fHarmonic][term->fPower]);
+      if (term->fChild >= 0) {
+        qTerm *= t0.fPlanValues[term->fChild];
+      }
+      value += term->fCoefficient * qTerm;
+    }
+    t0.fPlanValues[node] = value;
+  }
 
-          case 8:
-            if (ebye.fSelectedTracks < 8) {
-              return;
-            }
-            correlation = Eight(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7]).Re();
-            weight = Eight(0, 0, 0, 0, 0, 0, 0, 0).Re();
-            break;
+} // void EvaluateTest0Plan(const TComplex (*q)[gMaxCorrelator + 1])
 
-          case 9:
-            if (ebye.fSelectedTracks < 9) {
-              return;
-            }
-            correlation = Nine(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8]).Re();
-            weight = Nine(0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
-            break;
+//============================================================
 
-          case 10:
-            if (ebye.fSelectedTracks < 10) {
-              return;
-            }
-            correlation = Ten(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9]).Re();
-            weight = Ten(0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
-            break;
+void CalculateTest0()
+{
+  // Calculate Test0.
 
-          case 11:
-            if (ebye.fSelectedTracks < 11) {
-              return;
-            }
-            correlation = Eleven(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9], n[10]).Re();
-            weight = Eleven(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
-            break;
+  // a) Evaluate the plan on the integrated Q-vectors;
+  // b) Calculate correlations.
 
-          case 12:
-            if (ebye.fSelectedTracks < 12) {
-              return;
-            }
-            correlation = Twelve(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9], n[10], n[11]).Re();
-            weight = Twelve(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
-            break;
+  // Remark: The plan is evaluated directly on qv.fQvector, so the generic Q-vectors qv.fQ are not used here.
 
-          default:
-            LOGF(fatal, "\033[1;31m%s at line %d : Not supported yet: t0.fTest0Labels[mo][mi]->Data() = %s\033[0m", __FUNCTION__, __LINE__, t0.fTest0Labels[mo][mi]->Data());
-        } // switch(mo+1)
+  if (tc.fVerbose) {
+    StartFunction(__FUNCTION__);
+  }
 
-        // Insanity check on weight:
-        if (!(weight > 0.)) {
-          LOGF(fatal, "\033[1;31m%s at line %d : weight = %f => Is perhaps order of correlator bigger than the number of particles? t0.fTest0Labels[mo][mi]->Data() = %s \033[0m", __FUNCTION__, __LINE__, weight, t0.fTest0Labels[mo][mi]->Data());
-        }
+  // a) Evaluate the plan on the integrated Q-vectors:
+  if (!t0.fPlanCompiled) {
+    this->CompileTest0Plan();
+  }
+  this->EvaluateTest0Plan(qv.fQvector);
 
-        // e-b-e sanity check:
-        if (nl.fCalculateCustomNestedLoops) {
-          TArrayI* harmonics = new TArrayI(mo + 1);
-          for (int i = 0; i < mo + 1; i++) {
-            harmonics->SetAt(n[i], i);
-          }
-          double nestedLoopValue = this->CalculateCustomNestedLoops(harmonics);
-          if (!(TMath::Abs(nestedLoopValue) > 0.)) {
-            LOGF(info, "  ebye check (integrated) with CustomNestedLoops was NOT calculated for %d-p Test0 corr. %s", mo + 1, t0.fTest0Labels[mo][mi]->Data());
-          } else if (TMath::Abs(nestedLoopValue) > 0. && TMath::Abs(correlation / weight - nestedLoopValue) > tc.fFloatingPointPrecision) {
-            LOGF(fatal, "\033[1;31m%s at line %d : nestedLoopValue = %f is not the same as correlation/weight = %f, for correlator %s\033[0m", __FUNCTION__, __LINE__, nestedLoopValue, correlation / weight, t0.fTest0Labels[mo][mi]->Data());
-          } else {
-            LOGF(info, "\033[1;32m ebye check (integrated) with CustomNestedLoops is OK for %d-p Test0 corr. %s\033[0m", mo + 1, t0.fTest0Labels[mo][mi]->Data());
-          }
-          delete harmonics;
-          harmonics = NULL;
-        } // if(nl.fCalculateCustomNestedLoops)
-
-        // To ease comparison, rescale with theoretical value. Now all Test0 results shall be at 1. Remember that contribution from symmetry planes is here also relevant (in general):
-        if (iv.fUseInternalValidation && iv.fRescaleWithTheoreticalInput && iv.fInternalValidationVnPsin[eVn] && iv.fInternalValidationVnPsin[ePsin]) {
-          TArrayI* harmonics = new TArrayI(mo + 1);
-          for (int i = 0; i < mo + 1; i++) {
-            harmonics->SetAt(n[i], i);
-          }
-          TComplex theoreticalValue = this->TheoreticalValue(harmonics, iv.fInternalValidationVnPsin[eVn], iv.fInternalValidationVnPsin[ePsin]);
-          if (TMath::Abs(theoreticalValue.Re()) > 0.) {
-            correlation /= theoreticalValue.Re();
-          }
-          // TBI 20240424 for the time being, I do not do anything with imaginary part, but I could eventually...
-          delete harmonics;
-          harmonics = NULL;
-        } // if(fUseInternalValidation && fRescaleWithTheoreticalInput)
+  // b) Calculate correlations:
+  double correlation = 0.; // still has to be divided with 'weight' later, to get average correlation
+  double weight = 0.;
 
-        // Finally, fill:
-        // integrated:
-        if (t0.fTest0Pro[mo][mi][AFO_INTEGRATED]) {
-          t0.fTest0Pro[mo][mi][AFO_INTEGRATED]->Fill(0.5, correlation / weight, weight);
-        }
-        // vs. multiplicity:
-        if (t0.fTest0Pro[mo][mi][AFO_MULTIPLICITY]) {
-          t0.fTest0Pro[mo][mi][AFO_MULTIPLICITY]->Fill(ebye.fMultiplicity + 0.5, correlation / weight, weight);
-        }
-        // vs. centrality:
-        if (t0.fTest0Pro[mo][mi][AFO_CENTRALITY]) {
-          t0.fTest0Pro[mo][mi][AFO_CENTRALITY]->Fill(ebye.fCentrality, correlation / weight, weight);
-        }
-        // vs. occupancy:
-        if (t0.fTest0Pro[mo][mi][AFO_OCCUPANCY]) {
-          t0.fTest0Pro[mo][mi][AFO_OCCUPANCY]->Fill(ebye.fOccupancy, correlation / weight, weight);
-        }
-        // vs. interaction rate:
-        if (t0.fTest0Pro[mo][mi][AFO_INTERACTIONRATE]) {
-          t0.fTest0Pro[mo][mi][AFO_INTERACTIONRATE]->Fill(ebye.fInteractionRate, correlation / weight, weight);
-        }
-        // vs. current run duration:
-        if (t0.fTest0Pro[mo][mi][AFO_CURRENTRUNDURATION]) {
-          t0.fTest0Pro[mo][mi][AFO_CURRENTRUNDURATION]->Fill(ebye.fCurrentRunDuration, correlation / weight, weight);
-        }
-        // vs. vertex z position:
-        if (t0.fTest0Pro[mo][mi][AFO_VZ]) {
-          t0.fTest0Pro[mo][mi][AFO_VZ]->Fill(ebye.fVz, correlation / weight, weight);
-        }
-      } // if(t0.fTest0Labels[mo][mi])
-    } // for(int mi=0;mi<gMaxIndex;mi++)
-  } // for(int mo=0;mo<gMaxCorrelator;mo++)
+  for (const auto& correlator : t0.fPlanCorrelators) {
+    const int mo = correlator.fOrder - 1;
+    const int mi = correlator.fIndex;
+    const int* n = correlator.fHarmonics; // array holding harmonics
 
-  // c) Flush the generic Q-vectors:
-  ResetQ();
+    if (ebye.fSelectedTracks < mo + 1) {
+      break; // correlators are sorted by order, so none of the remaining ones can be calculated either
+    }
+    correlation = t0.fPlanValues[correlator.fNode].Re();
+    weight = t0.fPlanValues[correlator.fWeightNode].Re();
+
+    // Insanity check on weight:
+    if (!(weight > 0.)) {
+      LOGF(fatal, "\033[1;31m%s at line %d : weight = %f => Is perhaps order of correlator bigger than the number of particles? t0.fTest0Labels[mo][mi]->Data() = %s \033[0m", __FUNCTION__, __LINE__, weight, t0.fTest0Labels[mo][mi]->Data());
+    }
+
+    // e-b-e sanity check:
+    if (nl.fCalculateCustomNestedLoops) {
+      TArrayI* harmonics = new TArrayI(mo + 1);
+      for (int i = 0; i < mo + 1; i++) {
+        harmonics->SetAt(n[i], i);
+      }
+      double nestedLoopValue = this->CalculateCustomNestedLoops(harmonics);
+      if (!(TMath::Abs(nestedLoopValue) > 0.)) {
+        LOGF(info, "  ebye check (integrated) with CustomNestedLoops was NOT calculated for %d-p Test0 corr. %s", mo + 1, t0.fTest0Labels[mo][mi]->Data());
+      } else if (TMath::Abs(nestedLoopValue) > 0. && TMath::Abs(correlation / weight - nestedLoopValue) > tc.fFloatingPointPrecision) {
+        LOGF(fatal, "\033[1;31m%s at line %d : nestedLoopValue = %f is not the same as correlation/weight = %f, for correlator %s\033[0m", __FUNCTION__, __LINE__, nestedLoopValue, correlation / weight, t0.fTest0Labels[mo][mi]->Data());
+      } else {
+        LOGF(info, "\033[1;32m ebye check (integrated) with CustomNestedLoops is OK for %d-p Test0 corr. %s\033[0m", mo + 1, t0.fTest0Labels[mo][mi]->Data());
+      }
+      delete harmonics;
+      harmonics = NULL;
+    } // if(nl.fCalculateCustomNestedLoops)
+
+    // To ease comparison, rescale with theoretical value. Now all Test0 results shall be at 1. Remember that contribution from symmetry planes is here also relevant (in general):
+    if (iv.fUseInternalValidation && iv.fRescaleWithTheoreticalInput && iv.fInternalValidationVnPsin[eVn] && iv.fInternalValidationVnPsin[ePsin]) {
+      TArrayI* harmonics = new TArrayI(mo + 1);
+      for (int i = 0; i < mo + 1; i++) {
+        harmonics->SetAt(n[i], i);
+      }
+      TComplex theoreticalValue = this->TheoreticalValue(harmonics, iv.fInternalValidationVnPsin[eVn], iv.fInternalValidationVnPsin[ePsin]);
+      if (TMath::Abs(theoreticalValue.Re()) > 0.) {
+        correlation /= theoreticalValue.Re();
+      }
+      // TBI 20240424 for the time being, I do not do anything with imaginary part, but I could eventually...
+      delete harmonics;
+      harmonics = NULL;
+    } // if(fUseInternalValidation && fRescaleWithTheoreticalInput)
+
+    // Finally, fill:
+    // integrated:
+    if (t0.fTest0Pro[mo][mi][AFO_INTEGRATED]) {
+      t0.fTest0Pro[mo][mi][AFO_INTEGRATED]->Fill(0.5, correlation / weight, weight);
+    }
+    // vs. multiplicity:
+    if (t0.fTest0Pro[mo][mi][AFO_MULTIPLICITY]) {
+      t0.fTest0Pro[mo][mi][AFO_MULTIPLICITY]->Fill(ebye.fMultiplicity + 0.5, correlation / weight, weight);
+    }
+    // vs. centrality:
+    if (t0.fTest0Pro[mo][mi][AFO_CENTRALITY]) {
+      t0.fTest0Pro[mo][mi][AFO_CENTRALITY]->Fill(ebye.fCentrality, correlation / weight, weight);
+    }
+    // vs. occupancy:
+    if (t0.fTest0Pro[mo][mi][AFO_OCCUPANCY]) {
+      t0.fTest0Pro[mo][mi][AFO_OCCUPANCY]->Fill(ebye.fOccupancy, correlation / weight, weight);
+    }
+    // vs. interaction rate:
+    if (t0.fTest0Pro[mo][mi][AFO_INTERACTIONRATE]) {
+      t0.fTest0Pro[mo][mi][AFO_INTERACTIONRATE]->Fill(ebye.fInteractionRate, correlation / weight, weight);
+    }
+    // vs. current run duration:
+    if (t0.fTest0Pro[mo][mi][AFO_CURRENTRUNDURATION]) {
+      t0.fTest0Pro[mo][mi][AFO_CURRENTRUNDURATION]->Fill(ebye.fCurrentRunDuration, correlation / weight, weight);
+    }
+    // vs. vertex z position:
+    if (t0.fTest0Pro[mo][mi][AFO_VZ]) {
+      t0.fTest0Pro[mo][mi][AFO_VZ]->Fill(ebye.fVz, correlation / weight, weight);
+    }
+  } // for (const auto& correlator : t0.fPlanCorrelators)
 
   if (tc.fVerbose) {
     ExitFunction(__FUNCTION__);
@@ -10088,6 +10110,11 @@ void CalculateKineTest0(eAsFunctionOf AFO_variable)
     LOGF(fatal, "\033[1;31m%s at line %d : qvKine == eqvectorKine_N => add some more entries to the case statement \033[0m", __FUNCTION__, __LINE__);
   }
 
+  // *) Make sure the correlator plan is available (it is normally compiled already when booking):
+  if (!t0.fPlanCompiled) {
+    this->CompileTest0Plan();
+  }
+
   // *) Uniform loop over bin for all kine variables:
   for (int b = 0; b < nBins; b++) {
 
@@ -10098,164 +10125,82 @@ void CalculateKineTest0(eAsFunctionOf AFO_variable)
       }
     }
 
-    // *) Re-initialize Q-vector to be q-vector in this bin:
-    // After that, I can call all standard Q-vector functions again:
-    for (int h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
-      for (int wp = 0; wp < gMaxCorrelator + 1; wp++) { // weight power
-        qv.fQ[h][wp] = qv.fqvector[qvKine][b][h][wp];
-      }
-    }
+    // *) Evaluate the plan directly on the q-vector in this bin:
+    this->EvaluateTest0Plan(qv.fqvector[qvKine][b]);
 
     // *) Okay, let's do the differential calculus:
     double correlation = 0.;
     double weight = 0.;
-    int n[gMaxCorrelator] = {0}; // array holding harmonics
-
-    for (int mo = 0; mo < gMaxCorrelator; mo++) {
-      for (int mi = 0; mi < gMaxIndex; mi++) {
-        // TBI 20240221 I do not have to loop each time all the way up to gMaxCorrelator and gMaxIndex, but nevermind now, it's not a big efficiency loss.
-        if (t0.fTest0Labels[mo][mi]) {
-          // Extract harmonics from TString, FS is " ":
-          for (int h = 0; h <= mo; h++) {
-            // cout<<Form("h = %d, t0.fTest0Labels[%d][%d] = ",h,mo,mi)<<t0.fTest0Labels[mo][mi]->Data()<<endl;
-            TObjArray* oa = t0.fTest0Labels[mo][mi]->Tokenize(" ");
-            if (!oa) {
-              LOGF(fatal, "\033[1;31m%s at line %d\033[0m", __FUNCTION__, __LINE__);
-            }
-            n[h] = TString(oa->At(h)->GetName()).Atoi();
-            delete oa; // yes, otherwise it's a memory leak
-          }
 
-          if (qv.fqVectorEntries[qvKine][b] < mo + 1) {
-            continue;
-          }
+    for (const auto& correlator : t0.fPlanCorrelators) {
+      const int mo = correlator.fOrder - 1;
+      const int mi = correlator.fIndex;
+      const int* n = correlator.fHarmonics; // array holding harmonics
 
-          switch (mo + 1) // which order? yes, mo+1
-          {
-            case 1:
-              correlation = One(n[0]).Re();
-              weight = One(0).Re();
-              break;
-
-            case 2:
-              correlation = Two(n[0], n[1]).Re();
-              weight = Two(0, 0).Re();
-              break;
-
-            case 3:
-              correlation = Three(n[0], n[1], n[2]).Re();
-              weight = Three(0, 0, 0).Re();
-              break;
-
-            case 4:
-              correlation = Four(n[0], n[1], n[2], n[3]).Re();
-              weight = Four(0, 0, 0, 0).Re();
-              break;
-
-            case 5:
-              correlation = Five(n[0], n[1], n[2], n[3], n[4]).Re();
-              weight = Five(0, 0, 0, 0, 0).Re();
-              break;
-
-            case 6:
-              correlation = Six(n[0], n[1], n[2], n[3], n[4], n[5]).Re();
-              weight = Six(0, 0, 0, 0, 0, 0).Re();
-              break;
-
-            case 7:
-              correlation = Seven(n[0], n[1], n[2], n[3], n[4], n[5], n[6]).Re();
-              weight = Seven(0, 0, 0, 0, 0, 0, 0).Re();
-              break;
-
-            case 8:
-              correlation = Eight(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7]).Re();
-              weight = Eight(0, 0, 0, 0, 0, 0, 0, 0).Re();
-              break;
-
-            case 9:
-              correlation = Nine(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8]).Re();
-              weight = Nine(0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
-              break;
-
-            case 10:
-              correlation = Ten(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9]).Re();
-              weight = Ten(0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
-              break;
-
-            case 11:
-              correlation = Eleven(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9], n[10]).Re();
-              weight = Eleven(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
-              break;
-
-            case 12:
-              correlation = Twelve(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9], n[10], n[11]).Re();
-              weight = Twelve(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
-              break;
-
-            default:
-              LOGF(fatal, "\033[1;31m%s at line %d : not supported yet: %s \n\n\033[0m", __FUNCTION__, __LINE__, t0.fTest0Labels[mo][mi]->Data());
-          } // switch(mo+1)
-
-          // *) e-b-e sanity check:
-          if (nl.fCalculateKineCustomNestedLoops) {
-            TArrayI* harmonics = new TArrayI(mo + 1);
-            for (int i = 0; i < mo + 1; i++) {
-              harmonics->SetAt(n[i], i);
-            }
-            if (!(weight > 0.)) {
-              LOGF(fatal, "\033[1;31m%s at line %d : is perhaps order of some requested correlator bigger than the number of particles? Correlator = %s \033[0m", __FUNCTION__, __LINE__, t0.fTest0Labels[mo][mi]->Data());
-            }
-            double nestedLoopValue = this->CalculateKineCustomNestedLoops(harmonics, AFO_variable, b);
-            if (!(TMath::Abs(nestedLoopValue) > 0.)) {
-              LOGF(info, "  e-b-e check with CalculateKineCustomNestedLoops was NOT calculated for %d-p Test0 corr. %s, bin = %d", mo + 1, t0.fTest0Labels[mo][mi]->Data(), b + 1);
-            } else if (TMath::Abs(nestedLoopValue) > 0. && TMath::Abs(correlation / weight - nestedLoopValue) > tc.fFloatingPointPrecision) {
-              LOGF(fatal, "\033[1;31m%s at line %d : correlator: %s \n correlation: %f \n custom loop: %f \033[0m", __FUNCTION__, __LINE__, t0.fTest0Labels[mo][mi]->Data(), correlation / weight, nestedLoopValue);
-            } else {
-              LOGF(info, "\033[1;32m ebye check (differential) with CalculateKineCustomNestedLoops is OK for %d-p Test0 corr. %s, bin = %d\033[0m", mo + 1, t0.fTest0Labels[mo][mi]->Data(), b + 1);
-            }
-            delete harmonics;
-            harmonics = NULL;
-          } // if(nl.fCalculateKineCustomNestedLoops)
-
-          // To ease comparison, rescale with theoretical value. Now all Test0 results shall be at 1:
-          if (iv.fUseInternalValidation && iv.fRescaleWithTheoreticalInput && iv.fInternalValidationVnPsin[eVn] && iv.fInternalValidationVnPsin[ePsin]) {
-            TArrayI* harmonics = new TArrayI(mo + 1);
-            for (int i = 0; i < mo + 1; i++) {
-              harmonics->SetAt(n[i], i);
-            }
-            TComplex theoreticalValue = TheoreticalValue(harmonics, iv.fInternalValidationVnPsin[eVn], iv.fInternalValidationVnPsin[ePsin]);
-            if (TMath::Abs(theoreticalValue.Re()) > 0.) {
-              correlation /= theoreticalValue.Re();
-            }
-            // TBI 20240424 for the time being, I do not do anything with imaginary part, but I could eventually...
-            delete harmonics;
-            harmonics = NULL;
-          } // if(fUseInternalValidation && fRescaleWithTheoreticalInput)
-
-          // Insanity check for the event weight:
-          if (!(weight > 0.)) {
-            // If it's negative, that means that sum of particle weights is smaller than "number of particles - 1"
-            // In that case, you can simply rescale all particle weights, so that each of them is > 1, basically recalculate weights.root files with such a rescaling.
-            LOGF(info, "\n\033[1;33m b = %d \033[0m\n", b);
-            LOGF(info, "\n\033[1;33m qvKine = %d \033[0m\n", static_cast<int>(qvKine));
-            LOGF(info, "\n\033[1;33m event weight = %e \033[0m\n", weight);
-            LOGF(info, "\n\033[1;33m sum of particle weights = %e \033[0m\n", One(0).Re());
-            LOGF(info, "\n\033[1;33m correlation = %f \033[0m\n", correlation);
-            LOGF(info, "\n\033[1;33m t0.fTest0Pro[mo][mi][AFO_variable]->GetTitle() = %s \033[0m\n", t0.fTest0Pro[mo][mi][AFO_variable]->GetTitle());
-            LOGF(info, "\n\033[1;33m [mo][mi][AFO_variable] = [%d][%d][%d] \033[0m\n", mo, mi, static_cast<int>(AFO_variable));
-            LOGF(info, "\n\033[1;33m ebye.fSelectedTracks = %d \033[0m\n", ebye.fSelectedTracks);
-            LOGF(info, "\n\033[1;33m qv.fqVectorEntries[qvKine][b] = %d \033[0m\n", qv.fqVectorEntries[qvKine][b]);
-            LOGF(fatal, "\033[1;31m%s at line %d\033[0m", __FUNCTION__, __LINE__);
-          }
+      if (qv.fqVectorEntries[qvKine][b] < mo + 1) {
+        continue;
+      }
+      correlation = t0.fPlanValues[correlator.fNode].Re();
+      weight = t0.fPlanValues[correlator.fWeightNode].Re();
+
+      // *) e-b-e sanity check:
+      if (nl.fCalculateKineCustomNestedLoops) {
+        TArrayI* harmonics = new TArrayI(mo + 1);
+        for (int i = 0; i < mo + 1; i++) {
+          harmonics->SetAt(n[i], i);
+        }
+        if (!(weight > 0.)) {
+          LOGF(fatal, "\033[1;31m%s at line %d : is perhaps order of some requested correlator bigger than the number of particles? Correlator = %s \033[0m", __FUNCTION__, __LINE__, t0.fTest0Labels[mo][mi]->Data());
+        }
+        double nestedLoopValue = this->CalculateKineCustomNestedLoops(harmonics, AFO_variable, b);
+        if (!(TMath::Abs(nestedLoopValue) > 0.)) {
+          LOGF(info, "  e-b-e check with CalculateKineCustomNestedLoops was NOT calculated for %d-p Test0 corr. %s, bin = %d", mo + 1, t0.fTest0Labels[mo][mi]->Data(), b + 1);
+        } else if (TMath::Abs(nestedLoopValue) > 0. && TMath::Abs(correlation / weight - nestedLoopValue) > tc.fFloatingPointPrecision) {
+          LOGF(fatal, "\033[1;31m%s at line %d : correlator: %s \n correlation: %f \n custom loop: %f \033[0m", __FUNCTION__, __LINE__, t0.fTest0Labels[mo][mi]->Data(), correlation / weight, nestedLoopValue);
+        } else {
+          LOGF(info, "\033[1;32m ebye check (differential) with CalculateKineCustomNestedLoops is OK for %d-p Test0 corr. %s, bin = %d\033[0m", mo + 1, t0.fTest0Labels[mo][mi]->Data(), b + 1);
+        }
+        delete harmonics;
+        harmonics = NULL;
+      } // if(nl.fCalculateKineCustomNestedLoops)
+
+      // To ease comparison, rescale with theoretical value. Now all Test0 results shall be at 1:
+      if (iv.fUseInternalValidation && iv.fRescaleWithTheoreticalInput && iv.fInternalValidationVnPsin[eVn] && iv.fInternalValidationVnPsin[ePsin]) {
+        TArrayI* harmonics = new TArrayI(mo + 1);
+        for (int i = 0; i < mo + 1; i++) {
+          harmonics->SetAt(n[i], i);
+        }
+        TComplex theoreticalValue = TheoreticalValue(harmonics, iv.fInternalValidationVnPsin[eVn], iv.fInternalValidationVnPsin[ePsin]);
+        if (TMath::Abs(theoreticalValue.Re()) > 0.) {
+          correlation /= theoreticalValue.Re();
+        }
+        // TBI 20240424 for the time being, I do not do anything with imaginary part, but I could eventually...
+        delete harmonics;
+        harmonics = NULL;
+      } // if(fUseInternalValidation && fRescaleWithTheoreticalInput)
+
+      // Insanity check for the event weight:
+      if (!(weight > 0.)) {
+        // If it's negative, that means that sum of particle weights is smaller than "number of particles - 1"
+        // In that case, you can simply rescale all particle weights, so that each of them is > 1, basically recalculate weights.root files with such a rescaling.
+        LOGF(info, "\n\033[1;33m b = %d \033[0m\n", b);
+        LOGF(info, "\n\033[1;33m qvKine = %d \033[0m\n", static_cast<int>(qvKine));
+        LOGF(info, "\n\033[1;33m event weight = %e \033[0m\n", weight);
+        LOGF(info, "\n\033[1;33m sum of particle weights = %e \033[0m\n", qv.fqvector[qvKine][b][0][1].Re());
+        LOGF(info, "\n\033[1;33m correlation = %f \033[0m\n", correlation);
+        LOGF(info, "\n\033[1;33m t0.fTest0Pro[mo][mi][AFO_variable]->GetTitle() = %s \033[0m\n", t0.fTest0Pro[mo][mi][AFO_variable]->GetTitle());
+        LOGF(info, "\n\033[1;33m [mo][mi][AFO_variable] = [%d][%d][%d] \033[0m\n", mo, mi, static_cast<int>(AFO_variable));
+        LOGF(info, "\n\033[1;33m ebye.fSelectedTracks = %d \033[0m\n", ebye.fSelectedTracks);
+        LOGF(info, "\n\033[1;33m qv.fqVectorEntries[qvKine][b] = %d \033[0m\n", qv.fqVectorEntries[qvKine][b]);
+        LOGF(fatal, "\033[1;31m%s at line %d\033[0m", __FUNCTION__, __LINE__);
+      }
 
-          // Finally, fill:
-          if (t0.fTest0Pro[mo][mi][AFO_variable]) {
-            t0.fTest0Pro[mo][mi][AFO_variable]->Fill(t0.fTest0Pro[mo][mi][AFO_variable]->GetXaxis()->GetBinCenter(b + 1), correlation / weight, weight);
-          } // fill in the bin center
+      // Finally, fill:
+      if (t0.fTest0Pro[mo][mi][AFO_variable]) {
+        t0.fTest0Pro[mo][mi][AFO_variable]->Fill(t0.fTest0Pro[mo][mi][AFO_variable]->GetXaxis()->GetBinCenter(b + 1), correlation / weight, weight);
+      } // fill in the bin center
 
-        } // if(fTest0Labels[mo][mi])
-      } // for(int mi=0;mi<gMaxIndex;mi++)
-    } // for(int mo=0;mo<gMaxCorrelator;mo++)
+    } // for (const auto& correlator : t0.fPlanCorrelators)
 
   } // for(int b=0;b<nBins;b++)
 
@@ -84,6 +84,12 @@ using TracksRec_QA = TracksRec;    // if I would need additional tables for QA,
 #include <TF3.h>
 #include <TObjString.h>
 #include <THnSparse.h>
+
+// *) Standard library:
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <vector>
 using namespace std;
 
 // *) Enums:
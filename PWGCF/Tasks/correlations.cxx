@@ -14,6 +14,7 @@
 /// \author Jan Fiete Grosse-Oetringhaus <jan.fiete.grosse-oetringhaus@cern.ch>, Jasper Parkkila <jasper.parkkila@cern.ch>
 
 #include <experimental/type_traits>
+#include <chrono>
 #include <vector>
 #include <string>
 
@@ -90,7 +91,7 @@ struct CorrelationTask {
 
   O2_DEFINE_CONFIGURABLE(cfgNoMixedEvents, int, 5, "Number of mixed events per event")
 
-  O2_DEFINE_CONFIGURABLE(cfgVerbosity, int, 1, "Verbosity level (0 = major, 1 = per collision)")
+  O2_DEFINE_CONFIGURABLE(cfgVerbosity, int, 1, "Verbosity level (0 = major, 1 = per collision, 2 = pair-fill throughput)")
 
   O2_DEFINE_CONFIGURABLE(cfgDecayParticleMask, int, 0, "Selection bitmask for the decay particles: 0 = no selection")
   O2_DEFINE_CONFIGURABLE(cfgMassAxis, int, 0, "Use invariant mass axis (0 = OFF, 1 = ON)")
@@ -137,6 +138,20 @@ struct CorrelationTask {
   std::vector<float> efficiencyAssociatedCache;
   std::vector<int> p2indexCache;
 
+  // per-event cache of the associated particles, filled once instead of for every trigger particle
+  struct AssociatedCache {
+    float pt;
+    float eta;
+    float phi;
+    bool selected;   // passes the selections which do not depend on the trigger particle
+    int8_t passedML; // ML selection, evaluated on first use in the pair loop: -1 not yet, 0 fails, 1 passes
+  };
+  std::vector<AssociatedCache> associatedCache;
+
+  // pair-fill throughput, reported with cfgVerbosity > 1
+  uint64_t nPairsFilled = 0;
+  double pairFillTime = 0; // ms
+
   struct Config {
     bool mPairCuts = false;
     THn* mEfficiencyTrigger = nullptr;
@@ -219,6 +234,7 @@ struct CorrelationTask {
 
     if (!cfgEfficiencyAssociated.value.empty())
       efficiencyAssociatedCache.reserve(512);
+    associatedCache.reserve(512);
     if (doprocessMCEfficiency2Prong) {
       p2indexCache.reserve(16);
       if (cfgMcTriggerPDGs->empty())
@@ -381,9 +397,36 @@ struct CorrelationTask {
   template <class T>
   using HasMlProbD0 = decltype(std::declval<T&>().mlProbD0());
 
+  /// Fills the per-event cache of the associated particles: kinematics and selections independent of the trigger particle
+  template <CorrelationContainer::CFStep step, typename TTracks2>
+  void fillAssociatedCache(TTracks2& tracks2)
+  {
+    associatedCache.clear();
+    associatedCache.reserve(tracks2.size());
+    for (const auto& track2 : tracks2) {
+      bool selected = true;
+      if constexpr (step <= CorrelationContainer::kCFStepTracked) {
+        selected = selected && checkObject<step>(track2);
+      }
+      if constexpr (std::experimental::is_detected<HasPDGCode, typename TTracks2::iterator>::value) {
+        selected = selected && (cfgMcTriggerPDGs->empty() || std::find(cfgMcTriggerPDGs->begin(), cfgMcTriggerPDGs->end(), track2.pdgCode()) == cfgMcTriggerPDGs->end());
+      }
+      if constexpr (std::experimental::is_detected<HasDecay, typename TTracks2::iterator>::value) {
+        selected = selected && (cfgDecayParticleMask == 0 || (cfgDecayParticleMask & (1u << static_cast<uint32_t>(track2.decay()))) != 0u);
+      }
+      if constexpr (std::experimental::is_detected<HasSign, typename TTracks2::iterator>::value) {
+        selected = selected && (cfgAssociatedCharge == 0 || cfgAssociatedCharge * track2.sign() >= 0);
+      }
+      associatedCache.push_back({track2.pt(), track2.eta(), track2.phi(), selected, -1});
+    }
+  }
+
   template <CorrelationContainer::CFStep step, typename TTarget, typename TTracks1, typename TTracks2>
   void fillCorrelations(TTarget target, TTracks1& tracks1, TTracks2& tracks2, float multiplicity, float posZ, int magField, float eventWeight)
   {
+    auto start = std::chrono::steady_clock::now();
+    uint64_t nPairs = 0;
+
     // Cache efficiency for particles (too many FindBin lookups)
     if constexpr (step == CorrelationContainer::kCFStepCorrected) {
       if (cfg.mEfficiencyAssociated) {
@@ -394,6 +437,10 @@ struct CorrelationTask {
         }
       }
     }
+    fillAssociatedCache<step>(tracks2);
+
+    const bool fillTwoMassAxes = cfgMassAxis && (doprocessSame2Prong2Prong || doprocessMixed2Prong2Prong || doprocessSame2Prong2ProngML || doprocessMixed2Prong2ProngML) && !(doprocessSame2ProngDerived || doprocessSame2ProngDerivedML || doprocessMixed2ProngDerived || doprocessMixed2ProngDerivedML);
+    const bool fillMassAxis = cfgMassAxis;
 
     for (const auto& track1 : tracks1) {
       // LOGF(info, "Track %f | %f | %f  %d %d", track1.eta(), track1.phi(), track1.pt(), track1.isGlobalTrack(), track1.isGlobalTrackSDD());
@@ -441,17 +488,23 @@ struct CorrelationTask {
         target->getTriggerHist()->Fill(step, track1.pt(), multiplicity, posZ, triggerWeight);
       }
 
+      const float pt1 = track1.pt();
+      const float eta1 = track1.eta();
+      const float phi1 = track1.phi();
+
+      int iAssociated = 0;
       for (const auto& track2 : tracks2) {
+        auto& associated = associatedCache[iAssociated++];
+        // checkObject, MC PDG code, decay mask and associated charge selections
+        if (!associated.selected) {
+          continue;
+        }
         if constexpr (std::is_same<TTracks1, TTracks2>::value) {
           if (track1.globalIndex() == track2.globalIndex()) {
             // LOGF(info, "Track identical: %f | %f | %f || %f | %f | %f", track1.eta(), track1.phi(), track1.pt(),  track2.eta(), track2.phi(), track2.pt());
             continue;
           }
         }
-        if constexpr (std::experimental::is_detected<HasPDGCode, typename TTracks2::iterator>::value) {
-          if (!cfgMcTriggerPDGs->empty() && std::find(cfgMcTriggerPDGs->begin(), cfgMcTriggerPDGs->end(), track2.pdgCode()) != cfgMcTriggerPDGs->end())
-            continue;
-        }
 
         if constexpr (std::experimental::is_detected<HasProng0Id, typename TTracks1::iterator>::value) {
           if (track2.globalIndex() == track1.cfTrackProng0Id()) // do not correlate daughter tracks of the same event
@@ -462,17 +515,6 @@ struct CorrelationTask {
             continue;
         }
 
-        if constexpr (step <= CorrelationContainer::kCFStepTracked) {
-          if (!checkObject<step>(track2)) {
-            continue;
-          }
-        }
-
-        if constexpr (std::experimental::is_detected<HasDecay, typename TTracks2::iterator>::value) {
-          if (cfgDecayParticleMask != 0 && (cfgDecayParticleMask & (1u << static_cast<uint32_t>(track2.decay()))) == 0u)
-            continue;
-        }
-
         if constexpr (std::experimental::is_detected<HasDecay, typename TTracks1::iterator>::value && std::experimental::is_detected<HasDecay, typename TTracks2::iterator>::value) {
           if (cfgCorrelationMethod == 1 && track1.decay() != track2.decay())
             continue;
@@ -506,16 +548,10 @@ struct CorrelationTask {
           }
         } // no shared prong for two mothers
 
-        if (cfgPtOrder != 0 && track2.pt() >= track1.pt()) {
+        if (cfgPtOrder != 0 && associated.pt >= pt1) {
           continue;
         }
 
-        if constexpr (std::experimental::is_detected<HasSign, typename TTracks2::iterator>::value) {
-          if (cfgAssociatedCharge != 0 && cfgAssociatedCharge * track2.sign() < 0) {
-            continue;
-          }
-        }
-
         if constexpr (std::experimental::is_detected<HasSign, typename TTracks1::iterator>::value && std::experimental::is_detected<HasSign, typename TTracks2::iterator>::value) {
           if (cfgPairCharge != 0 && cfgPairCharge * track1.sign() * track2.sign() < 0) {
             continue;
@@ -542,29 +578,42 @@ struct CorrelationTask {
           }
         }
 
-        float deltaPhi = RecoDecay::constrainAngle(track1.phi() - track2.phi(), -o2::constants::math::PIHalf);
+        float deltaPhi = RecoDecay::constrainAngle(phi1 - associated.phi, -o2::constants::math::PIHalf);
 
         if constexpr (std::experimental::is_detected<HasMlProbD0, typename TTracks2::iterator>::value) {
-          if ((doprocessSame2ProngDerivedML || doprocessSame2Prong2ProngML || doprocessMixed2ProngDerivedML || doprocessMixed2Prong2ProngML) && !passMLScore(track2))
-            continue;
+          if (doprocessSame2ProngDerivedML || doprocessSame2Prong2ProngML || doprocessMixed2ProngDerivedML || doprocessMixed2Prong2ProngML) {
+            if (associated.passedML < 0) {
+              associated.passedML = passMLScore(track2);
+            }
+            if (!associated.passedML)
+              continue;
+          }
         } // ML selection
 
         // last param is the weight
-        if (cfgMassAxis && (doprocessSame2Prong2Prong || doprocessMixed2Prong2Prong || doprocessSame2Prong2ProngML || doprocessMixed2Prong2ProngML) && !(doprocessSame2ProngDerived || doprocessSame2ProngDerivedML || doprocessMixed2ProngDerived || doprocessMixed2ProngDerivedML)) {
+        if (fillTwoMassAxes) {
           if constexpr (std::experimental::is_detected<HasInvMass, typename TTracks1::iterator>::value && std::experimental::is_detected<HasInvMass, typename TTracks2::iterator>::value)
-            target->getPairHist()->Fill(step, track1.eta() - track2.eta(), track2.pt(), track1.pt(), multiplicity, deltaPhi, posZ, track2.invMass(), track1.invMass(), associatedWeight);
+            target->getPairHist()->Fill(step, eta1 - associated.eta, associated.pt, pt1, multiplicity, deltaPhi, posZ, track2.invMass(), track1.invMass(), associatedWeight);
           else
             LOGF(fatal, "Can not fill mass axis without invMass column. \n no mass for two particles");
-        } else if (cfgMassAxis) {
+        } else if (fillMassAxis) {
           if constexpr (std::experimental::is_detected<HasInvMass, typename TTracks1::iterator>::value)
-            target->getPairHist()->Fill(step, track1.eta() - track2.eta(), track2.pt(), track1.pt(), multiplicity, deltaPhi, posZ, track1.invMass(), associatedWeight);
+            target->getPairHist()->Fill(step, eta1 - associated.eta, associated.pt, pt1, multiplicity, deltaPhi, posZ, track1.invMass(), associatedWeight);
           else
             LOGF(fatal, "Can not fill mass axis without invMass column. Disable cfgMassAxis.");
         } else {
-          target->getPairHist()->Fill(step, track1.eta() - track2.eta(), track2.pt(), track1.pt(), multiplicity, deltaPhi, posZ, associatedWeight);
+          target->getPairHist()->Fill(step, eta1 - associated.eta, associated.pt, pt1, multiplicity, deltaPhi, posZ, associatedWeight);
         }
+        nPairs++;
       }
     }
+
+    if (cfgVerbosity > 1) {
+      double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+      nPairsFilled += nPairs;
+      pairFillTime += elapsed;
+      LOGF(info, "fillCorrelations: %llu pairs in %.3f ms, %.3g pairs/s on average", nPairs, elapsed, pairFillTime > 0 ? 1e3 * nPairsFilled / pairFillTime : 0.);
+    }
   }
 
   void loadEfficiency(uint64_t timestamp)
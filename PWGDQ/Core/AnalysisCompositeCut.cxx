@@ -96,3 +96,53 @@ bool AnalysisCompositeCut::IsSelected(float* values)
     return false;
   }
 }
+
+void AnalysisCompositeCut::SetTabulateFunctions(int nPoints)
+{
+  //
+  // propagate the tabulation of the TF1 cut limits to all the cuts
+  //
+  AnalysisCut::SetTabulateFunctions(nPoints);
+  for (auto& cut : fCutList) {
+    cut.SetTabulateFunctions(nPoints);
+  }
+  for (auto& cut : fCompositeCutList) {
+    cut.SetTabulateFunctions(nPoints);
+  }
+}
+
+void AnalysisCompositeCut::SelectBatch(const float* values, int nObjects, uint8_t* selected)
+{
+  //
+  // apply cuts on a block of objects
+  // With AND, all the cuts are applied in sequence on the same per-object decisions, without intermediate bit masks
+  //
+  if (fOptionUseAND) {
+    for (auto& cut : fCutList) {
+      cut.SelectBatch(values, nObjects, selected);
+    }
+    for (auto& cut : fCompositeCutList) {
+      cut.SelectBatch(values, nObjects, selected);
+    }
+    return;
+  }
+
+  fBatchOR.assign(nObjects, 0);
+  auto applyOR = [&](AnalysisCut& cut) {
+    fBatchCut.assign(nObjects, 1);
+    cut.SelectBatch(values, nObjects, fBatchCut.data());
+    for (int i = 0; i < nObjects; i++) {
+      fBatchOR[i] |= fBatchCut[i];
+    }
+  };
+  for (auto& cut : fCutList) {
+    applyOR(cut);
+  }
+  for (auto& cut : fCompositeCutList) {
+    applyOR(cut);
+  }
+  for (int i = 0; i < nObjects; i++) {
+    selected[i] &= fBatchOR[i];
+  }
+}
+
@@ -43,11 +43,16 @@ class AnalysisCompositeCut : public AnalysisCut
   int GetNCuts() const { return fCutList.size() + fCompositeCutList.size(); }
 
   bool IsSelected(float* values) override;
+  using AnalysisCut::IsSelected;
+  void SelectBatch(const float* values, int nObjects, uint8_t* selected) override;
+  void SetTabulateFunctions(int nPoints) override;
 
  protected:
   bool fOptionUseAND;                                  // true (default): apply AND on all cuts; false: use OR
   std::vector<AnalysisCut> fCutList;                   // list of cuts
   std::vector<AnalysisCompositeCut> fCompositeCutList; // list of composite cuts
+  std::vector<uint8_t> fBatchOR;                       //! objects selected by any of the cuts, used in the batch mode with OR
+  std::vector<uint8_t> fBatchCut;                      //! objects selected by one cut, used in the batch mode with OR
 
   ClassDef(AnalysisCompositeCut, 2);
 };
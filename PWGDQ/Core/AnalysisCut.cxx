@@ -11,6 +11,7 @@
 
 #include "PWGDQ/Core/AnalysisCut.h"
 
+#include <algorithm>
 #include <iostream>
 using std::cout;
 using std::endl;
@@ -37,6 +38,7 @@ AnalysisCut& AnalysisCut::operator=(const AnalysisCut& c)
   if (this != &c) {
     TNamed::operator=(c);
     fCuts = c.fCuts;
+    fNFuncTablePoints = c.fNFuncTablePoints;
   }
   return (*this);
 }
@@ -49,6 +51,7 @@ AnalysisCut::AnalysisCut(const AnalysisCut& c) : TNamed(c)
   //
   if (this != &c) {
     fCuts = c.fCuts;
+    fNFuncTablePoints = c.fNFuncTablePoints;
   }
 }
 
@@ -60,3 +63,131 @@ void AnalysisCut::PrintCuts()
 {
   cout << "**************** AnalysisCut::PrintCuts" << endl;
 }
+
+void AnalysisCut::BuildFuncTables()
+{
+  //
+  // tabulate the TF1 cut limits over their range, done once for the batch mode
+  //
+  fFuncTablesLow.assign(fCuts.size(), FuncTable());
+  fFuncTablesHigh.assign(fCuts.size(), FuncTable());
+  if (fNFuncTablePoints < 2) {
+    return;
+  }
+  for (std::size_t iCut = 0; iCut < fCuts.size(); iCut++) {
+    TF1* funcs[2] = {fCuts[iCut].fFuncLow, fCuts[iCut].fFuncHigh};
+    FuncTable* tables[2] = {&fFuncTablesLow[iCut], &fFuncTablesHigh[iCut]};
+    for (int i = 0; i < 2; i++) {
+      if (!funcs[i]) {
+        continue;
+      }
+      tables[i]->fXmin = funcs[i]->GetXmin();
+      tables[i]->fStep = (funcs[i]->GetXmax() - funcs[i]->GetXmin()) / (fNFuncTablePoints - 1);
+      tables[i]->fValues.resize(fNFuncTablePoints);
+      for (int iPoint = 0; iPoint < fNFuncTablePoints; iPoint++) {
+        tables[i]->fValues[iPoint] = funcs[i]->Eval(tables[i]->fXmin + iPoint * tables[i]->fStep);
+      }
+    }
+  }
+}
+
+void AnalysisCut::EvalLimit(TF1* func, const FuncTable& table, const float* x, int nObjects, float* limit) const
+{
+  //
+  // evaluate a TF1 cut limit for a column of values of the dependent variable, using the interpolation table if available
+  //
+  if (table.fValues.empty() || table.fStep <= 0.) {
+    for (int i = 0; i < nObjects; i++) {
+      limit[i] = func->Eval(x[i]);
+    }
+    return;
+  }
+  const int nIntervals = table.fValues.size() - 1;
+  for (int i = 0; i < nObjects; i++) {
+    float t = (x[i] - table.fXmin) / table.fStep;
+    if (!(t >= 0. && t <= nIntervals)) { // outside of the function range (or NaN): evaluate exactly
+      limit[i] = func->Eval(x[i]);
+      continue;
+    }
+    int bin = std::min(static_cast<int>(t), nIntervals - 1);
+    limit[i] = table.fValues[bin] + (t - bin) * (table.fValues[bin + 1] - table.fValues[bin]);
+  }
+}
+
+void AnalysisCut::PackSelection(const uint8_t* selected, int nObjects, uint64_t* selection)
+{
+  //
+  // pack the per-object decisions into a bit mask
+  //
+  for (int iWord = 0; iWord * 64 < nObjects; iWord++) {
+    const uint8_t* wordSelected = selected + iWord * 64;
+    int nBits = std::min(64, nObjects - iWord * 64);
+    uint64_t word = 0;
+    for (int iBit = 0; iBit < nBits; iBit++) {
+      word |= static_cast<uint64_t>(wordSelected[iBit]) << iBit;
+    }
+    selection[iWord] = word;
+  }
+}
+
+void AnalysisCut::IsSelected(const float* values, int nObjects, uint64_t* selection)
+{
+  //
+  // apply the configured cuts on a block of objects, same selection as IsSelected(float*)
+  //
+  if (nObjects <= 0) {
+    return;
+  }
+  fBatchSelected.assign(nObjects, 1);
+  SelectBatch(values, nObjects, fBatchSelected.data());
+  PackSelection(fBatchSelected.data(), nObjects, selection);
+}
+
+void AnalysisCut::SelectBatch(const float* values, int nObjects, uint8_t* selected)
+{
+  //
+  // apply the configured cuts on a block of objects, the objects failing any of the cuts are unset in selected
+  // The loops over objects are branch-free on contiguous columns, so that they can be vectorised by the compiler
+  //
+  if (fFuncTablesLow.size() != fCuts.size()) {
+    BuildFuncTables();
+  }
+
+  for (std::size_t iCut = 0; iCut < fCuts.size(); iCut++) {
+    const CutContainer& cut = fCuts[iCut];
+    const float* var = values + cut.fVar * nObjects;
+    const float* depVar = (cut.fDepVar != -1 ? values + cut.fDepVar * nObjects : nullptr);
+    const float* depVar2 = (cut.fDepVar2 != -1 ? values + cut.fDepVar2 * nObjects : nullptr);
+
+    // obtain the low and high cut values for each object if they are given as functions
+    const float* cutLow = nullptr;
+    const float* cutHigh = nullptr;
+    if (cut.fFuncLow) {
+      fBatchLow.resize(nObjects);
+      EvalLimit(cut.fFuncLow, fFuncTablesLow[iCut], depVar, nObjects, fBatchLow.data());
+      cutLow = fBatchLow.data();
+    }
+    if (cut.fFuncHigh) {
+      fBatchHigh.resize(nObjects);
+      EvalLimit(cut.fFuncHigh, fFuncTablesHigh[iCut], depVar, nObjects, fBatchHigh.data());
+      cutHigh = fBatchHigh.data();
+    }
+
+    // the cut rejects an object if it applies (dependent variables in the requested ranges) and the variable fails the selection
+    for (int i = 0; i < nObjects; i++) {
+      bool applies = true;
+      if (depVar) {
+        bool inRange = (depVar[i] > cut.fDepLow && depVar[i] <= cut.fDepHigh);
+        applies = (inRange != cut.fDepExclude);
+      }
+      if (depVar2) {
+        bool inRange = (depVar2[i] > cut.fDep2Low && depVar2[i] <= cut.fDep2High);
+        applies = applies && (inRange != cut.fDep2Exclude);
+      }
+      float low = (cutLow ? cutLow[i] : cut.fLow);
+      float high = (cutHigh ? cutHigh[i] : cut.fHigh);
+      bool inRange = (var[i] >= low && var[i] <= high);
+      selected[i] &= static_cast<uint8_t>(!applies || (inRange != cut.fExclude));
+    }
+  }
+}
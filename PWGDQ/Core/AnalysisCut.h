@@ -18,6 +18,7 @@
 #define AnalysisCut_H
 
 #include <TF1.h>
+#include <cstdint>
 #include <vector>
 
 //_________________________________________________________________________
@@ -39,6 +40,20 @@ class AnalysisCut : public TNamed
               int dependentVar2 = -1, float depCut2Low = 0., float depCut2High = 0., bool depCut2Exclude = false);
 
   virtual bool IsSelected(float* values);
+  // NOTE: Batch mode, apply the cuts on nObjects objects at once.
+  // NOTE:   values is a column-major block of VarManager variables, values[var * nObjects + iObject]
+  // NOTE:   selection is a bit mask with at least (nObjects + 63) / 64 words, bit iObject % 64 of word iObject / 64 is set if the object is selected
+  void IsSelected(const float* values, int nObjects, uint64_t* selection);
+  // NOTE: Same as the batch IsSelected(), but the objects failing the cuts are unset in the existing per-object decisions (one byte per object)
+  virtual void SelectBatch(const float* values, int nObjects, uint8_t* selected);
+  // NOTE: If nPoints > 1, the TF1 cut limits are tabulated over their range with nPoints points and linearly interpolated in the batch mode
+  // NOTE:   (values outside the function range are still evaluated exactly); by default the functions are evaluated for each object
+  virtual void SetTabulateFunctions(int nPoints)
+  {
+    fNFuncTablePoints = nPoints;
+    fFuncTablesLow.clear();
+    fFuncTablesHigh.clear();
+  }
 
   static std::vector<int> fgUsedVars; //! vector of used variables
 
@@ -67,6 +82,23 @@ class AnalysisCut : public TNamed
  protected:
   std::vector<CutContainer> fCuts;
 
+  // interpolation table of a TF1 cut limit, used in the batch mode
+  struct FuncTable {
+    float fXmin = 0.;
+    float fStep = 0.;
+    std::vector<float> fValues;
+  };
+  int fNFuncTablePoints = 0;              //! number of points of the TF1 tables, 0 if the functions are not tabulated
+  std::vector<FuncTable> fFuncTablesLow;  //! tables of the low limit functions, one per cut
+  std::vector<FuncTable> fFuncTablesHigh; //! tables of the high limit functions, one per cut
+  std::vector<uint8_t> fBatchSelected;    //! per-object decision, used in the batch mode
+  std::vector<float> fBatchLow;           //! per-object low limit, used in the batch mode
+  std::vector<float> fBatchHigh;          //! per-object high limit, used in the batch mode
+
+  void BuildFuncTables();
+  void EvalLimit(TF1* func, const FuncTable& table, const float* x, int nObjects, float* limit) const;
+  static void PackSelection(const uint8_t* selected, int nObjects, uint64_t* selection);
+
   ClassDef(AnalysisCut, 1);
 };
 
@@ -17,6 +17,9 @@
 #include <list>
 #include <vector>
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
 #include "Framework/Logger.h"
 using namespace std;
 
@@ -33,9 +36,51 @@ using namespace std;
 #include <THnSparse.h>
 #include <TIterator.h>
 #include <TClass.h>
+#include <TObjString.h>
 
 ClassImp(HistogramManager);
 
+namespace
+{
+// Fill functions of the compiled fill plans, one per histogram type and weighting option.
+// vars = {varX, varY, varZ, varT, varW} for TH1/TH2/TH3 and profiles, {varW, nDim, var0, ..., varN-1} for THn.
+// x is the value to fill on the x-axis, already converted to the bin center for histograms filled with x-axis labels
+enum FillPlanVar {
+  kFillVarX = 0,
+  kFillVarY,
+  kFillVarZ,
+  kFillVarT,
+  kFillVarW
+};
+
+void fillTH1(TObject* h, const int*, const float*, double x) { reinterpret_cast<TH1*>(h)->Fill(x); }
+void fillTH1W(TObject* h, const int* vars, const float* values, double x) { reinterpret_cast<TH1*>(h)->Fill(x, values[vars[kFillVarW]]); }
+void fillTProfile(TObject* h, const int* vars, const float* values, double x) { reinterpret_cast<TProfile*>(h)->Fill(x, values[vars[kFillVarY]]); }
+void fillTProfileW(TObject* h, const int* vars, const float* values, double x) { reinterpret_cast<TProfile*>(h)->Fill(x, values[vars[kFillVarY]], values[vars[kFillVarW]]); }
+void fillTH2(TObject* h, const int* vars, const float* values, double x) { reinterpret_cast<TH2*>(h)->Fill(x, values[vars[kFillVarY]]); }
+void fillTH2W(TObject* h, const int* vars, const float* values, double x) { reinterpret_cast<TH2*>(h)->Fill(x, values[vars[kFillVarY]], values[vars[kFillVarW]]); }
+void fillTProfile2D(TObject* h, const int* vars, const float* values, double x) { reinterpret_cast<TProfile2D*>(h)->Fill(x, values[vars[kFillVarY]], values[vars[kFillVarZ]]); }
+void fillTProfile2DW(TObject* h, const int* vars, const float* values, double x) { reinterpret_cast<TProfile2D*>(h)->Fill(x, values[vars[kFillVarY]], values[vars[kFillVarZ]], values[vars[kFillVarW]]); }
+void fillTH3(TObject* h, const int* vars, const float* values, double x) { reinterpret_cast<TH3*>(h)->Fill(x, values[vars[kFillVarY]], values[vars[kFillVarZ]]); }
+void fillTH3W(TObject* h, const int* vars, const float* values, double x) { reinterpret_cast<TH3*>(h)->Fill(x, values[vars[kFillVarY]], values[vars[kFillVarZ]], values[vars[kFillVarW]]); }
+void fillTProfile3D(TObject* h, const int* vars, const float* values, double x) { reinterpret_cast<TProfile3D*>(h)->Fill(x, values[vars[kFillVarY]], values[vars[kFillVarZ]], values[vars[kFillVarT]]); }
+void fillTProfile3DW(TObject* h, const int* vars, const float* values, double x) { reinterpret_cast<TProfile3D*>(h)->Fill(x, values[vars[kFillVarY]], values[vars[kFillVarZ]], values[vars[kFillVarT]], values[vars[kFillVarW]]); }
+
+void fillTHn(TObject* h, const int* vars, const float* values, double)
+{
+  // TODO: At the moment, maximum 20 dimensions are foreseen for the THn histograms (see FillHistClass)
+  double fillValues[20] = {0.0};
+  for (int i = 0; i < vars[1]; i++) {
+    fillValues[i] = values[vars[2 + i]];
+  }
+  if (vars[0] > HistogramManager::kNothing) {
+    reinterpret_cast<THn*>(h)->Fill(fillValues, values[vars[0]]);
+  } else {
+    reinterpret_cast<THn*>(h)->Fill(fillValues);
+  }
+}
+} // namespace
+
 //_______________________________________________________________________________
 HistogramManager::HistogramManager() : TNamed("", ""),
                                        fMainList(nullptr),
@@ -187,6 +232,7 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
   std::list varList = fVariablesMap[histClass];
   varList.push_back(varVector);
   fVariablesMap[histClass] = varList;
+  InvalidateFillPlan(histClass);
 
   // create and configure histograms according to required options
   TH1* h = nullptr;
@@ -397,6 +443,7 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
   std::list varList = fVariablesMap[histClass];
   varList.push_back(varVector);
   fVariablesMap[histClass] = varList;
+  InvalidateFillPlan(histClass);
 
   TH1* h = nullptr;
   switch (dimension) {
@@ -582,6 +629,7 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
   std::list varList = fVariablesMap[histClass];
   varList.push_back(varVector);
   fVariablesMap[histClass] = varList;
+  InvalidateFillPlan(histClass);
 
   uint32_t nbins = 1;
   THnBase* h = nullptr;
@@ -675,6 +723,7 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
   std::list varList = fVariablesMap[histClass];
   varList.push_back(varVector);
   fVariablesMap[histClass] = varList;
+  InvalidateFillPlan(histClass);
 
   // get the min and max for each axis
   auto* xmin = new double[nDimensions];
@@ -741,156 +790,153 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
 }
 
 //__________________________________________________________________
-void HistogramManager::FillHistClass(const char* className, Float_t* values)
+int HistogramManager::GetHistClassHandle(const char* className)
 {
   //
-  //  fill a class of histograms
+  // Get the handle of the fill plan of a histogram class, to be used with FillHistClass(int, float*)
   //
-
-  // get the needed histogram list
-  auto* hList = reinterpret_cast<TList*>(fMainList->FindObject(className));
+  TObject* hList = fMainList->FindObject(className);
   if (!hList) {
-    // TODO: add some meaningfull error message
-    /*LOG(warn) << "HistogramManager::FillHistClass(): Histogram list " << className << " not found!";
-    LOG(warn) << "         Histogram list not filled" << endl; */
-    return;
+    return kNothing;
   }
+  auto handle = fFillPlanHandles.find(hList);
+  if (handle != fFillPlanHandles.end()) {
+    return handle->second;
+  }
+  FillPlan plan;
+  plan.fList = reinterpret_cast<TList*>(hList);
+  fFillPlans.push_back(plan);
+  fFillPlanHandles[hList] = fFillPlans.size() - 1;
+  return fFillPlans.size() - 1;
+}
 
-  // get the corresponding std::list containng identifiers to the needed variables to be filled
-  list varList = fVariablesMap[className];
-
-  TIter next(hList);
+//__________________________________________________________________
+void HistogramManager::InvalidateFillPlan(const char* className)
+{
+  //
+  // Mark the fill plan of a histogram class to be compiled again, e.g. after adding a histogram to the class
+  //
+  auto handle = fFillPlanHandles.find(fMainList->FindObject(className));
+  if (handle != fFillPlanHandles.end()) {
+    fFillPlans[handle->second].fIsCompiled = false;
+  }
+}
 
-  TObject* h = nullptr;
-  bool isProfile;
-  bool isTHn;
-  int dimension = 0;
-  bool isSparse = kFALSE;
-  bool isFillLabelx = kFALSE;
-  // TODO: At the moment, maximum 20 dimensions are foreseen for the THn histograms. We should make this more dynamic
-  //       But maybe its better to have it like to avoid dynamically allocating this array in the histogram loop
-  double fillValues[20] = {0.0};
-  int varX = -1, varY = -1, varZ = -1, varT = -1, varW = -1;
-
-  // loop over the histogram and std::list
-  // NOTE: these two should contain the same number of elements and be synchronized, otherwise its a mess
-  for (auto varIter = varList.begin(); varIter != varList.end(); varIter++) {
-    h = next(); // get the histogram
-    // decode information from the vector of indices
-    isProfile = (varIter->at(0) == 1 ? true : false);
-    isTHn = (varIter->at(1) > 0 ? true : false);
-    if (isTHn) {
-      dimension = varIter->at(1);
-    } else {
-      dimension = (reinterpret_cast<TH1*>(h))->GetDimension();
+//__________________________________________________________________
+void HistogramManager::CompileFillPlan(FillPlan& plan, const char* className)
+{
+  //
+  // Compile the fill plan of a histogram class: resolve once the fill function and the variables of each histogram
+  //
+  plan.fEntries.clear();
+  plan.fVars.clear();
+  plan.fLabelCaches.clear();
+
+  // NOTE: the histogram list and the std::list of variables contain the same number of elements and are synchronized
+  const auto& varList = fVariablesMap[className];
+  TIter next(plan.fList);
+  for (const auto& varVector : varList) {
+    TObject* h = next();
+    FillPlanEntry entry{h, nullptr, static_cast<int>(plan.fVars.size()), kNothing};
+    bool isProfile = (varVector[0] == 1);
+    int nDimTHn = varVector[1];
+    int varW = varVector[2];
+    bool isWeighted = (varW > kNothing);
+
+    if (nDimTHn > 0) {
+      plan.fVars.push_back(varW);
+      plan.fVars.push_back(nDimTHn);
+      for (int i = 0; i < nDimTHn; i++) {
+        plan.fVars.push_back(varVector[3 + i]);
+      }
+      entry.fFill = fillTHn;
+      plan.fEntries.push_back(entry);
+      continue;
     }
 
-    // get the various variable indices
-    varW = varIter->at(2);
-    if (isTHn) {
-      for (int i = 0; i < dimension; i++) {
-        fillValues[i] = values[varIter->at(3 + i)];
-      }
-    } else {
-      varX = varIter->at(3);
-      varY = varIter->at(4);
-      varZ = varIter->at(5);
-      varT = varIter->at(6);
-      isFillLabelx = (varIter->at(7) == 1 ? true : false);
+    plan.fVars.insert(plan.fVars.end(), {varVector[3], varVector[4], varVector[5], varVector[6], varW});
+    int dimension = (reinterpret_cast<TH1*>(h))->GetDimension();
+    switch (dimension) {
+      case 1:
+        entry.fFill = isProfile ? (isWeighted ? fillTProfileW : fillTProfile) : (isWeighted ? fillTH1W : fillTH1);
+        break;
+      case 2:
+        entry.fFill = isProfile ? (isWeighted ? fillTProfile2DW : fillTProfile2D) : (isWeighted ? fillTH2W : fillTH2);
+        break;
+      case 3:
+        entry.fFill = isProfile ? (isWeighted ? fillTProfile3DW : fillTProfile3D) : (isWeighted ? fillTH3W : fillTH3);
+        break;
+      default:
+        break;
     }
 
-    if (!isTHn) {
-      switch (dimension) {
-        case 1:
-          if (isProfile) {
-            if (varW > kNothing) {
-              if (isFillLabelx) {
-                (reinterpret_cast<TProfile*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), values[varY], values[varW]);
-              } else {
-                (reinterpret_cast<TProfile*>(h))->Fill(values[varX], values[varY], values[varW]);
-              }
-            } else {
-              if (isFillLabelx) {
-                (reinterpret_cast<TProfile*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), values[varY]);
-              } else {
-                (reinterpret_cast<TProfile*>(h))->Fill(values[varX], values[varY]);
-              }
-            }
-          } else {
-            if (varW > kNothing) {
-              if (isFillLabelx) {
-                (reinterpret_cast<TH1*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), values[varW]);
-              } else {
-                (reinterpret_cast<TH1*>(h))->Fill(values[varX], values[varW]);
-              }
-            } else {
-              if (isFillLabelx) {
-                (reinterpret_cast<TH1*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), 1.);
-              } else {
-                (reinterpret_cast<TH1*>(h))->Fill(values[varX]);
-              }
-            }
-          }
-          break;
-        case 2:
-          if (isProfile) {
-            if (varW > kNothing) {
-              (reinterpret_cast<TProfile2D*>(h))->Fill(values[varX], values[varY], values[varZ], values[varW]);
-            } else {
-              (reinterpret_cast<TProfile2D*>(h))->Fill(values[varX], values[varY], values[varZ]);
-            }
-          } else {
-            if (varW > kNothing) {
-              if (isFillLabelx) {
-                (reinterpret_cast<TH2*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), values[varY], values[varW]);
-              } else {
-                (reinterpret_cast<TH2*>(h))->Fill(values[varX], values[varY], values[varW]);
-              }
-            } else {
-              if (isFillLabelx) {
-                (reinterpret_cast<TH2*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), values[varY], 1.);
-              } else {
-                (reinterpret_cast<TH2*>(h))->Fill(values[varX], values[varY]);
-              }
-            }
+    // histograms filled with the x-axis labels (TH1, TProfile and TH2): convert the labels already defined into bin centers
+    bool isFillLabelx = (varVector[7] == 1);
+    if (isFillLabelx && (dimension == 1 || (dimension == 2 && !isProfile))) {
+      entry.fLabelCacheIndex = plan.fLabelCaches.size();
+      std::unordered_map<int, double> labelCache;
+      TAxis* axis = (reinterpret_cast<TH1*>(h))->GetXaxis();
+      if (axis->GetLabels()) {
+        TIter nextLabel(axis->GetLabels());
+        while (auto* label = reinterpret_cast<TObjString*>(nextLabel())) {
+          if (label->GetString().IsDec()) {
+            labelCache[label->GetString().Atoi()] = axis->GetBinCenter(label->GetUniqueID());
           }
-          break;
-        case 3:
-          if (isProfile) {
-            if (varW > kNothing) {
-              (reinterpret_cast<TProfile3D*>(h))->Fill(values[varX], values[varY], values[varZ], values[varT], values[varW]);
-            } else {
-              (reinterpret_cast<TProfile3D*>(h))->Fill(values[varX], values[varY], values[varZ], values[varT]);
-            }
-          } else {
-            if (varW > kNothing) {
-              (reinterpret_cast<TH3*>(h))->Fill(values[varX], values[varY], values[varZ], values[varW]);
-            } else {
-              (reinterpret_cast<TH3*>(h))->Fill(values[varX], values[varY], values[varZ]);
-            }
-          }
-          break;
-
-        default:
-          break;
-      } // end switch
-      // end if(!isTHn)
-    } else {
-      if (varW > kNothing) {
-        if (isSparse) {
-          (reinterpret_cast<THnSparse*>(h))->Fill(fillValues, values[varW]);
-        } else {
-          (reinterpret_cast<THn*>(h))->Fill(fillValues, values[varW]);
-        }
-      } else {
-        if (isSparse) {
-          (reinterpret_cast<THnSparse*>(h))->Fill(fillValues);
-        } else {
-          (reinterpret_cast<THn*>(h))->Fill(fillValues);
         }
       }
-    } // end else
-  } // end loop over histograms
+      plan.fLabelCaches.push_back(labelCache);
+    }
+    plan.fEntries.push_back(entry);
+  }
+  plan.fIsCompiled = true;
+}
+
+//__________________________________________________________________
+void HistogramManager::FillHistClass(int handle, Float_t* values)
+{
+  //
+  //  fill a class of histograms using its compiled fill plan
+  //
+  if (handle < 0 || handle >= static_cast<int>(fFillPlans.size())) {
+    return;
+  }
+  FillPlan& plan = fFillPlans[handle];
+  if (!plan.fIsCompiled) {
+    CompileFillPlan(plan, plan.fList->GetName());
+  }
+
+  for (const auto& entry : plan.fEntries) {
+    if (!entry.fFill) {
+      continue;
+    }
+    const int* vars = plan.fVars.data() + entry.fVarsOffset;
+    if (entry.fLabelCacheIndex == kNothing) {
+      entry.fFill(entry.fHist, vars, values, values[vars[kFillVarX]]);
+      continue;
+    }
+    // filling with the x-axis label of the integer value: labels not yet seen are resolved (and added if needed) by the axis
+    auto& labelCache = plan.fLabelCaches[entry.fLabelCacheIndex];
+    int label = static_cast<int>(values[vars[kFillVarX]]);
+    auto binCenter = labelCache.find(label);
+    if (binCenter == labelCache.end()) {
+      TAxis* axis = (reinterpret_cast<TH1*>(entry.fHist))->GetXaxis();
+      int bin = axis->FindBin(Form("%d", label));
+      binCenter = labelCache.emplace(label, bin < 0 ? std::numeric_limits<double>::quiet_NaN() : axis->GetBinCenter(bin)).first;
+    }
+    if (!std::isnan(binCenter->second)) {
+      entry.fFill(entry.fHist, vars, values, binCenter->second);
+    }
+  }
+}
+
+//__________________________________________________________________
+void HistogramManager::FillHistClass(const char* className, Float_t* values)
+{
+  //
+  //  fill a class of histograms
+  //  NOTE: the histogram class is looked up at every call, use GetHistClassHandle() and FillHistClass(int, float*) in loops
+  //
+  FillHistClass(GetHistClassHandle(className), values);
 }
 
 //____________________________________________________________________________________
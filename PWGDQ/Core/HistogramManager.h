@@ -26,6 +26,7 @@
 
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <list>
 
@@ -85,6 +86,11 @@ class HistogramManager : public TNamed
                     TString* axLabels = nullptr, int varW = -1, bool useSparse = kFALSE, bool isdouble = false);
 
   void FillHistClass(const char* className, float* values);
+  // Resolve a histogram class into a handle to its compiled fill plan, to be used in the hot loops with FillHistClass(int, float*)
+  // Returns kNothing if the histogram class does not exist
+  int GetHistClassHandle(const char* className);
+  // Fill a class of histograms using the fill plan resolved with GetHistClassHandle(), without any lookup by name
+  void FillHistClass(int handle, float* values);
 
   void SetUseDefaultVariableNames(bool flag) { fUseDefaultVariableNames = flag; }
   void SetDefaultVarNames(TString* vars, TString* units);
@@ -102,6 +108,25 @@ class HistogramManager : public TNamed
   bool* fUsedVars;                                                  //! flags of used variables
   std::map<std::string, std::list<std::vector<int>>> fVariablesMap; //!  map holding identifiers for all variables needed by histograms
 
+  // compiled fill plan of a histogram class: one entry per histogram, with the fill function and the indices of the
+  // variables to be filled stored contiguously in fVars ({varX, varY, varZ, varT, varW} or {varW, nDim, var0, ..., varN-1} for THn)
+  using FillFunction = void (*)(TObject* h, const int* vars, const float* values, double x);
+  struct FillPlanEntry {
+    TObject* fHist;       // histogram to be filled
+    FillFunction fFill;   // fill function for this type of histogram
+    int fVarsOffset;      // offset of the variable indices in FillPlan::fVars
+    int fLabelCacheIndex; // index in FillPlan::fLabelCaches if the x-axis is filled with labels, kNothing otherwise
+  };
+  struct FillPlan {
+    TList* fList = nullptr;                                    // histogram list of the class
+    bool fIsCompiled = false;                                  // whether the plan is up-to-date with the histogram list
+    std::vector<FillPlanEntry> fEntries;                       // fill entries, same order as the histogram list
+    std::vector<int> fVars;                                    // variable indices of all the entries
+    std::vector<std::unordered_map<int, double>> fLabelCaches; // x-axis label (integer value) -> bin center
+  };
+  std::vector<FillPlan> fFillPlans;                          //! compiled fill plans, indexed by handle
+  std::unordered_map<const TObject*, int> fFillPlanHandles; //! histogram list -> handle of its fill plan
+
   // various
   bool fUseDefaultVariableNames;    //! toggle the usage of default variable names and units
   uint64_t fBinsAllocated;          //! number of allocated bins
@@ -109,6 +134,8 @@ class HistogramManager : public TNamed
   TString* fVariableUnits;          //! variable units
 
   void MakeAxisLabels(TAxis* ax, const char* labels);
+  void CompileFillPlan(FillPlan& plan, const char* className);
+  void InvalidateFillPlan(const char* className);
 
   HistogramManager& operator=(const HistogramManager& c);
   HistogramManager(const HistogramManager& c);
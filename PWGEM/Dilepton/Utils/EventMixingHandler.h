@@ -16,11 +16,15 @@
 #define PWGEM_DILEPTON_UTILS_EVENTMIXINGHANDLER_H_
 
 #include <map>
+#include <span>
 #include <utility>
 #include <vector>
 
 namespace o2::aod::pwgem::dilepton::utils
 {
+// Each mixing bin is a ring buffer of fNdepth slots. Slots of all bins live in one flat arena and keep the capacity of their track
+// vectors, so that an evicted collision hands its storage over to the next one and the memory is bounded by ndepth x number of bins.
+// Spans returned by the getters are valid until the next call of AddTrackToEventPool or AddCollisionIdAtLast.
 template <typename T, typename U, typename V>
 class EventMixingHandler
 {
@@ -28,50 +32,144 @@ class EventMixingHandler
   EventMixingHandler()
   {
     fNdepth = 0;
-    fMapMixBins.clear();
-    fMap_Tracks_per_collision.clear();
   }
 
   explicit EventMixingHandler(int ndepth)
   {
     fNdepth = ndepth;
-    fMapMixBins.clear();
-    fMap_Tracks_per_collision.clear();
   }
 
-  ~EventMixingHandler()
+  ~EventMixingHandler() = default;
+
+  void SetNdepth(int ndepth)
   {
-    fMapMixBins.clear();
-    fMap_Tracks_per_collision.clear();
+    fNdepth = ndepth;
+    Clear();
   }
 
-  void SetNdepth(int ndepth) { fNdepth = ndepth; }
+  void Clear()
+  {
+    fMapBinIndex.clear();
+    fBins.clear();
+    fCollisionIds.clear();
+    fSlots.clear();
+    fMapSlotIndex.clear();
+    fCurrentTracks.clear();
+    fHasCurrentCollision = false;
+  }
 
+  // tracks are staged for the current collision until AddCollisionIdAtLast moves them into the pool
   void AddTrackToEventPool(U key_df_collision, V obj)
   {
-    fMap_Tracks_per_collision[key_df_collision].emplace_back(obj);
+    if (!fHasCurrentCollision || key_df_collision != fCurrentCollision) {
+      fCurrentCollision = key_df_collision;
+      fHasCurrentCollision = true;
+      fCurrentTracks.clear(); // tracks of a collision which did not enter the pool
+    }
+    fCurrentTracks.emplace_back(obj);
   }
 
-  std::vector<U> GetCollisionIdsFromEventPool(T key_bin) { return fMapMixBins[key_bin]; }
-  std::vector<V> GetTracksPerCollision(T key_bin, int index) { return fMap_Tracks_per_collision[fMapMixBins[key_bin][index]]; }
-  std::vector<V> GetTracksPerCollision(U key_df_collision) { return fMap_Tracks_per_collision[key_df_collision]; }
+  // collisions in the pool of a bin, from the oldest to the latest
+  std::span<const U> GetCollisionIdsFromEventPool(T key_bin) const
+  {
+    const int bin = FindBin(key_bin);
+    if (bin < 0) {
+      return {};
+    }
+    return std::span<const U>(fCollisionIds.data() + 2 * fNdepth * bin + fBins[bin].first, fBins[bin].size);
+  }
+
+  std::span<const V> GetTracksPerCollision(T key_bin, int index) const
+  {
+    const int bin = FindBin(key_bin);
+    if (bin < 0 || index < 0 || index >= fBins[bin].size) {
+      return {};
+    }
+    return fSlots[fNdepth * bin + (fBins[bin].first + index) % fNdepth].tracks;
+  }
+
+  std::span<const V> GetTracksPerCollision(U key_df_collision) const
+  {
+    if (fHasCurrentCollision && key_df_collision == fCurrentCollision) {
+      return fCurrentTracks;
+    }
+    auto slot = fMapSlotIndex.find(key_df_collision);
+    if (slot == fMapSlotIndex.end()) {
+      return {};
+    }
+    return fSlots[slot->second].tracks;
+  }
 
   // call this function at the end of collision loop
   void AddCollisionIdAtLast(T key_bin, U key_df_collision)
   {
-    // LOGF(info, "fMapMixBins[key_bin].size() = %d", fMapMixBins[key_bin].size());
-    if (static_cast<int>(fMapMixBins[key_bin].size()) >= fNdepth) {
-      fMap_Tracks_per_collision[fMapMixBins[key_bin][0]].clear();
-      fMap_Tracks_per_collision[fMapMixBins[key_bin][0]].shrink_to_fit();
-      fMapMixBins[key_bin].erase(fMapMixBins[key_bin].begin());
+    if (fNdepth <= 0) {
+      return;
+    }
+    const int bin = FindOrAddBin(key_bin);
+    auto& pool = fBins[bin];
+    int position = 0;
+    if (pool.size >= fNdepth) { // evict the oldest collision, its slot is reused
+      position = pool.first;
+      fMapSlotIndex.erase(fSlots[fNdepth * bin + position].key);
+      pool.first = (pool.first + 1) % fNdepth;
+    } else {
+      position = (pool.first + pool.size) % fNdepth;
+      pool.size++;
+    }
+
+    // collision ids are written twice, so that the pool is always contiguous in [first, first + size)
+    fCollisionIds[2 * fNdepth * bin + position] = key_df_collision;
+    fCollisionIds[2 * fNdepth * bin + position + fNdepth] = key_df_collision;
+
+    const int slotIndex = fNdepth * bin + position;
+    auto& slot = fSlots[slotIndex];
+    slot.key = key_df_collision;
+    slot.tracks.clear();
+    if (fHasCurrentCollision && key_df_collision == fCurrentCollision) {
+      slot.tracks.swap(fCurrentTracks); // the evicted storage is recycled for the next collision
+      fHasCurrentCollision = false;
     }
-    fMapMixBins[key_bin].emplace_back(key_df_collision);
+    fMapSlotIndex[key_df_collision] = slotIndex;
   }
 
  private:
-  int fNdepth;                                           // depth of event mixing
-  std::map<T, std::vector<U>> fMapMixBins;               // map : e.g. <zbin, centbin, epbin> -> pair<df index, global collision index>
-  std::map<U, std::vector<V>> fMap_Tracks_per_collision; // map : e.g. pair<df index, global collision index> -> track array
+  struct Pool {
+    int first = 0; // position of the oldest collision in the ring buffer
+    int size = 0;  // number of collisions in the ring buffer
+  };
+
+  struct Slot {
+    U key{};
+    std::vector<V> tracks;
+  };
+
+  int FindBin(T const& key_bin) const
+  {
+    auto bin = fMapBinIndex.find(key_bin);
+    return bin == fMapBinIndex.end() ? -1 : bin->second;
+  }
+
+  int FindOrAddBin(T const& key_bin)
+  {
+    auto [bin, isNew] = fMapBinIndex.try_emplace(key_bin, static_cast<int>(fBins.size()));
+    if (isNew) {
+      fBins.emplace_back();
+      fCollisionIds.resize(fCollisionIds.size() + 2 * fNdepth);
+      fSlots.resize(fSlots.size() + fNdepth);
+    }
+    return bin->second;
+  }
+
+  int fNdepth;                       // depth of event mixing
+  std::map<T, int> fMapBinIndex;     // map : e.g. <zbin, centbin, epbin> -> dense bin index
+  std::vector<Pool> fBins;           // ring buffer state per bin
+  std::vector<U> fCollisionIds;      // 2 x fNdepth collision ids per bin, e.g. pair<df index, global collision index>
+  std::vector<Slot> fSlots;          // fNdepth slots per bin, holding the tracks of the collisions in the pool
+  std::map<U, int> fMapSlotIndex;    // map : e.g. pair<df index, global collision index> -> slot, only for collisions in the pool
+  U fCurrentCollision{};             // collision whose tracks are being added
+  bool fHasCurrentCollision = false; // whether fCurrentCollision is set
+  std::vector<V> fCurrentTracks;     // tracks of the current collision
 };
 } // namespace o2::aod::pwgem::dilepton::utils
 #endif // PWGEM_DILEPTON_UTILS_EVENTMIXINGHANDLER_H_
@@ -15,8 +15,11 @@
 #ifndef PWGEM_DILEPTON_UTILS_MOMENTUMSMEARER_H_
 #define PWGEM_DILEPTON_UTILS_MOMENTUMSMEARER_H_
 
+#include <algorithm>
+#include <utility>
 #include <vector>
 
+#include <TAxis.h>
 #include <TH1.h>
 #include <TH2.h>
 #include <TH3.h>
@@ -25,6 +28,7 @@
 #include <TGrid.h>
 #include <TFile.h>
 #include <TKey.h>
+#include <TRandom.h>
 
 #include "CCDB/BasicCCDBManager.h"
 #include "Framework/Logger.h"
@@ -128,54 +132,144 @@ class MomentumSmearer
     }
   }
 
-  void fillVecReso(TH2F* fReso, std::vector<TH1F*>& fVecReso)
+  /// Inverse-CDF tables of the y-axis slices of a TH2, one per bin of the x axis (pt)
+  struct SliceTable {
+    TAxis axisPt;              // x axis of the TH2
+    int nBins = 0;             // number of bins of the y axis
+    std::vector<double> edges; // bin edges of the y axis
+    std::vector<double> cdf;   // (nBins + 1) normalised cumulative contents per slice, starting at 0
+    std::vector<bool> filled;  // whether the slice has entries
+  };
+
+  void fillSliceTable(TH2F* fReso, SliceTable& table)
   {
-    TAxis* axisPt = fReso->GetXaxis();
-    int nBinsPt = axisPt->GetNbins();
-    for (int i = 1; i <= nBinsPt; i++) {
-      fVecReso.push_back(reinterpret_cast<TH1F*>(fReso->ProjectionY("", i, i)));
+    TAxis* axisVar = fReso->GetYaxis();
+    table.axisPt = *fReso->GetXaxis();
+    table.nBins = axisVar->GetNbins();
+    const int nSlices = table.axisPt.GetNbins();
+    table.edges.resize(table.nBins + 1);
+    for (int j = 0; j < table.nBins; j++) {
+      table.edges[j] = axisVar->GetBinLowEdge(j + 1);
+    }
+    table.edges[table.nBins] = axisVar->GetBinUpEdge(table.nBins);
+    table.cdf.assign(nSlices * (table.nBins + 1), 0.);
+    table.filled.assign(nSlices, false);
+    for (int i = 0; i < nSlices; i++) {
+      double* cdf = table.cdf.data() + i * (table.nBins + 1);
+      for (int j = 0; j < table.nBins; j++) {
+        cdf[j + 1] = cdf[j] + fReso->GetBinContent(i + 1, j + 1);
+      }
+      if (cdf[table.nBins] > 0) {
+        table.filled[i] = true;
+        for (int j = 1; j <= table.nBins; j++) {
+          cdf[j] /= cdf[table.nBins];
+        }
+      }
+    }
+  }
+
+  /// Draws a value from the slice of a given pt, as TH1::GetRandom of the projection would
+  float sampleSliceTable(SliceTable& table, const float pt)
+  {
+    int ptbin = table.axisPt.FindBin(pt);
+    if (ptbin < 1) {
+      ptbin = 1;
+    }
+    if (ptbin > table.axisPt.GetNbins()) {
+      ptbin = table.axisPt.GetNbins();
+    }
+    if (!table.filled[ptbin - 1]) {
+      return 0.;
+    }
+    const double* cdf = table.cdf.data() + (ptbin - 1) * (table.nBins + 1);
+    const double r1 = gRandom->Rndm();
+    int ibin = static_cast<int>(std::upper_bound(cdf, cdf + table.nBins + 1, r1) - cdf) - 1;
+    ibin = std::clamp(ibin, 0, table.nBins - 1);
+    double x = table.edges[ibin];
+    if (r1 > cdf[ibin]) {
+      x += (table.edges[ibin + 1] - table.edges[ibin]) * (r1 - cdf[ibin]) / (cdf[ibin + 1] - cdf[ibin]);
     }
+    return x;
   }
 
-  void fillVecResoND(THnSparseF* hs_reso)
+  /// Converts the resolution cells (cent, pt, eta, phi, charge) of the THnSparse into inverse-CDF tables over (dpt/pt, deta, dphi),
+  /// stored one after the other in a contiguous buffer. Only the filled bins are kept and the sparse histogram is read in a single pass.
+  void fillTableResoND(THnSparseF* hs_reso)
   {
-    LOGP(info, "prepare TH3D");
+    LOGP(info, "prepare smearing tables");
     fNCenBins = hs_reso->GetAxis(0)->GetNbins();
     fNPtBins = hs_reso->GetAxis(1)->GetNbins();
     fNEtaBins = hs_reso->GetAxis(2)->GetNbins();
     fNPhiBins = hs_reso->GetAxis(3)->GetNbins();
     fNChBins = hs_reso->GetAxis(4)->GetNbins();
     LOGF(info, "ncen = %d, npt = %d, neta = %d, nphi = %d, nch = %d without under- and overflow bins", fNCenBins, fNPtBins, fNEtaBins, fNPhiBins, fNChBins);
-    // fVecResoND.reserve(npt * neta * nphi * nch);
-
-    fVecResoND.resize(fNCenBins, std::vector<std::vector<std::vector<std::vector<TH3D*>>>>(fNPtBins, std::vector<std::vector<std::vector<TH3D*>>>(fNEtaBins, std::vector<std::vector<TH3D*>>(fNPhiBins, std::vector<TH3D*>(fNChBins)))));
-    // fVecResoND.resize(fNPtBins, std::vector<std::vector<std::vector<TH3D*>>>(fNEtaBins, std::vector<std::vector<TH3D*>>(fNPhiBins, std::vector<TH3D*>(fNChBins))));
-    //  auto h3 = reinterpret_cast<TH3D*>(hs_reso->Projection(4, 5, 6));
-    //  h3->SetName(Form("h3reso_pt%d_eta%d_phi%d_ch%d", 0, 0, 0, 0));
-    //  fVecResoND[0][0][0][0] = h3;
-
-    for (int icen = 0; icen < fNCenBins; icen++) {
-      hs_reso->GetAxis(0)->SetRange(icen + 1, icen + 1);
-      for (int ipt = 0; ipt < fNPtBins; ipt++) {
-        hs_reso->GetAxis(1)->SetRange(ipt + 1, ipt + 1);
-        for (int ieta = 0; ieta < fNEtaBins; ieta++) {
-          hs_reso->GetAxis(2)->SetRange(ieta + 1, ieta + 1);
-          for (int iphi = 0; iphi < fNPhiBins; iphi++) {
-            hs_reso->GetAxis(3)->SetRange(iphi + 1, iphi + 1);
-            for (int ich = 0; ich < fNChBins; ich++) {
-              if (-0.5 < hs_reso->GetAxis(4)->GetBinCenter(ich + 1) && hs_reso->GetAxis(4)->GetBinCenter(ich + 1) < 0.5) {
-                continue;
-              }
-              hs_reso->GetAxis(4)->SetRange(ich + 1, ich + 1);
-              auto h3 = reinterpret_cast<TH3D*>(hs_reso->Projection(5, 6, 7));
-              h3->SetName(Form("h3reso_cen%d_pt%d_eta%d_phi%d_ch%d", icen, ipt, ieta, iphi, ich));
-              h3->Scale(1.f, "width"); // convert ntrack to probability density
-              fVecResoND[icen][ipt][ieta][iphi][ich] = h3;
-            } // end of charge loop
-          } // end of phi loop
-        } // end of eta loop
-      } // end of pt loop
-    } // end of centrality loop
+    for (int idim = 0; idim < 5; idim++) {
+      fAxesND[idim] = *hs_reso->GetAxis(idim);
+    }
+    for (int idim = 0; idim < 3; idim++) {
+      fAxesResoND[idim] = *hs_reso->GetAxis(idim + 5);
+    }
+    const int nx = fAxesResoND[0].GetNbins();
+    const int ny = fAxesResoND[1].GetNbins();
+    const int nz = fAxesResoND[2].GetNbins();
+    const int64_t nResoBins = static_cast<int64_t>(nx) * ny * nz;
+    const int nCells = fNCenBins * fNPtBins * fNEtaBins * fNPhiBins * fNChBins;
+
+    // (cell x nResoBins + reso bin, probability density) of the filled bins
+    std::vector<std::pair<int64_t, double>> entries;
+    entries.reserve(hs_reso->GetNbins());
+    std::vector<int> coord(hs_reso->GetNdimensions());
+    for (int64_t ibin = 0; ibin < hs_reso->GetNbins(); ibin++) {
+      const double content = hs_reso->GetBinContent(ibin, coord.data());
+      if (content == 0.) {
+        continue;
+      }
+      bool inRange = true;
+      for (int idim = 0; idim < 8; idim++) {
+        if (coord[idim] < 1 || coord[idim] > hs_reso->GetAxis(idim)->GetNbins()) {
+          inRange = false;
+          break;
+        }
+      }
+      if (!inRange) {
+        continue;
+      }
+      const double chCenter = hs_reso->GetAxis(4)->GetBinCenter(coord[4]);
+      if (-0.5 < chCenter && chCenter < 0.5) {
+        continue;
+      }
+      const int cell = getCellIndexND(coord[0] - 1, coord[1] - 1, coord[2] - 1, coord[3] - 1, coord[4] - 1);
+      const int64_t resoBin = (coord[5] - 1) + nx * ((coord[6] - 1) + static_cast<int64_t>(ny) * (coord[7] - 1));
+      const double volume = hs_reso->GetAxis(5)->GetBinWidth(coord[5]) * hs_reso->GetAxis(6)->GetBinWidth(coord[6]) * hs_reso->GetAxis(7)->GetBinWidth(coord[7]);
+      entries.emplace_back(cell * nResoBins + resoBin, content / volume); // convert ntrack to probability density
+    }
+    std::sort(entries.begin(), entries.end());
+
+    fResoNDOffsets.assign(nCells + 1, 0);
+    fResoNDBins.resize(entries.size());
+    fResoNDCdf.resize(entries.size());
+    for (size_t ientry = 0; ientry < entries.size(); ientry++) {
+      fResoNDOffsets[entries[ientry].first / nResoBins + 1]++;
+      fResoNDBins[ientry] = static_cast<int>(entries[ientry].first % nResoBins);
+      fResoNDCdf[ientry] = entries[ientry].second;
+    }
+    for (int cell = 0; cell < nCells; cell++) {
+      fResoNDOffsets[cell + 1] += fResoNDOffsets[cell];
+      const int64_t first = fResoNDOffsets[cell];
+      const int64_t last = fResoNDOffsets[cell + 1];
+      for (int64_t ientry = first + 1; ientry < last; ientry++) {
+        fResoNDCdf[ientry] += fResoNDCdf[ientry - 1];
+      }
+      for (int64_t ientry = first; ientry < last; ientry++) {
+        fResoNDCdf[ientry] /= fResoNDCdf[last - 1];
+      }
+    }
+    LOGF(info, "%zu filled resolution bins in %d cells", entries.size(), nCells);
+  }
+
+  int getCellIndexND(int icen, int ipt, int ieta, int iphi, int ich) const
+  {
+    return (((icen * fNPtBins + ipt) * fNEtaBins + ieta) * fNPhiBins + iphi) * fNChBins + ich;
   }
 
   void init()
@@ -229,7 +323,7 @@ class MomentumSmearer
         if (!fResoND) {
           LOGP(fatal, "Could not open {} from file {}", fResNDHistName.Data(), fResFileName.Data());
         }
-        fillVecResoND(fResoND);
+        fillTableResoND(fResoND);
       }
     } else {
       if (fResType != 0) {
@@ -252,10 +346,10 @@ class MomentumSmearer
         if (!fResoPhi_Neg) {
           LOGP(fatal, "Could not open {} from file {}", fResPhiNegHistName.Data(), fResFileName.Data());
         }
-        fillVecReso(fResoPt, fVecResoPt);
-        fillVecReso(fResoEta, fVecResoEta);
-        fillVecReso(fResoPhi_Pos, fVecResoPhi_Pos);
-        fillVecReso(fResoPhi_Neg, fVecResoPhi_Neg);
+        fillSliceTable(fResoPt, fTableResoPt);
+        fillSliceTable(fResoEta, fTableResoEta);
+        fillSliceTable(fResoPhi_Pos, fTableResoPhi_Pos);
+        fillSliceTable(fResoPhi_Neg, fTableResoPhi_Neg);
       }
     }
 
@@ -356,7 +450,7 @@ class MomentumSmearer
       if (!fDCA) {
         LOGP(fatal, "Could not open {} from file {}", fDCAHistName.Data(), fDCAFileName.Data());
       }
-      fillVecReso(fDCA, fVecDCA);
+      fillSliceTable(fDCA, fTableDCA);
     }
 
     if (!fFromCcdb) {
@@ -366,22 +460,10 @@ class MomentumSmearer
     fInitialized = true;
   }
 
-  void applySmearing(const float ptgen, const float vargen, const float multiply, float& varsmeared, TH2F* fReso, std::vector<TH1F*>& fVecReso)
+  void applySmearing(const float ptgen, const float vargen, const float multiply, float& varsmeared, SliceTable& table)
   {
     float ptgen_tmp = ptgen > fMinPtGen ? ptgen : fMinPtGen;
-    TAxis* axisPt = fReso->GetXaxis();
-    int nBinsPt = axisPt->GetNbins();
-    int ptbin = axisPt->FindBin(ptgen_tmp);
-    if (ptbin < 1) {
-      ptbin = 1;
-    }
-    if (ptbin > nBinsPt) {
-      ptbin = nBinsPt;
-    }
-    float smearing = 0.;
-    if (fVecReso[ptbin - 1]->GetEntries() > 0) {
-      smearing = fVecReso[ptbin - 1]->GetRandom() * multiply;
-    }
+    float smearing = sampleSliceTable(table, ptgen_tmp) * multiply;
     varsmeared = vargen - smearing;
   }
 
@@ -403,12 +485,12 @@ class MomentumSmearer
       }
       applySmearingND(centrality, ch, ptgen, etagen, phigen, ptsmeared, etasmeared, phismeared);
     } else {
-      applySmearing(ptgen, ptgen, ptgen, ptsmeared, fResoPt, fVecResoPt);
-      applySmearing(ptgen, etagen, 1., etasmeared, fResoEta, fVecResoEta);
+      applySmearing(ptgen, ptgen, ptgen, ptsmeared, fTableResoPt);
+      applySmearing(ptgen, etagen, 1., etasmeared, fTableResoEta);
       if (ch > 0) {
-        applySmearing(ptgen, phigen, 1., phismeared, fResoPhi_Pos, fVecResoPhi_Pos);
+        applySmearing(ptgen, phigen, 1., phismeared, fTableResoPhi_Pos);
       } else {
-        applySmearing(ptgen, phigen, 1., phismeared, fResoPhi_Neg, fVecResoPhi_Neg);
+        applySmearing(ptgen, phigen, 1., phismeared, fTableResoPhi_Neg);
       }
     }
   }
@@ -416,11 +498,11 @@ class MomentumSmearer
   void applySmearingND(const float centrality, const int ch, const float ptgen, const float etagen, const float phigen, float& ptsmeared, float& etasmeared, float& phismeared)
   {
     float ptgen_tmp = ptgen > fMinPtGen ? ptgen : fMinPtGen;
-    int cenbin = fResoND->GetAxis(0)->FindBin(centrality);
-    int ptbin = fResoND->GetAxis(1)->FindBin(ptgen_tmp);
-    int etabin = fResoND->GetAxis(2)->FindBin(etagen);
-    int phibin = fResoND->GetAxis(3)->FindBin(phigen);
-    int chbin = fResoND->GetAxis(4)->FindBin(ch);
+    int cenbin = fAxesND[0].FindBin(centrality);
+    int ptbin = fAxesND[1].FindBin(ptgen_tmp);
+    int etabin = fAxesND[2].FindBin(etagen);
+    int phibin = fAxesND[3].FindBin(phigen);
+    int chbin = fAxesND[4].FindBin(ch);
 
     // protection
     if (cenbin < 1) {
@@ -458,8 +540,27 @@ class MomentumSmearer
     }
 
     double dpt_rel = 0, deta = 0, dphi = 0;
-    if (fVecResoND[cenbin - 1][ptbin - 1][etabin - 1][phibin - 1][chbin - 1]->GetEntries() > 0) {
-      fVecResoND[cenbin - 1][ptbin - 1][etabin - 1][phibin - 1][chbin - 1]->GetRandom3(dpt_rel, deta, dphi);
+    const int cell = getCellIndexND(cenbin - 1, ptbin - 1, etabin - 1, phibin - 1, chbin - 1);
+    const int64_t first = fResoNDOffsets[cell];
+    const int64_t last = fResoNDOffsets[cell + 1];
+    if (last > first) {
+      // same sampling as TH3::GetRandom3 of the cell projection
+      const double r1 = gRandom->Rndm();
+      const double* cdf = fResoNDCdf.data();
+      int64_t ientry = std::upper_bound(cdf + first, cdf + last, r1) - cdf;
+      ientry = std::min(ientry, last - 1);
+      const double cdfLow = ientry > first ? cdf[ientry - 1] : 0.;
+      const int nx = fAxesResoND[0].GetNbins();
+      const int ny = fAxesResoND[1].GetNbins();
+      const int binz = fResoNDBins[ientry] / (nx * ny);
+      const int biny = (fResoNDBins[ientry] - nx * ny * binz) / nx;
+      const int binx = fResoNDBins[ientry] - nx * (biny + ny * binz);
+      dpt_rel = fAxesResoND[0].GetBinLowEdge(binx + 1);
+      if (r1 > cdfLow) {
+        dpt_rel += fAxesResoND[0].GetBinWidth(binx + 1) * (r1 - cdfLow) / (cdf[ientry] - cdfLow);
+      }
+      deta = fAxesResoND[1].GetBinLowEdge(biny + 1) + fAxesResoND[1].GetBinWidth(biny + 1) * gRandom->Rndm();
+      dphi = fAxesResoND[2].GetBinLowEdge(binz + 1) + fAxesResoND[2].GetBinWidth(binz + 1) * gRandom->Rndm();
     }
     ptsmeared = ptgen - dpt_rel * ptgen;
     etasmeared = etagen - deta;
@@ -537,20 +638,7 @@ class MomentumSmearer
       return 0.;
     }
 
-    TAxis* axisPt = fDCA->GetXaxis();
-    int nBinsPt = axisPt->GetNbins();
-    int ptbin = axisPt->FindBin(ptsmeared);
-    if (ptbin < 1) {
-      ptbin = 1;
-    }
-    if (ptbin > nBinsPt) {
-      ptbin = nBinsPt;
-    }
-    float dca = 0.;
-    if (fVecDCA[ptbin - 1]->GetEntries() > 0) {
-      dca = fVecDCA[ptbin - 1]->GetRandom();
-    }
-    return dca;
+    return sampleSliceTable(fTableDCA, ptsmeared);
   }
 
   // setters
@@ -622,19 +710,23 @@ class MomentumSmearer
   TH2F* fResoEta;
   TH2F* fResoPhi_Pos;
   TH2F* fResoPhi_Neg;
-  std::vector<std::vector<std::vector<std::vector<std::vector<TH3D*>>>>> fVecResoND;
+  TAxis fAxesND[5];                    // cent, pt, eta, phi, charge axes of the ND resolution
+  TAxis fAxesResoND[3];                // dpt/pt, deta, dphi axes of the ND resolution
+  std::vector<int64_t> fResoNDOffsets; // first table entry of each (cent, pt, eta, phi, charge) cell
+  std::vector<int> fResoNDBins;        // (dpt/pt, deta, dphi) bin of each table entry
+  std::vector<double> fResoNDCdf;      // normalised cumulative probability of each table entry within its cell
   int fNCenBins = 1;
   int fNPtBins = 1;
   int fNEtaBins = 1;
   int fNPhiBins = 1;
   int fNChBins = 1;
-  std::vector<TH1F*> fVecResoPt;
-  std::vector<TH1F*> fVecResoEta;
-  std::vector<TH1F*> fVecResoPhi_Pos;
-  std::vector<TH1F*> fVecResoPhi_Neg;
+  SliceTable fTableResoPt;
+  SliceTable fTableResoEta;
+  SliceTable fTableResoPhi_Pos;
+  SliceTable fTableResoPhi_Neg;
   TObject* fEff;
   TH2F* fDCA;
-  std::vector<TH1F*> fVecDCA;
+  SliceTable fTableDCA;
   int64_t fTimestamp;
   bool fFromCcdb = false;
   Service<ccdb::BasicCCDBManager> fCcdb;
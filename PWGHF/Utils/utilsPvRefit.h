@@ -0,0 +1,186 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file utilsPvRefit.h
+/// \brief Primary-vertex refit excluding up to three tracks, prepared once per collision
+
+#ifndef PWGHF_UTILS_UTILSPVREFIT_H_
+#define PWGHF_UTILS_UTILSPVREFIT_H_
+
+#include <algorithm>     // std::sort
+#include <array>         // std::array
+#include <cstdint>       // int64_t, uint64_t
+#include <unordered_map> // std::unordered_map
+#include <vector>        // std::vector
+
+#include "CommonUtils/ConfigurableParam.h"
+#include "DetectorsBase/Propagator.h"
+#include "DetectorsVertexing/PVertexer.h"
+#include "ReconstructionDataFormats/PrimaryVertex.h"
+#include "ReconstructionDataFormats/Track.h"
+#include "ReconstructionDataFormats/Vertex.h"
+
+#include "Common/Core/trackUtilities.h"
+
+namespace o2::hf_pv_refit
+{
+/// \brief Service for the refit of the primary vertex of a collision excluding one, two or three of its contributors
+///
+/// The PVertexer is configured once per magnetic field and the contributors of a collision are prepared once
+/// (PVertexer::prepareVertexRefit). Each leave-k-out refit then only masks the removed contributors, found with
+/// a hash lookup. The refits which are reused, i.e. without a single track (track tagging and candidates with a single
+/// contributor daughter) or a track pair (shared by 2- and 3-prong candidates), are cached per collision, up to
+/// MaxCachedRefits vertices; refits without three tracks are rarely repeated and are not cached.
+class PvRefitter
+{
+ public:
+  static constexpr int NotAContributor = -1;
+  static constexpr int MaxTracksToRemove = 3;
+  static constexpr std::size_t MaxCachedRefits = 8192; ///< bound of the refit cache, per collision
+
+  PvRefitter() = default;
+
+  /// Prepares the vertex refit for a new collision
+  /// \param collision is the collision whose vertex is refitted
+  /// \param tracks are the tracks of the collision, only PV contributors are considered
+  /// \return true if the refit is doable
+  template <typename TCollision, typename TTracks>
+  bool prepare(TCollision const& collision, TTracks const& tracks)
+  {
+    initVertexer();
+
+    mContributorGlobIds.clear();
+    mContributorTrackParCovs.clear();
+    mContributorEntries.clear();
+    mRefitCache.clear();
+    mRefitCache.reserve(std::min<std::size_t>(tracks.size(), MaxCachedRefits)); // at least the single-track refits
+    for (const auto& track : tracks) {
+      if (!track.isPVContributor()) {
+        continue;
+      }
+      mContributorEntries.emplace(track.globalIndex(), static_cast<int>(mContributorGlobIds.size()));
+      mContributorGlobIds.push_back(track.globalIndex());
+      mContributorTrackParCovs.push_back(getTrackParCov(track));
+    }
+    mContributorUsed.assign(mContributorGlobIds.size(), true);
+
+    mPrimVtx.setX(collision.posX());
+    mPrimVtx.setY(collision.posY());
+    mPrimVtx.setZ(collision.posZ());
+    mPrimVtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
+    mIsRefitDoable = mVertexer.prepareVertexRefit(mContributorTrackParCovs, mPrimVtx);
+    return mIsRefitDoable;
+  }
+
+  /// \return the index of the track in the list of contributors, or NotAContributor
+  int getContributorEntry(int64_t globalIndex) const
+  {
+    auto entry = mContributorEntries.find(globalIndex);
+    return entry == mContributorEntries.end() ? NotAContributor : entry->second;
+  }
+
+  /// \return true if the track contributed to the original primary vertex
+  bool isContributor(int64_t globalIndex) const { return getContributorEntry(globalIndex) != NotAContributor; }
+
+  /// Refits the primary vertex excluding the given tracks; tracks that are not contributors are ignored
+  /// \param globalIndices are the global indices of the tracks to be removed (at most MaxTracksToRemove)
+  /// \param nRemoved is set to the number of contributors removed from the fit
+  /// \return the refitted vertex, valid until the next refit or collision
+  o2::dataformats::PrimaryVertex const& refitWithout(std::vector<int64_t> const& globalIndices, int& nRemoved)
+  {
+    std::array<int, MaxTracksToRemove> entries{};
+    nRemoved = 0;
+    for (const auto& globalIndex : globalIndices) {
+      const int entry = getContributorEntry(globalIndex);
+      if (entry != NotAContributor && nRemoved < MaxTracksToRemove) {
+        entries[nRemoved++] = entry;
+      }
+    }
+    std::sort(entries.begin(), entries.begin() + nRemoved);
+    return refitWithoutEntries(entries, nRemoved);
+  }
+
+  /// Refits the primary vertex excluding a single track, ignored if it is not a contributor
+  /// \param globalIndex is the global index of the track to be removed
+  /// \param nRemoved is set to the number of contributors removed from the fit
+  /// \return the refitted vertex, valid until the next refit or collision
+  o2::dataformats::PrimaryVertex const& refitWithout(int64_t globalIndex, int& nRemoved)
+  {
+    std::array<int, MaxTracksToRemove> entries{};
+    const int entry = getContributorEntry(globalIndex);
+    nRemoved = entry != NotAContributor ? 1 : 0;
+    entries[0] = entry;
+    return refitWithoutEntries(entries, nRemoved);
+  }
+
+  bool isRefitDoable() const { return mIsRefitDoable; }
+  std::size_t getNContributors() const { return mContributorGlobIds.size(); }
+  o2::dataformats::VertexBase const& getPrimaryVertex() const { return mPrimVtx; }
+
+ private:
+  /// Refits the primary vertex without the given contributors
+  /// \param entries are the sorted entries of the removed contributors
+  o2::dataformats::PrimaryVertex const& refitWithoutEntries(std::array<int, MaxTracksToRemove> const& entries, int nRemoved)
+  {
+    // key of the removed contributors, independent of their order
+    const bool isCached = nRemoved < MaxTracksToRemove;
+    uint64_t key = nRemoved;
+    for (int iEntry = 0; iEntry < nRemoved; ++iEntry) {
+      key |= static_cast<uint64_t>(entries[iEntry] + 1) << (2 + 20 * iEntry);
+    }
+    if (isCached) {
+      auto cached = mRefitCache.find(key);
+      if (cached != mRefitCache.end()) {
+        return cached->second;
+      }
+    }
+
+    for (int iEntry = 0; iEntry < nRemoved; ++iEntry) {
+      mContributorUsed[entries[iEntry]] = false;
+    }
+    mLastRefit = mVertexer.refitVertex(mContributorUsed, mPrimVtx);
+    for (int iEntry = 0; iEntry < nRemoved; ++iEntry) {
+      mContributorUsed[entries[iEntry]] = true; // restore the contributors for the next refit
+    }
+    if (isCached && mRefitCache.size() < MaxCachedRefits) {
+      return mRefitCache.emplace(key, mLastRefit).first->second;
+    }
+    return mLastRefit;
+  }
+
+  /// Configures the vertexer, needed again whenever the magnetic field changes
+  void initVertexer()
+  {
+    const float bz = o2::base::Propagator::Instance()->getNominalBz();
+    if (mIsVertexerInitialised && bz == mBz) {
+      return;
+    }
+    o2::conf::ConfigurableParam::updateFromString("pvertexer.useMeanVertexConstraint=false"); /// remove diamond constraint (let's keep it at the moment...)
+    mVertexer.init();
+    mBz = bz;
+    mIsVertexerInitialised = true;
+  }
+
+  o2::vertexing::PVertexer mVertexer;                                       ///< vertexer, configured once per magnetic field
+  o2::dataformats::VertexBase mPrimVtx;                                     ///< original primary vertex of the current collision
+  std::vector<int64_t> mContributorGlobIds;                                 ///< global indices of the PV contributors
+  std::vector<o2::track::TrackParCov> mContributorTrackParCovs;             ///< TrackParCov of the PV contributors
+  std::vector<bool> mContributorUsed;                                       ///< contributors used in the refit
+  std::unordered_map<int64_t, int> mContributorEntries;                     ///< global index -> entry in the contributor list
+  std::unordered_map<uint64_t, o2::dataformats::PrimaryVertex> mRefitCache; ///< refitted vertices per single track or pair of removed contributors
+  o2::dataformats::PrimaryVertex mLastRefit;                                ///< last refitted vertex, returned when not cached
+  float mBz{0.f};                                                           ///< magnetic field used to configure the vertexer
+  bool mIsVertexerInitialised{false};                                       ///< whether the vertexer was configured
+  bool mIsRefitDoable{false};                                               ///< whether the refit is doable for the current collision
+};
+} // namespace o2::hf_pv_refit
+
+#endif // PWGHF_UTILS_UTILSPVREFIT_H_
@@ -42,7 +42,11 @@ void JetFinder::setParams()
     jetDef.set_extra_param(fastjetExtraParam);
   }
   jetDef.set_jet_algorithm(algorithm);
-  areaDef = fastjet::AreaDefinition(areaType, ghostAreaSpec);
+  if (areaType == fastjet::voronoi_area) {
+    areaDef = fastjet::AreaDefinition(fastjet::VoronoiAreaSpec(voronoiRfact)); // Voronoi areas need no ghosts
+  } else {
+    areaDef = fastjet::AreaDefinition(areaType, ghostAreaSpec);
+  }
   selJets = fastjet::SelectorPtRange(jetPtMin, jetPtMax) && fastjet::SelectorEtaRange(jetEtaMin, jetEtaMax) && fastjet::SelectorPhiRange(jetPhiMin, jetPhiMax);
 }
 
@@ -67,6 +67,7 @@ class JetFinder
   float ghostArea = .005;
   int ghostRepeatN = 1;
   double ghostktMean = 1.e-100;
+  float voronoiRfact = 1.;
   float gridScatter = 1.;
   float ktScatter = .1;
 
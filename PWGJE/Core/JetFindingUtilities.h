@@ -18,6 +18,7 @@
 #define PWGJE_CORE_JETFINDINGUTILITIES_H_
 
 #include <array>
+#include <chrono>
 #include <vector>
 #include <string>
 #include <optional>
@@ -274,16 +275,20 @@ bool analyseV0s(std::vector<fastjet::PseudoJet>& inputParticles, T const& v0s, f
  * @param jetsTable output table of jets
  * @param constituentsTable output table of jet constituents
  * @param doHFJetFinding set whether only jets containing a HF candidate are saved
+ * @param histClusteringTime optional histogram filled with the time (in microseconds) spent finding the jets of all radii in the event
  */
 template <typename T, typename U, typename V>
-void findJets(JetFinder& jetFinder, std::vector<fastjet::PseudoJet>& inputParticles, float jetPtMin, float jetPtMax, std::vector<double> jetRadius, float jetAreaFractionMin, T const& collision, U& jetsTable, V& constituentsTable, std::shared_ptr<THn> thnSparseJet, bool fillThnSparse, bool doCandidateJetFinding = false)
+void findJets(JetFinder& jetFinder, std::vector<fastjet::PseudoJet>& inputParticles, float jetPtMin, float jetPtMax, std::vector<double> jetRadius, float jetAreaFractionMin, T const& collision, U& jetsTable, V& constituentsTable, std::shared_ptr<THn> thnSparseJet, bool fillThnSparse, bool doCandidateJetFinding = false, std::shared_ptr<TH1> histClusteringTime = nullptr)
 {
-  auto jetRValues = static_cast<std::vector<double>>(jetRadius);
+  auto clusteringStart = std::chrono::steady_clock::now();
   jetFinder.jetPtMin = jetPtMin;
   jetFinder.jetPtMax = jetPtMax;
-  for (auto R : jetRValues) {
+  std::vector<fastjet::PseudoJet> jets;
+  std::vector<int> tracks;
+  std::vector<int> cands;
+  std::vector<int> clusters;
+  for (auto R : jetRadius) {
     jetFinder.jetR = R;
-    std::vector<fastjet::PseudoJet> jets;
     fastjet::ClusterSequenceArea clusterSeq(jetFinder.findJets(inputParticles, jets));
     for (const auto& jet : jets) {
       if (jet.has_area() && jet.area() < jetAreaFractionMin * M_PI * R * R) {
@@ -305,25 +310,29 @@ void findJets(JetFinder& jetFinder, std::vector<fastjet::PseudoJet>& inputPartic
           continue;
         }
       }
-      std::vector<int> tracks;
-      std::vector<int> cands;
-      std::vector<int> clusters;
+      tracks.clear();
+      cands.clear();
+      clusters.clear();
       jetsTable(collision.globalIndex(), jet.pt(), jet.eta(), jet.phi(),
                 jet.E(), jet.rapidity(), jet.m(), jet.has_area() ? jet.area() : 0., std::round(R * 100));
       for (const auto& constituent : sorted_by_pt(jet.constituents())) {
-        if (constituent.template user_info<fastjetutilities::fastjet_user_info>().getStatus() == static_cast<int>(JetConstituentStatus::track)) {
-          tracks.push_back(constituent.template user_info<fastjetutilities::fastjet_user_info>().getIndex());
+        const auto& constituentInfo = constituent.template user_info<fastjetutilities::fastjet_user_info>();
+        if (constituentInfo.getStatus() == static_cast<int>(JetConstituentStatus::track)) {
+          tracks.push_back(constituentInfo.getIndex());
         }
-        if (constituent.template user_info<fastjetutilities::fastjet_user_info>().getStatus() == static_cast<int>(JetConstituentStatus::cluster)) {
-          clusters.push_back(constituent.template user_info<fastjetutilities::fastjet_user_info>().getIndex());
+        if (constituentInfo.getStatus() == static_cast<int>(JetConstituentStatus::cluster)) {
+          clusters.push_back(constituentInfo.getIndex());
         }
-        if (constituent.template user_info<fastjetutilities::fastjet_user_info>().getStatus() == static_cast<int>(JetConstituentStatus::candidate)) {
-          cands.push_back(constituent.template user_info<fastjetutilities::fastjet_user_info>().getIndex());
+        if (constituentInfo.getStatus() == static_cast<int>(JetConstituentStatus::candidate)) {
+          cands.push_back(constituentInfo.getIndex());
         }
       }
       constituentsTable(jetsTable.lastIndex(), tracks, clusters, cands);
     }
   }
+  if (histClusteringTime) {
+    histClusteringTime->Fill(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - clusteringStart).count());
+  }
 }
 
 /**
@@ -26,6 +26,7 @@
 #include <optional>
 #include <tuple>
 #include <algorithm>
+#include <unordered_set>
 
 #include "Framework/AnalysisTask.h"
 #include "Framework/AnalysisDataModel.h"
@@ -413,6 +414,53 @@ auto constexpr getConstituentId(T const& track)
   }
 }
 
+// pT of the candidate shared by the base and tag jets (only one candidate per jet)
+template <bool jetsBaseIsMc, bool jetsTagIsMc, typename U, typename P, typename R, typename S>
+float getPtSumCandidates(U const& candidatesBase, P const& candidatesTag, R const& fullTracksBase, S const& fullTracksTag)
+{
+  float ptSum = 0.;
+  if constexpr (jetsTagIsMc) {
+    for (auto const& candidateBase : candidatesBase) {
+      if (jetcandidateutilities::isMatchedCandidate(candidateBase)) {
+        const auto candidateBaseMcId = jetcandidateutilities::matchedParticleId(candidateBase, fullTracksBase, fullTracksTag);
+        for (auto const& candidateTag : candidatesTag) {
+          const auto candidateTagId = candidateTag.mcParticleId();
+          if (candidateBaseMcId == candidateTagId) {
+            ptSum += candidateBase.pt();
+          }
+          break; // should only be one
+        }
+      }
+      break;
+    }
+  } else if constexpr (jetsBaseIsMc) {
+    for (auto const& candidateTag : candidatesTag) {
+      if (jetcandidateutilities::isMatchedCandidate(candidateTag)) {
+        const auto candidateTagMcId = jetcandidateutilities::matchedParticleId(candidateTag, fullTracksTag, fullTracksBase);
+        for (auto const& candidateBase : candidatesBase) {
+          const auto candidateBaseId = candidateBase.mcParticleId();
+          if (candidateTagMcId == candidateBaseId) {
+            ptSum += candidateTag.pt();
+          }
+          break; // should only be one
+        }
+      }
+      break;
+    }
+  } else {
+    for (auto const& candidateBase : candidatesBase) {
+      for (auto const& candidateTag : candidatesTag) {
+        if (candidateBase.globalIndex() == candidateTag.globalIndex()) {
+          ptSum += candidateBase.pt();
+        }
+        break; // should only be one
+      }
+      break;
+    }
+  }
+  return ptSum;
+}
+
 template <bool isEMCAL, bool isCandidate, bool jetsBaseIsMc, bool jetsTagIsMc, typename T, typename U, typename V, typename O, typename P, typename Q, typename R, typename S>
 float getPtSum(T const& tracksBase, U const& candidatesBase, V const& clustersBase, O const& tracksTag, P const& candidatesTag, Q const& clustersTag, R const& fullTracksBase, S const& fullTracksTag)
 {
@@ -472,45 +520,7 @@ float getPtSum(T const& tracksBase, U const& candidatesBase, V const& clustersBa
     }
   }
   if constexpr (isCandidate) {
-    if constexpr (jetsTagIsMc) {
-      for (auto const& candidateBase : candidatesBase) {
-        if (jetcandidateutilities::isMatchedCandidate(candidateBase)) {
-          const auto candidateBaseMcId = jetcandidateutilities::matchedParticleId(candidateBase, fullTracksBase, fullTracksTag);
-          for (auto const& candidateTag : candidatesTag) {
-            const auto candidateTagId = candidateTag.mcParticleId();
-            if (candidateBaseMcId == candidateTagId) {
-              ptSum += candidateBase.pt();
-            }
-            break; // should only be one
-          }
-        }
-        break;
-      }
-    } else if constexpr (jetsBaseIsMc) {
-      for (auto const& candidateTag : candidatesTag) {
-        if (jetcandidateutilities::isMatchedCandidate(candidateTag)) {
-          const auto candidateTagMcId = jetcandidateutilities::matchedParticleId(candidateTag, fullTracksTag, fullTracksBase);
-          for (auto const& candidateBase : candidatesBase) {
-            const auto candidateBaseId = candidateBase.mcParticleId();
-            if (candidateTagMcId == candidateBaseId) {
-              ptSum += candidateTag.pt();
-            }
-            break; // should only be one
-          }
-        }
-        break;
-      }
-    } else {
-      for (auto const& candidateBase : candidatesBase) {
-        for (auto const& candidateTag : candidatesTag) {
-          if (candidateBase.globalIndex() == candidateTag.globalIndex()) {
-            ptSum += candidateBase.pt();
-          }
-          break; // should only be one
-        }
-        break;
-      }
-    }
+    ptSum += getPtSumCandidates<jetsBaseIsMc, jetsTagIsMc>(candidatesBase, candidatesTag, fullTracksBase, fullTracksTag);
   }
   return ptSum;
 }
@@ -529,46 +539,200 @@ auto getConstituents(T const& jet, U const& /*constituents*/)
   }
 }
 
-template <bool jetsBaseIsMc, bool jetsTagIsMc, typename T, typename U, typename V, typename M, typename N, typename O, typename P, typename Q>
-void MatchPt(T const& jetsBasePerCollision, U const& jetsTagPerCollision, std::vector<std::vector<int>>& baseToTagMatchingPt, std::vector<std::vector<int>>& tagToBaseMatchingPt, V const& tracksBase, M const& candidatesBase, N const& clustersBase, O const& tracksTag, P const& candidatesTag, Q const& clustersTag, float minPtFraction)
+// constituents of a jet indexed for the pT matching, so that the constituents shared with another jet are found with hash lookups
+struct JetConstituentIndex {
+  std::vector<int64_t> trackIds;                        // constituent ids of the tracks (see getConstituentId), in the jet order
+  std::vector<int64_t> trackGlobalIds;                  // global indices of the tracks, in the jet order
+  std::vector<float> trackPts;                          // pT of the tracks, in the jet order
+  std::vector<std::vector<int64_t>> clusterParticleIds; // MC particles of the clusters, in the jet order
+  std::vector<float> clusterPts;                        // pT of the clusters, in the jet order
+  std::unordered_set<int64_t> trackIdSet;               // constituent ids of the tracks
+  std::unordered_set<int64_t> trackGlobalIdSet;         // global indices of the tracks
+  std::unordered_set<int64_t> clusterParticleIdSet;     // MC particles of all the clusters
+
+  void clear()
+  {
+    trackIds.clear();
+    trackGlobalIds.clear();
+    trackPts.clear();
+    clusterParticleIds.clear();
+    clusterPts.clear();
+    trackIdSet.clear();
+    trackGlobalIdSet.clear();
+    clusterParticleIdSet.clear();
+  }
+};
+
+// fills the constituent index of a jet; otherJetsAreMc sets how the constituent ids are defined, as in getPtSum
+template <bool isEMCAL, bool otherJetsAreMc, typename T, typename U, typename V>
+void fillJetConstituentIndex(T const& jet, U const& tracks, V const& clusters, JetConstituentIndex& index)
+{
+  index.clear();
+  for (const auto& track : getConstituents(jet, tracks)) {
+    int64_t trackId = getConstituentId<otherJetsAreMc>(track);
+    index.trackIds.push_back(trackId);
+    index.trackGlobalIds.push_back(track.globalIndex());
+    index.trackPts.push_back(track.pt());
+    index.trackIdSet.insert(trackId);
+    index.trackGlobalIdSet.insert(track.globalIndex());
+  }
+  if constexpr (isEMCAL && otherJetsAreMc) { // clusters only contribute when matching to MC jets
+    for (const auto& cluster : getConstituents(jet, clusters)) {
+      std::vector<int64_t> clusterParticleIds;
+      for (const auto& clusterParticleId : cluster.mcParticlesIds()) {
+        clusterParticleIds.push_back(clusterParticleId);
+        index.clusterParticleIdSet.insert(clusterParticleId);
+      }
+      index.clusterParticleIds.push_back(clusterParticleIds);
+      index.clusterPts.push_back(cluster.energy() / std::cosh(cluster.eta()));
+    }
+  }
+}
+
+// same as the track and cluster parts of getPtSum, using the constituent indices of the two jets
+template <bool isEMCAL, bool jetsBaseIsMc, bool jetsTagIsMc>
+float getPtSumFromIndex(JetConstituentIndex const& base, JetConstituentIndex const& tag, std::unordered_set<int64_t>& particleTracker)
+{
+  particleTracker.clear();
+  float ptSum = 0.;
+  for (std::size_t iTrack = 0; iTrack < base.trackIds.size(); iTrack++) {
+    auto trackBaseId = base.trackIds[iTrack];
+    if (trackBaseId != -1 && tag.trackIdSet.count(trackBaseId)) {
+      ptSum += base.trackPts[iTrack];
+      if constexpr (jetsBaseIsMc) {
+        particleTracker.insert(trackBaseId);
+      }
+    }
+  }
+  if constexpr (isEMCAL) {
+    if constexpr (jetsTagIsMc) {
+      for (std::size_t iCluster = 0; iCluster < base.clusterPts.size(); iCluster++) {
+        for (const auto& clusterBaseParticleId : base.clusterParticleIds[iCluster]) {
+          if (clusterBaseParticleId != -1 && tag.trackGlobalIdSet.count(clusterBaseParticleId)) {
+            ptSum += base.clusterPts[iCluster];
+            break;
+          }
+        }
+      }
+    }
+    if constexpr (jetsBaseIsMc) {
+      for (std::size_t iTrack = 0; iTrack < base.trackGlobalIds.size(); iTrack++) {
+        auto trackBaseId = base.trackGlobalIds[iTrack];
+        if (particleTracker.count(trackBaseId)) {
+          continue;
+        }
+        if (trackBaseId != -1 && tag.clusterParticleIdSet.count(trackBaseId)) {
+          ptSum += base.trackPts[iTrack];
+        }
+      }
+    }
+  }
+  return ptSum;
+}
+
+// computes the pT shared in both directions for the selected pairs of jets with the same R, the constituents of each jet are indexed once per collision
+template <bool jetsBaseIsMc, bool jetsTagIsMc, typename T, typename U, typename V, typename M, typename N, typename O, typename P, typename Q, typename S, typename F>
+void forEachJetPairPtSum(T const& jetsBasePerCollision, U const& jetsTagPerCollision, V const& tracksBase, M const& candidatesBase, N const& clustersBase, O const& tracksTag, P const& candidatesTag, Q const& clustersTag, S&& isPairSelected, F&& processPair)
 {
-  float ptSumBase;
-  float ptSumTag;
+  constexpr bool isEMCAL = jetfindingutilities::isEMCALClusterTable<N>() || jetfindingutilities::isEMCALClusterTable<Q>();
+  constexpr bool isCandidate = (jetcandidateutilities::isCandidateTable<M>() || jetcandidateutilities::isCandidateMcTable<M>()) && (jetcandidateutilities::isCandidateTable<P>() || jetcandidateutilities::isCandidateMcTable<P>());
+
+  std::vector<JetConstituentIndex> tagIndices(jetsTagPerCollision.size());
+  int tagIndex = 0;
+  for (const auto& jetTag : jetsTagPerCollision) {
+    fillJetConstituentIndex<isEMCAL, jetsBaseIsMc>(jetTag, tracksTag, clustersTag, tagIndices[tagIndex++]);
+  }
+  JetConstituentIndex baseIndex;
+  std::unordered_set<int64_t> particleTracker;
   for (const auto& jetBase : jetsBasePerCollision) {
-    auto jetBaseTracks = getConstituents(jetBase, tracksBase);
-    auto jetBaseClusters = getConstituents(jetBase, clustersBase);
-    auto jetBaseCandidates = getConstituents(jetBase, candidatesBase);
+    fillJetConstituentIndex<isEMCAL, jetsTagIsMc>(jetBase, tracksBase, clustersBase, baseIndex);
+    tagIndex = -1;
     for (const auto& jetTag : jetsTagPerCollision) {
+      tagIndex++;
       if (std::round(jetBase.r()) != std::round(jetTag.r())) {
         continue;
       }
-      auto jetTagTracks = getConstituents(jetTag, tracksTag);
-      auto jetTagClusters = getConstituents(jetTag, clustersTag);
-      auto jetTagCandidates = getConstituents(jetTag, candidatesTag);
+      if (!isPairSelected(jetBase, jetTag)) {
+        continue;
+      }
+      float ptSumBase = getPtSumFromIndex<isEMCAL, jetsBaseIsMc, jetsTagIsMc>(baseIndex, tagIndices[tagIndex], particleTracker);
+      float ptSumTag = getPtSumFromIndex<isEMCAL, jetsTagIsMc, jetsBaseIsMc>(tagIndices[tagIndex], baseIndex, particleTracker);
+      if constexpr (isCandidate) {
+        auto jetBaseCandidates = getConstituents(jetBase, candidatesBase);
+        auto jetTagCandidates = getConstituents(jetTag, candidatesTag);
+        ptSumBase += getPtSumCandidates<jetsBaseIsMc, jetsTagIsMc>(jetBaseCandidates, jetTagCandidates, tracksBase, tracksTag);
+        ptSumTag += getPtSumCandidates<jetsTagIsMc, jetsBaseIsMc>(jetTagCandidates, jetBaseCandidates, tracksTag, tracksBase);
+      }
+      processPair(jetBase, jetTag, ptSumBase, ptSumTag);
+    }
+  }
+}
 
-      ptSumBase = getPtSum < jetfindingutilities::isEMCALClusterTable<N>() || jetfindingutilities::isEMCALClusterTable<Q>(), (jetcandidateutilities::isCandidateTable<M>() || jetcandidateutilities::isCandidateMcTable<M>()) && (jetcandidateutilities::isCandidateTable<P>() || jetcandidateutilities::isCandidateMcTable<P>()), jetsBaseIsMc, jetsTagIsMc > (jetBaseTracks, jetBaseCandidates, jetBaseClusters, jetTagTracks, jetTagCandidates, jetTagClusters, tracksBase, tracksTag);
-      ptSumTag = getPtSum < jetfindingutilities::isEMCALClusterTable<N>() || jetfindingutilities::isEMCALClusterTable<Q>(), (jetcandidateutilities::isCandidateTable<M>() || jetcandidateutilities::isCandidateMcTable<M>()) && (jetcandidateutilities::isCandidateTable<P>() || jetcandidateutilities::isCandidateMcTable<P>()), jetsTagIsMc, jetsBaseIsMc > (jetTagTracks, jetTagCandidates, jetTagClusters, jetBaseTracks, jetBaseCandidates, jetBaseClusters, tracksTag, tracksBase);
+template <bool jetsBaseIsMc, bool jetsTagIsMc, typename T, typename U, typename V, typename M, typename N, typename O, typename P, typename Q>
+void MatchPt(T const& jetsBasePerCollision, U const& jetsTagPerCollision, std::vector<std::vector<int>>& baseToTagMatchingPt, std::vector<std::vector<int>>& tagToBaseMatchingPt, V const& tracksBase, M const& candidatesBase, N const& clustersBase, O const& tracksTag, P const& candidatesTag, Q const& clustersTag, float minPtFraction)
+{
+  forEachJetPairPtSum<jetsBaseIsMc, jetsTagIsMc>(
+    jetsBasePerCollision, jetsTagPerCollision, tracksBase, candidatesBase, clustersBase, tracksTag, candidatesTag, clustersTag,
+    [](const auto& /*jetBase*/, const auto& /*jetTag*/) { return true; },
+    [&](const auto& jetBase, const auto& jetTag, float ptSumBase, float ptSumTag) {
       if (ptSumBase > jetBase.pt() * minPtFraction) {
         baseToTagMatchingPt[jetBase.globalIndex()].push_back(jetTag.globalIndex());
       }
       if (ptSumTag > jetTag.pt() * minPtFraction) {
         tagToBaseMatchingPt[jetTag.globalIndex()].push_back(jetBase.globalIndex());
       }
-    }
-  }
+    });
+}
+
+// combined geometrical and pT matching: the geometrical matches are filled as with MatchGeo, and the pT matches are only searched among them,
+// so that the pT shared is computed for the pairs found by the KD-tree search of MatchGeo instead of all the pairs of jets
+template <bool jetsBaseIsMc, bool jetsTagIsMc, typename T, typename U, typename V, typename M, typename N, typename O, typename P, typename Q>
+void MatchGeoPt(T const& jetsBasePerCollision, U const& jetsTagPerCollision, std::vector<std::vector<int>>& baseToTagMatchingGeo, std::vector<std::vector<int>>& tagToBaseMatchingGeo, std::vector<std::vector<int>>& baseToTagMatchingPt, std::vector<std::vector<int>>& tagToBaseMatchingPt, V const& tracksBase, M const& candidatesBase, N const& clustersBase, O const& tracksTag, P const& candidatesTag, Q const& clustersTag, float maxMatchingDistance, float minPtFraction)
+{
+  MatchGeo(jetsBasePerCollision, jetsTagPerCollision, baseToTagMatchingGeo, tagToBaseMatchingGeo, maxMatchingDistance);
+  auto isMatched = [](const std::vector<int>& matches, int jetIndex) {
+    return std::find(matches.begin(), matches.end(), jetIndex) != matches.end();
+  };
+
+  forEachJetPairPtSum<jetsBaseIsMc, jetsTagIsMc>(
+    jetsBasePerCollision, jetsTagPerCollision, tracksBase, candidatesBase, clustersBase, tracksTag, candidatesTag, clustersTag,
+    [&](const auto& jetBase, const auto& jetTag) {
+      return isMatched(baseToTagMatchingGeo[jetBase.globalIndex()], jetTag.globalIndex()) || isMatched(tagToBaseMatchingGeo[jetTag.globalIndex()], jetBase.globalIndex());
+    },
+    [&](const auto& jetBase, const auto& jetTag, float ptSumBase, float ptSumTag) {
+      if (isMatched(baseToTagMatchingGeo[jetBase.globalIndex()], jetTag.globalIndex()) && ptSumBase > jetBase.pt() * minPtFraction) {
+        baseToTagMatchingPt[jetBase.globalIndex()].push_back(jetTag.globalIndex());
+      }
+      if (isMatched(tagToBaseMatchingGeo[jetTag.globalIndex()], jetBase.globalIndex()) && ptSumTag > jetTag.pt() * minPtFraction) {
+        tagToBaseMatchingPt[jetTag.globalIndex()].push_back(jetBase.globalIndex());
+      }
+    });
 }
 
 // function that calls all the Match functions
 template <bool jetsBaseIsMc, bool jetsTagIsMc, typename T, typename U, typename V, typename M, typename N, typename O, typename P, typename R>
-void doAllMatching(T const& jetsBasePerCollision, U const& jetsTagPerCollision, std::vector<std::vector<int>>& baseToTagMatchingGeo, std::vector<std::vector<int>>& baseToTagMatchingPt, std::vector<std::vector<int>>& baseToTagMatchingHF, std::vector<std::vector<int>>& tagToBaseMatchingGeo, std::vector<std::vector<int>>& tagToBaseMatchingPt, std::vector<std::vector<int>>& tagToBaseMatchingHF, V const& candidatesBase, M const& tracksBase, N const& clustersBase, O const& candidatesTag, P const& tracksTag, R const& clustersTag, bool doMatchingGeo, bool doMatchingHf, bool doMatchingPt, float maxMatchingDistance, float minPtFraction)
+void doAllMatching(T const& jetsBasePerCollision, U const& jetsTagPerCollision, std::vector<std::vector<int>>& baseToTagMatchingGeo, std::vector<std::vector<int>>& baseToTagMatchingPt, std::vector<std::vector<int>>& baseToTagMatchingHF, std::vector<std::vector<int>>& tagToBaseMatchingGeo, std::vector<std::vector<int>>& tagToBaseMatchingPt, std::vector<std::vector<int>>& tagToBaseMatchingHF, V const& candidatesBase, M const& tracksBase, N const& clustersBase, O const& candidatesTag, P const& tracksTag, R const& clustersTag, bool doMatchingGeo, bool doMatchingHf, bool doMatchingPt, float maxMatchingDistance, float minPtFraction, bool doMatchingGeoPt = false)
 {
-  // geometric matching
-  if (doMatchingGeo) {
-    MatchGeo(jetsBasePerCollision, jetsTagPerCollision, baseToTagMatchingGeo, tagToBaseMatchingGeo, maxMatchingDistance);
-  }
-  // pt matching
-  if (doMatchingPt) {
-    MatchPt<jetsBaseIsMc, jetsTagIsMc>(jetsBasePerCollision, jetsTagPerCollision, baseToTagMatchingPt, tagToBaseMatchingPt, tracksBase, candidatesBase, clustersBase, tracksTag, candidatesTag, clustersTag, minPtFraction);
+  if (doMatchingPt && doMatchingGeoPt) {
+    // pt matching restricted to the geometrical matches
+    MatchGeoPt<jetsBaseIsMc, jetsTagIsMc>(jetsBasePerCollision, jetsTagPerCollision, baseToTagMatchingGeo, tagToBaseMatchingGeo, baseToTagMatchingPt, tagToBaseMatchingPt, tracksBase, candidatesBase, clustersBase, tracksTag, candidatesTag, clustersTag, maxMatchingDistance, minPtFraction);
+    if (!doMatchingGeo) {
+      for (const auto& jetBase : jetsBasePerCollision) {
+        baseToTagMatchingGeo[jetBase.globalIndex()].clear();
+      }
+      for (const auto& jetTag : jetsTagPerCollision) {
+        tagToBaseMatchingGeo[jetTag.globalIndex()].clear();
+      }
+    }
+  } else {
+    // geometric matching
+    if (doMatchingGeo) {
+      MatchGeo(jetsBasePerCollision, jetsTagPerCollision, baseToTagMatchingGeo, tagToBaseMatchingGeo, maxMatchingDistance);
+    }
+    // pt matching
+    if (doMatchingPt) {
+      MatchPt<jetsBaseIsMc, jetsTagIsMc>(jetsBasePerCollision, jetsTagPerCollision, baseToTagMatchingPt, tagToBaseMatchingPt, tracksBase, candidatesBase, clustersBase, tracksTag, candidatesTag, clustersTag, minPtFraction);
+    }
   }
   // HF matching
   if constexpr (jetcandidateutilities::isCandidateTable<V>() || jetcandidateutilities::isCandidateMcTable<V>()) {
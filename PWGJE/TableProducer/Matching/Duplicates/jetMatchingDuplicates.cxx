@@ -38,6 +38,7 @@ struct JetMatchingDuplicates {
   Configurable<bool> doMatchingGeo{"doMatchingGeo", true, "Enable geometric matching"};
   Configurable<bool> doMatchingPt{"doMatchingPt", true, "Enable pt matching"};
   Configurable<bool> doMatchingHf{"doMatchingHf", false, "Enable HF matching"};
+  Configurable<bool> doMatchingGeoPt{"doMatchingGeoPt", false, "Restrict the pt matching to the geometrically matched jets"};
   Configurable<float> maxMatchingDistance{"maxMatchingDistance", 0.24f, "Max matching distance"};
   Configurable<float> minPtFraction{"minPtFraction", 0.5f, "Minimum pt fraction for pt matching"};
 
@@ -76,7 +77,7 @@ struct JetMatchingDuplicates {
       const auto jetsBasePerColl = jetsBase.sliceBy(baseJetsPerCollision, collision.globalIndex());
       const auto jetsTagPerColl = jetsTag.sliceBy(tagJetsPerCollision, collision.globalIndex());
       // initialise template parameters as false since even if they are Mc we are not matching between detector and particle level
-      jetmatchingutilities::doAllMatching<false, false>(jetsBasePerColl, jetsTagPerColl, jetsBasetoTagMatchingGeo, jetsBasetoTagMatchingPt, jetsBasetoTagMatchingHF, jetsTagtoBaseMatchingGeo, jetsTagtoBaseMatchingPt, jetsTagtoBaseMatchingHF, candidates, tracks, tracks, candidates, tracks, tracks, doMatchingGeo, doMatchingHf, doMatchingPt, maxMatchingDistance, minPtFraction);
+      jetmatchingutilities::doAllMatching<false, false>(jetsBasePerColl, jetsTagPerColl, jetsBasetoTagMatchingGeo, jetsBasetoTagMatchingPt, jetsBasetoTagMatchingHF, jetsTagtoBaseMatchingGeo, jetsTagtoBaseMatchingPt, jetsTagtoBaseMatchingHF, candidates, tracks, tracks, candidates, tracks, tracks, doMatchingGeo, doMatchingHf, doMatchingPt, maxMatchingDistance, minPtFraction, doMatchingGeoPt);
     }
 
     for (auto i = 0; i < jetsBase.size(); ++i) {
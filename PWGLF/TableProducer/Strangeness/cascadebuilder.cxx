@@ -59,6 +59,7 @@
 #include "PWGLF/DataModel/LFStrangenessTables.h"
 #include "PWGLF/DataModel/LFStrangenessMLTables.h"
 #include "PWGLF/DataModel/LFParticleIdentification.h"
+#include "PWGLF/Utils/trackAtPVCache.h"
 #include "Common/Core/TrackSelection.h"
 #include "Common/DataModel/TrackSelectionTables.h"
 #include "DetectorsBase/Propagator.h"
@@ -139,6 +140,7 @@ struct cascadeBuilder {
   Service<o2::ccdb::BasicCCDBManager> ccdb;
 
   Configurable<bool> d_UseAutodetectMode{"d_UseAutodetectMode", false, "Autodetect requested topo sels"};
+  Configurable<bool> useTrackCache{"useTrackCache", true, "propagate each bachelor track to the PV once per time frame, sharing the result between cascades"};
 
   // Configurables related to table creation
   Configurable<int> createCascCovMats{"createCascCovMats", -1, {"Produces casc cov matrices. -1: auto, 0: don't, 1: yes. Default: auto (-1)"}};
@@ -269,6 +271,9 @@ struct cascadeBuilder {
 
   // Define o2 fitter, 2-prong, active memory (no need to redefine per event)
   o2::vertexing::DCAFitterN<2> fitter;
+
+  // bachelor tracks propagated to the PV, shared by all cascades of a time frame
+  o2::pwglf::trackAtPVCache trackCache;
   enum cascstep { kCascAll = 0,
                   kCascHasV0Data,
                   kCascLambdaMass,
@@ -395,6 +400,9 @@ struct cascadeBuilder {
         registry.fill(HIST("hBachelorITSClusters"), ii, statisticsRegistry.bachITSclu[ii]);
       }
     }
+    if (useTrackCache) {
+      trackCache.fillStatistics(registry);
+    }
   }
 
   void init(InitContext& context)
@@ -414,6 +422,11 @@ struct cascadeBuilder {
     h->GetXaxis()->SetBinLabel(9, "Pass dau eta");
     h->GetXaxis()->SetBinLabel(10, "Tracked");
 
+    trackCache.enabled = useTrackCache;
+    if (useTrackCache) {
+      o2::pwglf::trackAtPVCache::addStatisticsHistogram(registry, "Bachelor tracks propagated to the PV");
+    }
+
     // Optionally, add extra QA histograms to processing chain
     if (qaConfigurations.d_doQA) {
       // Basic histograms containing invariant masses of all built candidates
@@ -991,8 +1004,7 @@ struct cascadeBuilder {
     // Calculate DCA with respect to the collision associated to the V0, not individual tracks
     gpu::gpustd::array<float, 2> dcaInfo;
 
-    auto bachTrackPar = getTrackPar(bachTrack);
-    o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, bachTrackPar, 2.f, fitter.getMatCorrType(), &dcaInfo);
+    dcaInfo = trackCache.getDCAToPV(bachTrack.globalIndex(), collision.globalIndex(), collision.posX(), collision.posY(), collision.posZ(), getTrackPar(bachTrack), fitter.getMatCorrType());
     cascadecandidate.bachDCAxy = dcaInfo[0];
 
     if (TMath::Abs(cascadecandidate.bachDCAxy) < dcabachtopv)
@@ -1275,8 +1287,7 @@ struct cascadeBuilder {
     // Calculate DCA with respect to the collision associated to the V0, not individual tracks
     gpu::gpustd::array<float, 2> dcaInfo;
 
-    auto bachTrackPar = getTrackPar(bachTrack);
-    o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, bachTrackPar, 2.f, fitter.getMatCorrType(), &dcaInfo);
+    dcaInfo = trackCache.getDCAToPV(bachTrack.globalIndex(), collision.globalIndex(), collision.posX(), collision.posY(), collision.posZ(), getTrackPar(bachTrack), fitter.getMatCorrType());
     cascadecandidate.bachDCAxy = dcaInfo[0];
 
     o2::track::TrackParCov posTrackParCovForDCA = getTrackParCov(posTrack);
@@ -1622,6 +1633,7 @@ struct cascadeBuilder {
   void buildStrangenessTables(TCascTable const& cascades)
   {
     statisticsRegistry.eventCounter++;
+    trackCache.clear(); // tracks, vertices and field may all change from one time frame to the next
     for (auto& cascade : cascades) {
       // de-reference from V0 pool, either specific for cascades or general
       // use templatizing to avoid code duplication
@@ -1644,6 +1656,7 @@ struct cascadeBuilder {
   void buildKFStrangenessTables(TCascTable const& cascades)
   {
     statisticsRegistry.eventCounter++;
+    trackCache.clear(); // tracks, vertices and field may all change from one time frame to the next
     for (auto& cascade : cascades) {
       bool validCascadeCandidateKF = false;
       if constexpr (requires { cascade.template v0(); }) {
@@ -1705,6 +1718,7 @@ struct cascadeBuilder {
   void buildStrangenessTablesWithStrangenessTracking(TCascTable const& cascades, TStraTrack const& trackedCascades)
   {
     statisticsRegistry.eventCounter++;
+    trackCache.clear(); // tracks, vertices and field may all change from one time frame to the next
 
     for (auto& cascade : cascades) {
       // check if cascade is tracked - sliceBy is our friend!
@@ -58,6 +58,7 @@
 #include "PWGLF/DataModel/LFStrangenessTables.h"
 #include "PWGLF/DataModel/LFStrangenessMLTables.h"
 #include "PWGLF/DataModel/LFParticleIdentification.h"
+#include "PWGLF/Utils/trackAtPVCache.h"
 #include "Common/Core/TrackSelection.h"
 #include "Common/DataModel/TrackSelectionTables.h"
 #include "DetectorsBase/Propagator.h"
@@ -139,6 +140,7 @@ struct lambdakzeroBuilder {
 
   // use auto-detect configuration
   Configurable<bool> d_UseAutodetectMode{"d_UseAutodetectMode", false, "Autodetect requested topo sels"};
+  Configurable<bool> useTrackCache{"useTrackCache", true, "propagate each daughter track to the PV once per time frame, sharing the result between V0s"};
 
   // downscaling for testing
   unsigned int randomSeed = 0;
@@ -287,6 +289,9 @@ struct lambdakzeroBuilder {
   // Define o2 fitter, 2-prong, active memory (no need to redefine per event)
   o2::vertexing::DCAFitterN<2> fitter;
 
+  // daughter tracks propagated to the PV, shared by all V0s of a time frame
+  o2::pwglf::trackAtPVCache trackCache;
+
   // provision to repeat mass selections while doing AND with PID selections
   // fixme : this could be done more uniformly svertexer with reconstruction
   //         but that requires decoupling the mass window selections in O2
@@ -436,6 +441,9 @@ struct lambdakzeroBuilder {
         registry.fill(HIST("hNegativeITSClusters"), ii, statisticsRegistry.negITSclu[ii]);
       }
     }
+    if (useTrackCache) {
+      trackCache.fillStatistics(registry);
+    }
   }
 
   o2::track::TrackParCov lPositiveTrack;
@@ -469,6 +477,11 @@ struct lambdakzeroBuilder {
     h2->GetXaxis()->SetBinLabel(8, "Count: Standard V0");
     h2->GetXaxis()->SetBinLabel(9, "Count: V0 exc. for casc");
 
+    trackCache.enabled = useTrackCache;
+    if (useTrackCache) {
+      o2::pwglf::trackAtPVCache::addStatisticsHistogram(registry, "Daughter tracks propagated to the PV");
+    }
+
     randomSeed = static_cast<unsigned int>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
 
     // Optionally, add extra QA histograms to processing chain
@@ -840,12 +853,10 @@ struct lambdakzeroBuilder {
     // Calculate DCA with respect to the collision associated to the V0, not individual tracks
     gpu::gpustd::array<float, 2> dcaInfo;
 
-    auto posTrackPar = getTrackPar(posTrack);
-    o2::base::Propagator::Instance()->propagateToDCABxByBz({primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, posTrackPar, 2.f, fitter.getMatCorrType(), &dcaInfo);
+    dcaInfo = trackCache.getDCAToPV(posTrack.globalIndex(), V0.collisionId(), primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(), getTrackPar(posTrack), fitter.getMatCorrType());
     auto posTrackdcaXY = dcaInfo[0];
 
-    auto negTrackPar = getTrackPar(negTrack);
-    o2::base::Propagator::Instance()->propagateToDCABxByBz({primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, negTrackPar, 2.f, fitter.getMatCorrType(), &dcaInfo);
+    dcaInfo = trackCache.getDCAToPV(negTrack.globalIndex(), V0.collisionId(), primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(), getTrackPar(negTrack), fitter.getMatCorrType());
     auto negTrackdcaXY = dcaInfo[0];
 
     if (fabs(posTrackdcaXY) < dcapostopv || fabs(negTrackdcaXY) < dcanegtopv) {
@@ -1126,6 +1137,9 @@ struct lambdakzeroBuilder {
   template <class TTrackTo, typename TV0Table>
   void buildStrangenessTables(TV0Table const& V0s)
   {
+    // tracks, vertices and field may all change from one time frame to the next
+    trackCache.clear();
+
     // Loops over all V0s in the time frame
     for (auto& V0 : V0s) {
       // downscale some V0s if requested to do so
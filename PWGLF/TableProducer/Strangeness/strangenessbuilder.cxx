@@ -32,7 +32,11 @@
 //  -- v0builderopts ......: V0-specific building options (topological, etc)
 //  -- cascadebuilderopts .: cascade-specific building options (topological, etc)
 
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Framework/runDataProcessing.h"
@@ -273,6 +277,8 @@ struct StrangenessBuilder {
     Configurable<std::string> geoPath{"geoPath", "GLO/Config/GeometryAligned", "Path of the geometry file"};
   } ccdbConfigurations;
 
+  Configurable<bool> useTrackCache{"useTrackCache", true, "propagate each daughter track to the PV once per time frame, sharing the result between V0s and cascades"};
+
   Configurable<int> mc_findableMode{"mc_findableMode", 0, "0: disabled; 1: add findable-but-not-found to existing V0s from AO2D; 2: reset V0s and generate only findable-but-not-found"};
 
   // V0 building options
@@ -389,6 +395,19 @@ struct StrangenessBuilder {
     int bachTrackId = -1;
     bool found = false;
   };
+  // index of candidates by daughter track indices (pos, neg[, bachelor])
+  // for fast matching of findable candidates against the found ones
+  using daughterKey = std::array<int, 3>;
+  struct daughterKeyHash {
+    std::size_t operator()(const daughterKey& key) const
+    {
+      uint64_t hash = static_cast<uint32_t>(key[0]);
+      hash = hash * 0x9E3779B97F4A7C15ULL + static_cast<uint32_t>(key[1]);
+      hash = hash * 0x9E3779B97F4A7C15ULL + static_cast<uint32_t>(key[2]);
+      return static_cast<std::size_t>(hash ^ (hash >> 32));
+    }
+  };
+  using daughterIndex = std::unordered_map<daughterKey, int, daughterKeyHash>;
   std::vector<v0Entry> v0List;
   std::vector<cascadeEntry> cascadeList;
   std::vector<std::size_t> sorted_v0;
@@ -450,6 +469,10 @@ struct StrangenessBuilder {
     auto h2 = histos.add<TH1>("hInputStatistics", "hInputStatistics", kTH1D, {{nTablesConst, -0.5f, static_cast<float>(nTablesConst)}});
     h2->SetTitle("Input table sizes");
 
+    if (useTrackCache) {
+      o2::pwglf::trackAtPVCache::addStatisticsHistogram(histos, "Daughter tracks propagated to the PV");
+    }
+
     if (mc_findableMode.value > 0) {
       // save statistics of findable candidate processing
       auto hFindable = histos.add<TH1>("hFindableStatistics", "hFindableStatistics", kTH1D, {{6, -0.5f, 5.5f}});
@@ -568,6 +591,8 @@ struct StrangenessBuilder {
     straHelper.cascadeselections.dcacascdau = cascadeBuilderOpts.dcacascdau;
     straHelper.cascadeselections.lambdaMassWindow = cascadeBuilderOpts.lambdaMassWindow;
     straHelper.cascadeselections.maxDaughterEta = cascadeBuilderOpts.maxDaughterEta;
+
+    straHelper.trackCache.enabled = useTrackCache;
   }
 
   // for sorting
@@ -698,6 +723,8 @@ struct StrangenessBuilder {
     // 1: add extra findable that haven't been found
     // 2: generate only findable (no background)
 
+    auto start = std::chrono::high_resolution_clock::now();
+
     // redo lists from scratch
     v0List.clear();
     cascadeList.clear();
@@ -752,8 +779,27 @@ struct StrangenessBuilder {
     // any mode other than 0 will require mcParticles
     if constexpr (soa::is_table<TMCCollisions>) {
       if (mc_findableMode.value > 0) {
-        // for search if existing or not
-        int v0ListReconstructedSize = v0List.size();
+        // for search if existing or not: index the found V0s by daughters,
+        // keeping the first occurrence as the linear search would do
+        daughterIndex foundV0Index;
+        std::vector<v0Entry> v0ListFromAOD; // only used in mode 2, where v0List starts empty
+        if (mc_findableMode.value == 1) {
+          foundV0Index.reserve(v0List.size());
+          for (size_t ii = 0; ii < v0List.size(); ii++) {
+            foundV0Index.try_emplace(daughterKey{v0List[ii].posTrackId, v0List[ii].negTrackId, -1}, static_cast<int>(ii));
+          }
+        }
+        if (mc_findableMode.value == 2) {
+          foundV0Index.reserve(v0s.size());
+          v0ListFromAOD.reserve(v0s.size());
+          for (const auto& v0 : v0s) {
+            foundV0Index.try_emplace(daughterKey{v0.posTrackId(), v0.negTrackId(), -1}, static_cast<int>(v0ListFromAOD.size()));
+            currentV0Entry.globalId = v0.globalIndex();
+            currentV0Entry.v0Type = v0.v0Type();
+            currentV0Entry.isCollinearV0 = v0.isCollinearV0();
+            v0ListFromAOD.push_back(currentV0Entry);
+          }
+        }
 
         // find extra candidates, step 1: find subset of tracks that interest
         std::vector<trackEntry> positiveTrackArray;
@@ -804,18 +850,12 @@ struct StrangenessBuilder {
             }
             // findable mode 1: add non-reconstructed as v0Type 8
             if (mc_findableMode.value == 1) {
-              bool detected = false;
-              for (int ii = 0; ii < v0ListReconstructedSize; ii++) {
-                // check if this particular combination already exists in v0List
-                if (v0List[ii].posTrackId == positiveTrackIndex.globalId &&
-                    v0List[ii].negTrackId == negativeTrackIndex.globalId) {
-                  detected = true;
-                  // override pdg code with something useful for cascade findable math
-                  v0List[ii].pdgCode = positiveTrackIndex.pdgCode;
-                  break;
-                }
-              }
-              if (detected == false) {
+              // check if this particular combination already exists in v0List
+              auto foundV0 = foundV0Index.find({positiveTrackIndex.globalId, negativeTrackIndex.globalId, -1});
+              if (foundV0 != foundV0Index.end()) {
+                // override pdg code with something useful for cascade findable math
+                v0List[foundV0->second].pdgCode = positiveTrackIndex.pdgCode;
+              } else {
                 // collision index: from best-version-of-this-mcCollision
                 // nota bene: this could be negative, caution advised
                 currentV0Entry.globalId = -1;
@@ -853,17 +893,15 @@ struct StrangenessBuilder {
                 currentV0Entry.isCollinearV0 = true;
               }
               currentV0Entry.found = false;
-              for (const auto& v0 : v0s) {
-                if (v0.posTrackId() == positiveTrackIndex.globalId &&
-                    v0.negTrackId() == negativeTrackIndex.globalId) {
-                  // this will override type, but not collision index
-                  // N.B.: collision index checks still desirable!
-                  currentV0Entry.globalId = v0.globalIndex();
-                  currentV0Entry.v0Type = v0.v0Type();
-                  currentV0Entry.isCollinearV0 = v0.isCollinearV0();
-                  currentV0Entry.found = true;
-                  break;
-                }
+              auto foundV0 = foundV0Index.find({positiveTrackIndex.globalId, negativeTrackIndex.globalId, -1});
+              if (foundV0 != foundV0Index.end()) {
+                // this will override type, but not collision index
+                // N.B.: collision index checks still desirable!
+                auto const& v0 = v0ListFromAOD[foundV0->second];
+                currentV0Entry.globalId = v0.globalId;
+                currentV0Entry.v0Type = v0.v0Type;
+                currentV0Entry.isCollinearV0 = v0.isCollinearV0;
+                currentV0Entry.found = true;
               }
               if (v0BuilderOpts.mc_findableDetachedV0.value || currentV0Entry.collisionId >= 0) {
                 v0List.push_back(currentV0Entry);
@@ -905,8 +943,22 @@ struct StrangenessBuilder {
       // any mode other than 0 will require mcParticles
       if constexpr (soa::is_table<TMCCollisions>) {
         if (mc_findableMode.value > 0) {
-          // for search if existing or not
+          // for search if existing or not: index the found cascades by daughters
           size_t cascadeListReconstructedSize = cascadeList.size();
+          daughterIndex foundCascadeIndex;
+          if (mc_findableMode.value == 1) {
+            foundCascadeIndex.reserve(cascadeListReconstructedSize);
+            for (size_t ii = 0; ii < cascadeListReconstructedSize; ii++) {
+              foundCascadeIndex.try_emplace(daughterKey{cascadeList[ii].posTrackId, cascadeList[ii].negTrackId, cascadeList[ii].bachTrackId}, static_cast<int>(ii));
+            }
+          }
+          if (mc_findableMode.value == 2) {
+            foundCascadeIndex.reserve(cascades.size());
+            for (const auto& cascade : cascades) {
+              auto const& v0fromAOD = cascade.v0();
+              foundCascadeIndex.try_emplace(daughterKey{v0fromAOD.posTrackId(), v0fromAOD.negTrackId(), cascade.bachelorId()}, static_cast<int>(cascade.globalIndex()));
+            }
+          }
 
           // determine which tracks are of interest
           std::vector<trackEntry> bachelorTrackArray;
@@ -980,17 +1032,9 @@ struct StrangenessBuilder {
               // if we are here: v0 origin is 3312 or 3334, bachelor origin matches V0 origin
               // findable mode 1: add non-reconstructed as cascadeType 1
               if (mc_findableMode.value == 1) {
-                bool detected = false;
-                for (size_t ii = 0; ii < cascadeListReconstructedSize; ii++) {
-                  // check if this particular combination already exists in cascadeList
-                  // caution: use track indices (immutable) but not V0 indices (re-indexing)
-                  if (cascadeList[ii].posTrackId == v0.posTrackId &&
-                      cascadeList[ii].negTrackId == v0.negTrackId &&
-                      cascadeList[ii].bachTrackId == bachelorTrackIndex.globalId) {
-                    detected = true;
-                    break;
-                  }
-                }
+                // check if this particular combination already exists in cascadeList
+                // caution: use track indices (immutable) but not V0 indices (re-indexing)
+                bool detected = foundCascadeIndex.count({v0.posTrackId, v0.negTrackId, bachelorTrackIndex.globalId}) > 0;
                 if (detected == false) {
                   // collision index: from best-version-of-this-mcCollision
                   // nota bene: this could be negative, caution advised
@@ -1024,17 +1068,12 @@ struct StrangenessBuilder {
                 if (bestCollisionArray[bachelorTrackIndex.mcCollisionId] < 0) {
                   collisionLessCascades++;
                 }
-                for (const auto& cascade : cascades) {
-                  auto const& v0fromAOD = cascade.v0();
-                  if (v0fromAOD.posTrackId() == v0.posTrackId &&
-                      v0fromAOD.negTrackId() == v0.negTrackId &&
-                      cascade.bachelorId() == bachelorTrackIndex.globalId) {
-                    // this will override type, but not collision index
-                    // N.B.: collision index checks still desirable!
-                    currentCascadeEntry.found = true;
-                    currentCascadeEntry.globalId = cascade.globalIndex();
-                    break;
-                  }
+                auto foundCascade = foundCascadeIndex.find({v0.posTrackId, v0.negTrackId, bachelorTrackIndex.globalId});
+                if (foundCascade != foundCascadeIndex.end()) {
+                  // this will override type, but not collision index
+                  // N.B.: collision index checks still desirable!
+                  currentCascadeEntry.found = true;
+                  currentCascadeEntry.globalId = foundCascade->second;
                 }
                 if (cascadeBuilderOpts.mc_findableDetachedCascade.value || currentCascadeEntry.collisionId >= 0) {
                   cascadeList.push_back(currentCascadeEntry);
@@ -1047,15 +1086,17 @@ struct StrangenessBuilder {
           // correct. We'll have to loop over all V0s and find the appropriate matches
           // ---> but only in mode 1, and only for AO2D-native V0s
           if (mc_findableMode.value == 1) {
+            // index v0List by daughters in sorted way, keeping the first sorted position
+            daughterIndex sortedV0Index;
+            sortedV0Index.reserve(v0List.size());
+            for (size_t v0i = 0; v0i < v0List.size(); v0i++) {
+              auto const& v0 = v0List[sorted_v0[v0i]];
+              sortedV0Index.try_emplace(daughterKey{v0.posTrackId, v0.negTrackId, -1}, static_cast<int>(v0i));
+            }
             for (size_t casci = 0; casci < cascadeListReconstructedSize; casci++) {
-              // loop over v0List to find corresponding v0 index, but do it in sorted way
-              for (size_t v0i = 0; v0i < v0List.size(); v0i++) {
-                auto v0 = v0List[sorted_v0[v0i]];
-                if (cascadeList[casci].posTrackId == v0.posTrackId &&
-                    cascadeList[casci].negTrackId == v0.negTrackId) {
-                  cascadeList[casci].v0Id = v0i; // fix, point to correct V0 index
-                  break;
-                }
+              auto sortedV0 = sortedV0Index.find({cascadeList[casci].posTrackId, cascadeList[casci].negTrackId, -1});
+              if (sortedV0 != sortedV0Index.end()) {
+                cascadeList[casci].v0Id = sortedV0->second; // fix, point to correct V0 index
               }
             }
           }
@@ -1072,7 +1113,8 @@ struct StrangenessBuilder {
       sorted_cascade = sort_indices(cascadeList, (mc_findableMode.value > 0));
     }
 
-    LOGF(info, "AO2D input: %i V0s, %i cascades. Building list sizes: %i V0s, %i cascades", v0s.size(), cascades.size(), v0List.size(), cascadeList.size());
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    LOGF(info, "AO2D input: %i V0s, %i cascades. Building list sizes: %i V0s, %i cascades (prepared in %.3f ms)", v0s.size(), cascades.size(), v0List.size(), cascadeList.size(), elapsed);
   }
 
   //__________________________________________________
@@ -2139,6 +2181,9 @@ struct StrangenessBuilder {
     if (!initCCDB(bcs, collisions))
       return;
 
+    // track indices and vertices change with every time frame
+    straHelper.trackCache.clear();
+
     // reset vectors for cascade interlinks
     resetInterlinks();
 
@@ -2161,6 +2206,10 @@ struct StrangenessBuilder {
     }
 
     populateCascadeInterlinks();
+
+    if (useTrackCache) {
+      straHelper.trackCache.fillStatistics(histos);
+    }
   }
 
   void processRealData(soa::Join<aod::Collisions, aod::EvSels> const& collisions, aod::V0s const& v0s, aod::Cascades const& cascades, aod::TrackedCascades const& trackedCascades, FullTracksExtIU const& tracks, aod::BCsWithTimestamps const& bcs)
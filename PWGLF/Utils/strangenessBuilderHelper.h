@@ -21,6 +21,7 @@
 #include "DetectorsBase/GeometryManager.h"
 #include "CommonConstants/PhysicsConstants.h"
 #include "Common/Core/trackUtilities.h"
+#include "PWGLF/Utils/trackAtPVCache.h"
 #include "Tools/KFparticle/KFUtilities.h"
 
 #ifndef HomogeneousField
@@ -190,21 +191,13 @@ class strangenessBuilderHelper
     }
 
     // Calculate DCA with respect to the collision associated to the V0
-    gpu::gpustd::array<float, 2> dcaInfo;
-
-    // do DCA to PV on copies instead of originals
-    auto positiveTrackParamCopy = positiveTrackParam;
-    auto negativeTrackParamCopy = negativeTrackParam;
-
-    o2::base::Propagator::Instance()->propagateToDCABxByBz({pvX, pvY, pvZ}, positiveTrackParamCopy, 2.f, fitter.getMatCorrType(), &dcaInfo);
-    v0.positiveDCAxy = dcaInfo[0];
+    v0.positiveDCAxy = getDCAToPV(collisionIndex, pvX, pvY, pvZ, positiveTrack, positiveTrackParam)[0];
 
     if (std::fabs(v0.positiveDCAxy) < v0selections.dcanegtopv) {
       return false;
     }
 
-    o2::base::Propagator::Instance()->propagateToDCABxByBz({pvX, pvY, pvZ}, negativeTrackParamCopy, 2.f, fitter.getMatCorrType(), &dcaInfo);
-    v0.negativeDCAxy = dcaInfo[0];
+    v0.negativeDCAxy = getDCAToPV(collisionIndex, pvX, pvY, pvZ, negativeTrack, negativeTrackParam)[0];
 
     if (std::fabs(v0.negativeDCAxy) < v0selections.dcanegtopv) {
       return false;
@@ -346,21 +339,13 @@ class strangenessBuilderHelper
     }
 
     // Calculate DCA with respect to the collision associated to the V0
-    gpu::gpustd::array<float, 2> dcaInfo;
-
-    // do DCA to PV on copies instead of originals
-    auto positiveTrackParamCopy = positiveTrackParam;
-    auto negativeTrackParamCopy = negativeTrackParam;
-
-    o2::base::Propagator::Instance()->propagateToDCABxByBz({pvX, pvY, pvZ}, positiveTrackParamCopy, 2.f, fitter.getMatCorrType(), &dcaInfo);
-    v0.positiveDCAxy = dcaInfo[0];
+    v0.positiveDCAxy = getDCAToPV(collisionIndex, pvX, pvY, pvZ, positiveTrack, positiveTrackParam)[0];
 
     if (std::fabs(v0.positiveDCAxy) < v0selections.dcanegtopv) {
       return false;
     }
 
-    o2::base::Propagator::Instance()->propagateToDCABxByBz({pvX, pvY, pvZ}, negativeTrackParamCopy, 2.f, fitter.getMatCorrType(), &dcaInfo);
-    v0.negativeDCAxy = dcaInfo[0];
+    v0.negativeDCAxy = getDCAToPV(collisionIndex, pvX, pvY, pvZ, negativeTrack, negativeTrackParam)[0];
 
     if (std::fabs(v0.negativeDCAxy) < v0selections.dcanegtopv) {
       return false;
@@ -554,9 +539,7 @@ class strangenessBuilderHelper
     // Calculate DCA with respect to the collision associated to the V0, not individual tracks
     gpu::gpustd::array<float, 2> dcaInfo;
 
-    auto bachTrackPar = getTrackPar(bachelorTrack);
-    o2::base::Propagator::Instance()->propagateToDCABxByBz({pvX, pvY, pvZ}, bachTrackPar, 2.f, fitter.getMatCorrType(), &dcaInfo);
-    cascade.bachelorDCAxy = dcaInfo[0];
+    cascade.bachelorDCAxy = getDCAToPV(collisionIndex, pvX, pvY, pvZ, bachelorTrack, getTrackPar(bachelorTrack))[0];
 
     if (std::fabs(cascade.bachelorDCAxy) < cascadeselections.dcabachtopv) {
       return false;
@@ -760,15 +743,9 @@ class strangenessBuilderHelper
     // Calculate DCA with respect to the collision associated to the V0, not individual tracks
     gpu::gpustd::array<float, 2> dcaInfo;
 
-    auto bachTrackPar = getTrackPar(bachelorTrack);
-    o2::base::Propagator::Instance()->propagateToDCABxByBz({pvX, pvY, pvZ}, bachTrackPar, 2.f, fitter.getMatCorrType(), &dcaInfo);
-    cascade.bachelorDCAxy = dcaInfo[0];
-    o2::track::TrackParCov posTrackParCovForDCA = getTrackParCov(positiveTrack);
-    o2::base::Propagator::Instance()->propagateToDCABxByBz({pvX, pvY, pvZ}, posTrackParCovForDCA, 2.f, fitter.getMatCorrType(), &dcaInfo);
-    cascade.positiveDCAxy = dcaInfo[0];
-    o2::track::TrackParCov negTrackParCovForDCA = getTrackParCov(negativeTrack);
-    o2::base::Propagator::Instance()->propagateToDCABxByBz({pvX, pvY, pvZ}, negTrackParCovForDCA, 2.f, fitter.getMatCorrType(), &dcaInfo);
-    cascade.negativeDCAxy = dcaInfo[0];
+    cascade.bachelorDCAxy = getDCAToPV(collisionIndex, pvX, pvY, pvZ, bachelorTrack, getTrackPar(bachelorTrack))[0];
+    cascade.positiveDCAxy = getDCAToPV(collisionIndex, pvX, pvY, pvZ, positiveTrack, getTrackPar(positiveTrack))[0];
+    cascade.negativeDCAxy = getDCAToPV(collisionIndex, pvX, pvY, pvZ, negativeTrack, getTrackPar(negativeTrack))[0];
 
     if (std::fabs(cascade.bachelorDCAxy) < cascadeselections.dcabachtopv) {
       return false;
@@ -1015,6 +992,8 @@ class strangenessBuilderHelper
   v0candidate v0;           // storage for V0 candidate properties
   cascadeCandidate cascade; // storage for cascade candidate properties
 
+  trackAtPVCache trackCache; // daughter tracks propagated to the PV, shared by all candidates of a time frame
+
   // v0 candidate criteria
   struct {
     int minCrossedRows;
@@ -1038,6 +1017,13 @@ class strangenessBuilderHelper
   } cascadeselections;
 
  private:
+  // DCA of a track to the PV, from the track cache if enabled
+  template <typename TTrack, typename TTrackParametrization>
+  gpu::gpustd::array<float, 2> getDCAToPV(int collisionIndex, float pvX, float pvY, float pvZ, TTrack const& track, TTrackParametrization const& trackParam)
+  {
+    return trackCache.getDCAToPV(track.globalIndex(), collisionIndex, pvX, pvY, pvZ, trackParam, fitter.getMatCorrType());
+  }
+
   // internal helper to calculate DCAxy of a straight line to a given PV analytically
   float CalculateDCAStraightToPV(float X, float Y, float Z, float Px, float Py, float Pz, float pvX, float pvY, float pvZ)
   {
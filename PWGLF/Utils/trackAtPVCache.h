@@ -0,0 +1,128 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file  trackAtPVCache.h
+/// \brief Cache of the daughter tracks propagated to the primary vertex, shared by the strangeness builders
+///
+
+#ifndef PWGLF_UTILS_TRACKATPVCACHE_H_
+#define PWGLF_UTILS_TRACKATPVCACHE_H_
+
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+
+#include "DetectorsBase/Propagator.h"
+#include "Framework/HistogramRegistry.h"
+#include "ReconstructionDataFormats/Track.h"
+
+namespace o2
+{
+namespace pwglf
+{
+
+//__________________________________________
+// cache of tracks propagated to the primary vertex, keyed by (track, collision):
+// the same track is used as daughter of many V0s and as cascade bachelor
+class trackAtPVCache
+{
+ public:
+  struct propagatedTrack {
+    int pid = -1;                           // PID hypothesis used for the material correction
+    o2::track::TrackPar trackAtPV;          // parameters at the DCA to the PV (the covariance is not propagated)
+    gpu::gpustd::array<float, 2> dcaInfo{}; // DCAxy, DCAz
+  };
+
+  bool enabled = false;
+
+  // statistics, cumulative until resetStatistics is called
+  uint64_t nLookups = 0;
+  uint64_t nHits = 0;
+  double propagationTime = 0.; // seconds spent in propagations
+
+  // to be called whenever the tracks, the vertices or the magnetic field change (i.e. every time frame)
+  void clear() { entries.clear(); }
+  void resetStatistics()
+  {
+    nLookups = 0;
+    nHits = 0;
+    propagationTime = 0.;
+  }
+  // estimate of the time saved, assuming each hit would have cost an average propagation
+  double timeSaved() const { return nLookups > nHits ? propagationTime / (nLookups - nHits) * nHits : 0.; }
+
+  template <typename TTrackParametrization>
+  propagatedTrack const& propagateToPV(int trackIndex, int collisionIndex, float pvX, float pvY, float pvZ, TTrackParametrization const& trackParam, o2::base::Propagator::MatCorrType matCorr)
+  {
+    nLookups++;
+    const uint64_t key = (static_cast<uint64_t>(trackIndex) << 32) | static_cast<uint32_t>(collisionIndex);
+    auto [entry, inserted] = entries.try_emplace(key);
+    if (!inserted && entry->second.pid == trackParam.getPID()) {
+      nHits++;
+      return entry->second;
+    }
+    // not seen yet, or seen with another PID hypothesis (e.g. photon daughters): propagate and keep the latest
+    const auto start = std::chrono::steady_clock::now();
+    propagatedTrack& track = entry->second;
+    track.pid = trackParam.getPID();
+    track.trackAtPV = trackParam;
+    track.dcaInfo[0] = 999;
+    track.dcaInfo[1] = 999;
+    o2::base::Propagator::Instance()->propagateToDCABxByBz({pvX, pvY, pvZ}, track.trackAtPV, 2.f, matCorr, &track.dcaInfo);
+    propagationTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return track;
+  }
+
+  // DCA of a track to the PV, from the cache if enabled, otherwise propagating a copy of the track
+  template <typename TTrackParametrization>
+  gpu::gpustd::array<float, 2> getDCAToPV(int trackIndex, int collisionIndex, float pvX, float pvY, float pvZ, TTrackParametrization const& trackParam, o2::base::Propagator::MatCorrType matCorr)
+  {
+    if (enabled) {
+      return propagateToPV(trackIndex, collisionIndex, pvX, pvY, pvZ, trackParam, matCorr).dcaInfo;
+    }
+    auto trackParamCopy = trackParam;
+    gpu::gpustd::array<float, 2> dcaInfo;
+    dcaInfo[0] = 999;
+    dcaInfo[1] = 999;
+    o2::base::Propagator::Instance()->propagateToDCABxByBz({pvX, pvY, pvZ}, trackParamCopy, 2.f, matCorr, &dcaInfo);
+    return dcaInfo;
+  }
+
+  // books the statistics histogram, to be filled with fillStatistics
+  static void addStatisticsHistogram(o2::framework::HistogramRegistry& registry, const char* title)
+  {
+    auto hTrackCache = registry.add<TH1>("hTrackCacheStatistics", "hTrackCacheStatistics", o2::framework::kTH1D, {{4, -0.5f, 3.5f}});
+    hTrackCache->SetTitle(title);
+    hTrackCache->GetXaxis()->SetBinLabel(1, "Lookups");
+    hTrackCache->GetXaxis()->SetBinLabel(2, "Hits");
+    hTrackCache->GetXaxis()->SetBinLabel(3, "Propagation time (ms)");
+    hTrackCache->GetXaxis()->SetBinLabel(4, "Est. time saved (ms)");
+  }
+
+  // adds the statistics accumulated since the last call to the histogram and resets them
+  void fillStatistics(o2::framework::HistogramRegistry& registry)
+  {
+    registry.fill(HIST("hTrackCacheStatistics"), 0, nLookups);
+    registry.fill(HIST("hTrackCacheStatistics"), 1, nHits);
+    registry.fill(HIST("hTrackCacheStatistics"), 2, 1e3 * propagationTime);
+    registry.fill(HIST("hTrackCacheStatistics"), 3, 1e3 * timeSaved());
+    resetStatistics();
+  }
+
+ private:
+  std::unordered_map<uint64_t, propagatedTrack> entries;
+};
+
+} // namespace pwglf
+} // namespace o2
+
+#endif // PWGLF_UTILS_TRACKATPVCACHE_H_
@@ -23,6 +23,7 @@
 #include "Framework/AnalysisTask.h"
 #include "Framework/AnalysisDataModel.h"
 #include "Common/CCDB/EventSelectionParams.h"
+#include "Common/Core/GlobalBCIndex.h"
 #include "Common/DataModel/EventSelection.h"
 #include "CommonConstants/LHCConstants.h"
 #include "DataFormatsFIT/Triggers.h"
@@ -234,19 +235,6 @@ struct UpcCandProducer {
     return true;
   }
 
-  auto findClosestBC(uint64_t globalBC, std::map<uint64_t, int32_t>& bcs)
-  {
-    auto it = bcs.lower_bound(globalBC);
-    auto bc1 = it->first;
-    if (it != bcs.begin())
-      --it;
-    auto bc2 = it->first;
-    auto dbc1 = bc1 >= globalBC ? bc1 - globalBC : globalBC - bc1;
-    auto dbc2 = bc2 >= globalBC ? bc2 - globalBC : globalBC - bc2;
-    auto bc = (dbc1 <= dbc2) ? bc1 : bc2;
-    return bc;
-  }
-
   auto findClosestTrackBCiter(uint64_t globalBC, std::vector<BCTracksPair>& bcs)
   {
     auto it = std::lower_bound(bcs.begin(), bcs.end(), globalBC,
@@ -814,16 +802,16 @@ struct UpcCandProducer {
     std::sort(bcsMatchedTrIdsITSTPC.begin(), bcsMatchedTrIdsITSTPC.end(),
               [](const auto& left, const auto& right) { return left.first < right.first; });
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithTOR{};
-    std::map<uint64_t, int32_t> mapGlobalBcWithTVX{};
-    std::map<uint64_t, int32_t> mapGlobalBcWithTSC{};
+    o2::aod::common::GlobalBCIndex<int32_t> mapGlobalBcWithTOR{};
+    o2::aod::common::GlobalBCIndex<int32_t> mapGlobalBcWithTVX{};
+    o2::aod::common::GlobalBCIndex<int32_t> mapGlobalBcWithTSC{};
     for (const auto& ft0 : ft0s) {
       uint64_t globalBC = ft0.bc_as<TBCs>().globalBC();
       int32_t globalIndex = ft0.globalIndex();
       if (!(std::abs(ft0.timeA()) > 2.f && std::abs(ft0.timeC()) > 2.f))
-        mapGlobalBcWithTOR[globalBC] = globalIndex;
+        mapGlobalBcWithTOR.add(globalBC, globalIndex);
       if (TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitVertex)) { // TVX
-        mapGlobalBcWithTVX[globalBC] = globalIndex;
+        mapGlobalBcWithTVX.add(globalBC, globalIndex);
       }
       if (TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitCen)) { // TVX & TCE
         histRegistry.get<TH1>(HIST("hCountersTrg"))->Fill("TCE", 1);
@@ -831,19 +819,19 @@ struct UpcCandProducer {
       if (TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitVertex) &&
           (TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitCen) ||
            TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitSCen))) { // TVX & (TSC | TCE)
-        mapGlobalBcWithTSC[globalBC] = globalIndex;
+        mapGlobalBcWithTSC.add(globalBC, globalIndex);
       }
     }
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithV0A{};
+    o2::aod::common::GlobalBCIndex<int32_t> mapGlobalBcWithV0A{};
     for (const auto& fv0a : fv0as) {
       if (std::abs(fv0a.time()) > 15.f)
         continue;
       uint64_t globalBC = fv0a.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithV0A[globalBC] = fv0a.globalIndex();
+      mapGlobalBcWithV0A.add(globalBC, fv0a.globalIndex());
     }
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithZdc{};
+    o2::aod::common::GlobalBCIndex<int32_t> mapGlobalBcWithZdc{};
     for (const auto& zdc : zdcs) {
       if (std::abs(zdc.timeZNA()) > 2.f && std::abs(zdc.timeZNC()) > 2.f)
         continue;
@@ -852,9 +840,15 @@ struct UpcCandProducer {
       if (!(std::abs(zdc.timeZNC()) > 2.f))
         histRegistry.get<TH1>(HIST("hCountersTrg"))->Fill("ZNC", 1);
       auto globalBC = zdc.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithZdc[globalBC] = zdc.globalIndex();
+      mapGlobalBcWithZdc.add(globalBC, zdc.globalIndex());
     }
 
+    // sort the BC indices once filled
+    mapGlobalBcWithTOR.build();
+    mapGlobalBcWithTSC.build();
+    mapGlobalBcWithTVX.build();
+    mapGlobalBcWithV0A.build();
+    mapGlobalBcWithZdc.build();
     auto nTORs = mapGlobalBcWithTOR.size();
     auto nTSCs = mapGlobalBcWithTSC.size();
     auto nTVXs = mapGlobalBcWithTVX.size();
@@ -883,11 +877,12 @@ struct UpcCandProducer {
       fitInfo.distClosestBcTVX = 999;
       fitInfo.distClosestBcV0A = 999;
       if (nTORs > 0) {
-        uint64_t closestBcTOR = findClosestBC(globalBC, mapGlobalBcWithTOR);
+        int closestBcTOREntry = mapGlobalBcWithTOR.findClosest(globalBC);
+        uint64_t closestBcTOR = mapGlobalBcWithTOR.globalBC(closestBcTOREntry);
         fitInfo.distClosestBcTOR = globalBC - static_cast<int64_t>(closestBcTOR);
         if (std::abs(fitInfo.distClosestBcTOR) <= fFilterFT0)
           return false;
-        auto ft0Id = mapGlobalBcWithTOR.at(closestBcTOR);
+        auto ft0Id = mapGlobalBcWithTOR.payload(closestBcTOREntry);
         auto ft0 = ft0s.iteratorAt(ft0Id);
         fitInfo.timeFT0A = ft0.timeA();
         fitInfo.timeFT0C = ft0.timeC();
@@ -899,23 +894,26 @@ struct UpcCandProducer {
           fitInfo.ampFT0C += amp;
       }
       if (nTSCs > 0) {
-        uint64_t closestBcTSC = findClosestBC(globalBC, mapGlobalBcWithTSC);
+        int closestBcTSCEntry = mapGlobalBcWithTSC.findClosest(globalBC);
+        uint64_t closestBcTSC = mapGlobalBcWithTSC.globalBC(closestBcTSCEntry);
         fitInfo.distClosestBcTSC = globalBC - static_cast<int64_t>(closestBcTSC);
         if (std::abs(fitInfo.distClosestBcTSC) <= fFilterTSC)
           return false;
       }
       if (nTVXs > 0) {
-        uint64_t closestBcTVX = findClosestBC(globalBC, mapGlobalBcWithTVX);
+        int closestBcTVXEntry = mapGlobalBcWithTVX.findClosest(globalBC);
+        uint64_t closestBcTVX = mapGlobalBcWithTVX.globalBC(closestBcTVXEntry);
         fitInfo.distClosestBcTVX = globalBC - static_cast<int64_t>(closestBcTVX);
         if (std::abs(fitInfo.distClosestBcTVX) <= fFilterTVX)
           return false;
       }
       if (nFV0As > 0) {
-        uint64_t closestBcV0A = findClosestBC(globalBC, mapGlobalBcWithV0A);
+        int closestBcV0AEntry = mapGlobalBcWithV0A.findClosest(globalBC);
+        uint64_t closestBcV0A = mapGlobalBcWithV0A.globalBC(closestBcV0AEntry);
         fitInfo.distClosestBcV0A = globalBC - static_cast<int64_t>(closestBcV0A);
         if (std::abs(fitInfo.distClosestBcV0A) <= fFilterFV0)
           return false;
-        auto fv0aId = mapGlobalBcWithV0A.at(closestBcV0A);
+        auto fv0aId = mapGlobalBcWithV0A.payload(closestBcV0AEntry);
         auto fv0a = fv0as.iteratorAt(fv0aId);
         fitInfo.timeFV0A = fv0a.time();
         const auto& v0Amps = fv0a.amplitude();
@@ -954,9 +952,9 @@ struct UpcCandProducer {
       if (!updateFitInfo(globalBC, fitInfo))
         continue;
       if (nZdcs > 0) {
-        auto itZDC = mapGlobalBcWithZdc.find(globalBC);
-        if (itZDC != mapGlobalBcWithZdc.end()) {
-          const auto& zdc = zdcs.iteratorAt(itZDC->second);
+        int zdcEntry = mapGlobalBcWithZdc.find(globalBC);
+        if (zdcEntry != mapGlobalBcWithZdc.NotFound) {
+          const auto& zdc = zdcs.iteratorAt(mapGlobalBcWithZdc.payload(zdcEntry));
           float timeZNA = zdc.timeZNA();
           float timeZNC = zdc.timeZNC();
           float eComZNA = zdc.energyCommonZNA();
@@ -1023,9 +1021,9 @@ struct UpcCandProducer {
       if (!updateFitInfo(globalBC, fitInfo))
         continue;
       if (nZdcs > 0) {
-        auto itZDC = mapGlobalBcWithZdc.find(globalBC);
-        if (itZDC != mapGlobalBcWithZdc.end()) {
-          const auto& zdc = zdcs.iteratorAt(itZDC->second);
+        int zdcEntry = mapGlobalBcWithZdc.find(globalBC);
+        if (zdcEntry != mapGlobalBcWithZdc.NotFound) {
+          const auto& zdc = zdcs.iteratorAt(mapGlobalBcWithZdc.payload(zdcEntry));
           float timeZNA = zdc.timeZNA();
           float timeZNC = zdc.timeZNC();
           float eComZNA = zdc.energyCommonZNA();
@@ -1251,17 +1249,17 @@ struct UpcCandProducer {
 
   template <typename T>
   void fillAmplitudes(const T& t,
-                      const std::map<uint64_t, int32_t>& mapBCs,
+                      const o2::aod::common::GlobalBCIndex<int32_t>& mapBCs,
                       std::vector<float>& amps,
                       std::vector<int8_t>& relBCs,
                       uint64_t gbc)
   {
     auto s = gbc - fBCWindowFITAmps;
     auto e = gbc + (fBCWindowFITAmps - 1);
-    auto it = mapBCs.lower_bound(s);
-    while (it->first <= e && it != mapBCs.end()) {
-      int i = it->first - s;
-      auto id = it->second;
+    auto [first, last] = mapBCs.window(s, e);
+    for (int entry = first; entry < last; ++entry) {
+      int i = mapBCs.globalBC(entry) - s;
+      auto id = mapBCs.payload(entry);
       const auto& row = t.iteratorAt(id);
       float totalAmp = 0.f;
       if constexpr (std::is_same_v<T, o2::aod::FT0s>) {
@@ -1276,7 +1274,6 @@ struct UpcCandProducer {
         amps.push_back(totalAmp);
         relBCs.push_back(gbc - (i + s));
       }
-      ++it;
     }
   }
 
@@ -1316,7 +1313,7 @@ struct UpcCandProducer {
     std::sort(bcsMatchedTrIdsMCH.begin(), bcsMatchedTrIdsMCH.end(),
               [](const auto& left, const auto& right) { return left.first < right.first; });
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithT0A{};
+    o2::aod::common::GlobalBCIndex<int32_t> mapGlobalBcWithT0A{};
     for (const auto& ft0 : ft0s) {
       if (!TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitVertex))
         continue;
@@ -1326,20 +1323,20 @@ struct UpcCandProducer {
       if (std::abs(ft0.timeA()) > 2.f)
         continue;
       uint64_t globalBC = ft0.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithT0A[globalBC] = ft0.globalIndex();
+      mapGlobalBcWithT0A.add(globalBC, ft0.globalIndex());
     }
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithV0A{};
+    o2::aod::common::GlobalBCIndex<int32_t> mapGlobalBcWithV0A{};
     for (const auto& fv0a : fv0as) {
       if (!TESTBIT(fv0a.triggerMask(), o2::fit::Triggers::bitA))
         continue;
       if (std::abs(fv0a.time()) > 15.f)
         continue;
       uint64_t globalBC = fv0a.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithV0A[globalBC] = fv0a.globalIndex();
+      mapGlobalBcWithV0A.add(globalBC, fv0a.globalIndex());
     }
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithZdc{};
+    o2::aod::common::GlobalBCIndex<int32_t> mapGlobalBcWithZdc{};
     for (const auto& zdc : zdcs) {
       if (std::abs(zdc.timeZNA()) > 2.f && std::abs(zdc.timeZNC()) > 2.f)
         continue;
@@ -1348,10 +1345,10 @@ struct UpcCandProducer {
       if (!(std::abs(zdc.timeZNC()) > 2.f))
         histRegistry.get<TH1>(HIST("hCountersTrg"))->Fill("ZNC", 1);
       auto globalBC = zdc.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithZdc[globalBC] = zdc.globalIndex();
+      mapGlobalBcWithZdc.add(globalBC, zdc.globalIndex());
     }
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithFDD{};
+    o2::aod::common::GlobalBCIndex<int32_t> mapGlobalBcWithFDD{};
     uint8_t twoLayersA = 0;
     uint8_t twoLayersC = 0;
     for (const auto& fdd : fdds) {
@@ -1366,9 +1363,14 @@ struct UpcCandProducer {
       if ((twoLayersA == 0) && (twoLayersC == 0))
         continue;
       uint64_t globalBC = fdd.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithFDD[globalBC] = fdd.globalIndex();
+      mapGlobalBcWithFDD.add(globalBC, fdd.globalIndex());
     }
 
+    // sort the BC indices once filled
+    mapGlobalBcWithT0A.build();
+    mapGlobalBcWithV0A.build();
+    mapGlobalBcWithZdc.build();
+    mapGlobalBcWithFDD.build();
     auto nFT0s = mapGlobalBcWithT0A.size();
     auto nFV0As = mapGlobalBcWithV0A.size();
     auto nZdcs = mapGlobalBcWithZdc.size();
@@ -1425,12 +1427,13 @@ struct UpcCandProducer {
       uint8_t chFT0A = 0;
       uint8_t chFT0C = 0;
       if (nFT0s > 0) {
-        uint64_t closestBcT0A = findClosestBC(globalBC, mapGlobalBcWithT0A);
+        int closestBcT0AEntry = mapGlobalBcWithT0A.findClosest(globalBC);
+        uint64_t closestBcT0A = mapGlobalBcWithT0A.globalBC(closestBcT0AEntry);
         int64_t distClosestBcT0A = globalBC - static_cast<int64_t>(closestBcT0A);
         if (std::abs(distClosestBcT0A) <= fFilterFT0)
           continue;
         fitInfo.distClosestBcT0A = distClosestBcT0A;
-        auto ft0Id = mapGlobalBcWithT0A.at(closestBcT0A);
+        auto ft0Id = mapGlobalBcWithT0A.payload(closestBcT0AEntry);
         auto ft0 = ft0s.iteratorAt(ft0Id);
         fitInfo.timeFT0A = ft0.timeA();
         fitInfo.timeFT0C = ft0.timeC();
@@ -1444,12 +1447,13 @@ struct UpcCandProducer {
       }
       uint8_t chFV0A = 0;
       if (nFV0As > 0) {
-        uint64_t closestBcV0A = findClosestBC(globalBC, mapGlobalBcWithV0A);
+        int closestBcV0AEntry = mapGlobalBcWithV0A.findClosest(globalBC);
+        uint64_t closestBcV0A = mapGlobalBcWithV0A.globalBC(closestBcV0AEntry);
         int64_t distClosestBcV0A = globalBC - static_cast<int64_t>(closestBcV0A);
         if (std::abs(distClosestBcV0A) <= fFilterFV0)
           continue;
         fitInfo.distClosestBcV0A = distClosestBcV0A;
-        auto fv0aId = mapGlobalBcWithV0A.at(closestBcV0A);
+        auto fv0aId = mapGlobalBcWithV0A.payload(closestBcV0AEntry);
         auto fv0a = fv0as.iteratorAt(fv0aId);
         fitInfo.timeFV0A = fv0a.time();
         const auto& v0Amps = fv0a.amplitude();
@@ -1460,8 +1464,9 @@ struct UpcCandProducer {
       uint8_t chFDDA = 0;
       uint8_t chFDDC = 0;
       if (nFDDs > 0) {
-        uint64_t closestBcFDD = findClosestBC(globalBC, mapGlobalBcWithFDD);
-        auto fddId = mapGlobalBcWithFDD.at(closestBcFDD);
+        int closestBcFDDEntry = mapGlobalBcWithFDD.findClosest(globalBC);
+        uint64_t closestBcFDD = mapGlobalBcWithFDD.globalBC(closestBcFDDEntry);
+        auto fddId = mapGlobalBcWithFDD.payload(closestBcFDDEntry);
         auto fdd = fdds.iteratorAt(fddId);
         fitInfo.timeFDDA = fdd.timeA();
         fitInfo.timeFDDC = fdd.timeC();
@@ -1481,9 +1486,9 @@ struct UpcCandProducer {
         }
       }
       if (nZdcs > 0) {
-        auto itZDC = mapGlobalBcWithZdc.find(globalBC);
-        if (itZDC != mapGlobalBcWithZdc.end()) {
-          const auto& zdc = zdcs.iteratorAt(itZDC->second);
+        int zdcEntry = mapGlobalBcWithZdc.find(globalBC);
+        if (zdcEntry != mapGlobalBcWithZdc.NotFound) {
+          const auto& zdc = zdcs.iteratorAt(mapGlobalBcWithZdc.payload(zdcEntry));
           float timeZNA = zdc.timeZNA();
           float timeZNC = zdc.timeZNC();
           float eComZNA = zdc.energyCommonZNA();
@@ -1579,7 +1584,7 @@ struct UpcCandProducer {
     std::sort(bcsMatchedTrIdsGlobal.begin(), bcsMatchedTrIdsGlobal.end(),
               [](const auto& left, const auto& right) { return left.first < right.first; });
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithT0A{};
+    o2::aod::common::GlobalBCIndex<int32_t> mapGlobalBcWithT0A{};
     for (const auto& ft0 : ft0s) {
       if (!TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitVertex))
         continue;
@@ -1599,20 +1604,20 @@ struct UpcCandProducer {
       if (std::abs(ft0.timeA()) > 2.f)
         continue;
       uint64_t globalBC = ft0.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithT0A[globalBC] = ft0.globalIndex();
+      mapGlobalBcWithT0A.add(globalBC, ft0.globalIndex());
     }
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithV0A{};
+    o2::aod::common::GlobalBCIndex<int32_t> mapGlobalBcWithV0A{};
     for (const auto& fv0a : fv0as) {
       if (!TESTBIT(fv0a.triggerMask(), o2::fit::Triggers::bitA))
         continue;
       if (std::abs(fv0a.time()) > 15.f)
         continue;
       uint64_t globalBC = fv0a.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithV0A[globalBC] = fv0a.globalIndex();
+      mapGlobalBcWithV0A.add(globalBC, fv0a.globalIndex());
     }
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithZdc{};
+    o2::aod::common::GlobalBCIndex<int32_t> mapGlobalBcWithZdc{};
     for (const auto& zdc : zdcs) {
       if (std::abs(zdc.timeZNA()) > 2.f && std::abs(zdc.timeZNC()) > 2.f)
         continue;
@@ -1621,10 +1626,10 @@ struct UpcCandProducer {
       if (!(std::abs(zdc.timeZNC()) > 2.f))
         histRegistry.get<TH1>(HIST("hCountersTrg"))->Fill("ZNC", 1);
       auto globalBC = zdc.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithZdc[globalBC] = zdc.globalIndex();
+      mapGlobalBcWithZdc.add(globalBC, zdc.globalIndex());
     }
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithFDD{};
+    o2::aod::common::GlobalBCIndex<int32_t> mapGlobalBcWithFDD{};
     uint8_t twoLayersA = 0;
     uint8_t twoLayersC = 0;
     for (const auto& fdd : fdds) {
@@ -1639,9 +1644,14 @@ struct UpcCandProducer {
       if ((twoLayersA == 0) && (twoLayersC == 0))
         continue;
       uint64_t globalBC = fdd.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithFDD[globalBC] = fdd.globalIndex();
+      mapGlobalBcWithFDD.add(globalBC, fdd.globalIndex());
     }
 
+    // sort the BC indices once filled
+    mapGlobalBcWithT0A.build();
+    mapGlobalBcWithV0A.build();
+    mapGlobalBcWithZdc.build();
+    mapGlobalBcWithFDD.build();
     auto nFT0s = mapGlobalBcWithT0A.size();
     auto nFV0As = mapGlobalBcWithV0A.size();
     auto nZdcs = mapGlobalBcWithZdc.size();
@@ -1732,12 +1742,13 @@ struct UpcCandProducer {
       int zVtxFT0vPv = 0;
       int vtxITSTPC = 0;
       if (nFT0s > 0) {
-        uint64_t closestBcT0A = findClosestBC(globalBC, mapGlobalBcWithT0A);
+        int closestBcT0AEntry = mapGlobalBcWithT0A.findClosest(globalBC);
+        uint64_t closestBcT0A = mapGlobalBcWithT0A.globalBC(closestBcT0AEntry);
         int64_t distClosestBcT0A = globalBC - static_cast<int64_t>(closestBcT0A);
         if (std::abs(distClosestBcT0A) <= fFilterFT0)
           continue;
         fitInfo.distClosestBcT0A = distClosestBcT0A;
-        auto ft0Id = mapGlobalBcWithT0A.at(closestBcT0A);
+        auto ft0Id = mapGlobalBcWithT0A.payload(closestBcT0AEntry);
         auto ft0 = ft0s.iteratorAt(ft0Id);
         fitInfo.timeFT0A = ft0.timeA();
         fitInfo.timeFT0C = ft0.timeC();
@@ -1760,12 +1771,13 @@ struct UpcCandProducer {
       }
       uint8_t chFV0A = 0;
       if (nFV0As > 0) {
-        uint64_t closestBcV0A = findClosestBC(globalBC, mapGlobalBcWithV0A);
+        int closestBcV0AEntry = mapGlobalBcWithV0A.findClosest(globalBC);
+        uint64_t closestBcV0A = mapGlobalBcWithV0A.globalBC(closestBcV0AEntry);
         int64_t distClosestBcV0A = globalBC - static_cast<int64_t>(closestBcV0A);
         if (std::abs(distClosestBcV0A) <= fFilterFV0)
           continue;
         fitInfo.distClosestBcV0A = distClosestBcV0A;
-        auto fv0aId = mapGlobalBcWithV0A.at(closestBcV0A);
+        auto fv0aId = mapGlobalBcWithV0A.payload(closestBcV0AEntry);
         auto fv0a = fv0as.iteratorAt(fv0aId);
         fitInfo.timeFV0A = fv0a.time();
         const auto& v0Amps = fv0a.amplitude();
@@ -1776,8 +1788,9 @@ struct UpcCandProducer {
       uint8_t chFDDA = 0;
       uint8_t chFDDC = 0;
       if (nFDDs > 0) {
-        uint64_t closestBcFDD = findClosestBC(globalBC, mapGlobalBcWithFDD);
-        auto fddId = mapGlobalBcWithFDD.at(closestBcFDD);
+        int closestBcFDDEntry = mapGlobalBcWithFDD.findClosest(globalBC);
+        uint64_t closestBcFDD = mapGlobalBcWithFDD.globalBC(closestBcFDDEntry);
+        auto fddId = mapGlobalBcWithFDD.payload(closestBcFDDEntry);
         auto fdd = fdds.iteratorAt(fddId);
         fitInfo.timeFDDA = fdd.timeA();
         fitInfo.timeFDDC = fdd.timeC();
@@ -1797,9 +1810,9 @@ struct UpcCandProducer {
         }
       }
       if (nZdcs > 0) {
-        auto itZDC = mapGlobalBcWithZdc.find(globalBC);
-        if (itZDC != mapGlobalBcWithZdc.end()) {
-          const auto& zdc = zdcs.iteratorAt(itZDC->second);
+        int zdcEntry = mapGlobalBcWithZdc.find(globalBC);
+        if (zdcEntry != mapGlobalBcWithZdc.NotFound) {
+          const auto& zdc = zdcs.iteratorAt(mapGlobalBcWithZdc.payload(zdcEntry));
           float timeZNA = zdc.timeZNA();
           float timeZNC = zdc.timeZNC();
           float eComZNA = zdc.energyCommonZNA();
@@ -24,6 +24,7 @@
 #endif
 
 #include <map>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -171,20 +172,7 @@ class MlResponse
   {
     int nModel = findBin(candVar);
     auto output = getModelOutput(input, nModel);
-    uint8_t iClass{0};
-    for (const auto& outputValue : output) {
-      uint8_t dir = mCutDir.at(iClass);
-      if (dir != o2::cuts_ml::CutDirection::CutNot) {
-        if (dir == o2::cuts_ml::CutDirection::CutGreater && outputValue > mCuts.get(nModel, iClass)) {
-          return false;
-        }
-        if (dir == o2::cuts_ml::CutDirection::CutSmaller && outputValue < mCuts.get(nModel, iClass)) {
-          return false;
-        }
-      }
-      ++iClass;
-    }
-    return true;
+    return passesCuts(output.data(), nModel);
   }
 
   /// ML selections
@@ -197,20 +185,69 @@ class MlResponse
   {
     int nModel = findBin(candVar);
     output = getModelOutput(input, nModel);
-    uint8_t iClass{0};
-    for (const auto& outputValue : output) {
-      uint8_t dir = mCutDir.at(iClass);
-      if (dir != o2::cuts_ml::CutDirection::CutNot) {
-        if (dir == o2::cuts_ml::CutDirection::CutGreater && outputValue > mCuts.get(nModel, iClass)) {
-          return false;
-        }
-        if (dir == o2::cuts_ml::CutDirection::CutSmaller && outputValue < mCuts.get(nModel, iClass)) {
-          return false;
-        }
+    return passesCuts(output.data(), nModel);
+  }
+
+  /// ML selections for a batch of candidates, with one inference per model
+  /// \param inputs is the row-major matrix of input features, one row per candidate
+  /// \param candVars is a container of the variable values (e.g. pT) used to select which model to use, one per candidate
+  /// \param outputs is filled with the row-major matrix of model predictions, mNClasses per candidate
+  /// \param isSelected is filled with the booleans telling if the model predictions of each candidate pass the cuts
+  /// \note Per-candidate results are the same as the ones of isSelectedMl; the buffers are reused between calls
+  template <typename T>
+  void isSelectedMlBatch(std::span<const TypeOutputScore> inputs, T const& candVars, std::vector<TypeOutputScore>& outputs, std::vector<bool>& isSelected)
+  {
+    const std::size_t nCandidates = candVars.size();
+    outputs.resize(nCandidates * mNClasses);
+    isSelected.assign(nCandidates, false);
+    if (nCandidates == 0) {
+      return;
+    }
+    if (inputs.size() % nCandidates != 0) {
+      LOG(fatal) << "Number of input features (" << inputs.size() << ") is not a multiple of the number of candidates (" << nCandidates << ")!";
+    }
+    const std::size_t nFeatures = inputs.size() / nCandidates;
+
+    // group the candidates by model, keeping their order within each model
+    mBatchModelOffsets.assign(mNModels + 1, 0);
+    mBatchModels.resize(nCandidates);
+    for (std::size_t iCand{0}; iCand < nCandidates; ++iCand) {
+      int nModel = findBin(candVars[iCand]);
+      if (nModel < 0 || static_cast<std::size_t>(nModel) >= mModels.size()) {
+        LOG(fatal) << "Model index " << nModel << " is out of range! The number of initialised models is " << mModels.size() << ". Please check your configurables.";
+      }
+      mBatchModels[iCand] = nModel;
+      ++mBatchModelOffsets[nModel + 1];
+    }
+    for (std::size_t iModel{0}; iModel < mNModels; ++iModel) {
+      mBatchModelOffsets[iModel + 1] += mBatchModelOffsets[iModel];
+    }
+    mBatchCandidates.resize(nCandidates);
+    mBatchInputs.resize(inputs.size());
+    mBatchNextRows.assign(mBatchModelOffsets.begin(), mBatchModelOffsets.end() - 1);
+    for (std::size_t iCand{0}; iCand < nCandidates; ++iCand) {
+      const std::size_t iRow = mBatchNextRows[mBatchModels[iCand]]++;
+      mBatchCandidates[iRow] = iCand;
+      std::copy_n(inputs.begin() + iCand * nFeatures, nFeatures, mBatchInputs.begin() + iRow * nFeatures);
+    }
+
+    for (std::size_t iModel{0}; iModel < mNModels; ++iModel) {
+      const std::size_t firstRow = mBatchModelOffsets[iModel];
+      const std::size_t nRows = mBatchModelOffsets[iModel + 1] - firstRow;
+      if (nRows == 0) {
+        continue;
+      }
+      if (!mModels[iModel].template evalModelBatch<TypeOutputScore>(mBatchInputs.data() + firstRow * nFeatures, nRows, mBatchOutputs, nFeatures)) {
+        continue; // failed inference, candidates not selected
+      }
+      const std::size_t nOutputsPerRow = mBatchOutputs.size() / nRows;
+      for (std::size_t iRow{0}; iRow < nRows; ++iRow) {
+        const std::size_t iCand = mBatchCandidates[firstRow + iRow];
+        const TypeOutputScore* output = mBatchOutputs.data() + iRow * nOutputsPerRow;
+        std::copy_n(output, mNClasses, outputs.begin() + iCand * mNClasses);
+        isSelected[iCand] = passesCuts(output, iModel);
       }
-      ++iClass;
     }
-    return true;
   }
 
  protected:
@@ -227,6 +264,31 @@ class MlResponse
   virtual void setAvailableInputFeatures() { return; } // method to fill the map of available input features
 
  private:
+  std::vector<TypeOutputScore> mBatchInputs;   // input features of the batch, grouped by model
+  std::vector<TypeOutputScore> mBatchOutputs;  // model predictions for the candidates of one model
+  std::vector<std::size_t> mBatchCandidates;   // candidate index of each row of mBatchInputs
+  std::vector<std::size_t> mBatchModelOffsets; // first row of each model in mBatchInputs
+  std::vector<std::size_t> mBatchNextRows;     // next free row of each model in mBatchInputs
+  std::vector<int> mBatchModels;               // model index of each candidate of the batch
+
+  /// Applies the cuts of a model to its predictions
+  /// \param output points to the model predictions, mNClasses values
+  /// \param nModel is the model index
+  /// \return boolean telling if model predictions pass the cuts
+  bool passesCuts(const TypeOutputScore* output, int nModel) const
+  {
+    for (uint8_t iClass{0}; iClass < mNClasses; ++iClass) {
+      uint8_t dir = mCutDir.at(iClass);
+      if (dir == o2::cuts_ml::CutDirection::CutGreater && output[iClass] > mCuts.get(nModel, iClass)) {
+        return false;
+      }
+      if (dir == o2::cuts_ml::CutDirection::CutSmaller && output[iClass] < mCuts.get(nModel, iClass)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   /// Finds matching bin in mBinsLimits
   /// \param value e.g. pT
   /// \return index of the matching bin, used to access mModels
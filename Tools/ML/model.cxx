@@ -101,6 +101,10 @@ void OnnxModel::initModel(std::string localPath, bool enableOptimizations, int t
     mOutputShapes.emplace_back(mSession->GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape());
   }
 #endif
+  mInputNamesChar.reserve(mInputNames.size());
+  mOutputNamesChar.reserve(mOutputNames.size());
+  mMemoryInfo = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+
   LOG(info) << "Input Nodes:";
   for (size_t i = 0; i < mInputNames.size(); i++) {
     LOG(info) << "\t" << mInputNames[i] << " : " << printShape(mInputShapes[i]);
@@ -26,6 +26,7 @@
 #else
 #include <onnxruntime_cxx_api.h>
 #endif
+#include <array>
 #include <vector>
 #include <string>
 #include <memory>
@@ -62,19 +63,7 @@ class OnnxModel
     // assert(input[0].GetTensorTypeAndShapeInfo().GetShape() == getNumInputNodes()); --> Fails build in debug mode, TODO: assertion should be checked somehow
 
     try {
-#if __has_include(<onnxruntime/core/session/onnxruntime_cxx_api.h>)
-      auto outputTensors = mSession->Run(mInputNames, input, mOutputNames);
-#else
-      Ort::RunOptions runOptions;
-      std::vector<const char*> inputNamesChar(mInputNames.size(), nullptr);
-      std::transform(std::begin(mInputNames), std::end(mInputNames), std::begin(inputNamesChar),
-                     [&](const std::string& str) { return str.c_str(); });
-
-      std::vector<const char*> outputNamesChar(mOutputNames.size(), nullptr);
-      std::transform(std::begin(mOutputNames), std::end(mOutputNames), std::begin(outputNamesChar),
-                     [&](const std::string& str) { return str.c_str(); });
-      auto outputTensors = mSession->Run(runOptions, inputNamesChar.data(), input.data(), input.size(), outputNamesChar.data(), outputNamesChar.size());
-#endif
+      auto outputTensors = run(input.data(), input.size());
       LOG(debug) << "Number of output tensors: " << outputTensors.size();
       if (outputTensors.size() != mOutputNames.size()) {
         LOG(fatal) << "Number of output tensors: " << outputTensors.size() << " does not agree with the model specified size: " << mOutputNames.size();
@@ -100,13 +89,7 @@ class OnnxModel
     assert(size % mInputShapes[0][1] == 0);
     std::vector<int64_t> inputShape{size / mInputShapes[0][1], mInputShapes[0][1]};
     std::vector<Ort::Value> inputTensors;
-#if __has_include(<onnxruntime/core/session/onnxruntime_cxx_api.h>)
-    inputTensors.emplace_back(Ort::Experimental::Value::CreateTensor<T>(input.data(), size, inputShape));
-#else
-    Ort::MemoryInfo memInfo =
-      Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
-    inputTensors.emplace_back(Ort::Value::CreateTensor<T>(memInfo, input.data(), size, inputShape.data(), inputShape.size()));
-#endif
+    inputTensors.emplace_back(Ort::Value::CreateTensor<T>(mMemoryInfo, input.data(), size, inputShape.data(), inputShape.size()));
     LOG(debug) << "Input shape calculated from vector: " << printShape(inputShape);
     return evalModel<T>(inputTensors);
   }
@@ -117,10 +100,6 @@ class OnnxModel
   {
     std::vector<Ort::Value> inputTensors;
 
-#if !__has_include(<onnxruntime/core/session/onnxruntime_cxx_api.h>)
-    Ort::MemoryInfo memInfo = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
-#endif
-
     for (size_t iinput = 0; iinput < input.size(); iinput++) {
       [[maybe_unused]] int totalSize = 1;
       int64_t size = input[iinput].size();
@@ -134,16 +113,35 @@ class OnnxModel
         inputShape.push_back(mInputShapes[iinput][idim]);
       }
 
-#if __has_include(<onnxruntime/core/session/onnxruntime_cxx_api.h>)
-      inputTensors.emplace_back(Ort::Experimental::Value::CreateTensor<T>(input[iinput].data(), size, inputShape));
-#else
-      inputTensors.emplace_back(Ort::Value::CreateTensor<T>(memInfo, input[iinput].data(), size, inputShape.data(), inputShape.size()));
-#endif
+      inputTensors.emplace_back(Ort::Value::CreateTensor<T>(mMemoryInfo, input[iinput].data(), size, inputShape.data(), inputShape.size()));
     }
 
     return evalModel<T>(inputTensors);
   }
 
+  // For batches of inputs: row-major matrix of nRows x nFeatures, nFeatures has to match getNumInputNodes(). The last output
+  // tensor is copied to output (nRows x number of output values per row). Returns false if the inference failed
+  template <typename T>
+  bool evalModelBatch(T* input, int64_t nRows, std::vector<T>& output, int64_t nFeatures)
+  {
+    if (nFeatures != mInputShapes[0][1]) {
+      LOG(error) << "Number of features per row: " << nFeatures << " does not agree with the model input: " << mInputShapes[0][1];
+      return false;
+    }
+    const std::array<int64_t, 2> inputShape{nRows, mInputShapes[0][1]};
+    Ort::Value inputTensor = Ort::Value::CreateTensor<T>(mMemoryInfo, input, nRows * inputShape[1], inputShape.data(), inputShape.size());
+    try {
+      auto outputTensors = run(&inputTensor, 1);
+      const Ort::Value& outputTensor = outputTensors.back();
+      const T* outputValues = outputTensor.GetTensorData<T>();
+      output.assign(outputValues, outputValues + outputTensor.GetTensorTypeAndShapeInfo().GetElementCount());
+      return true;
+    } catch (const Ort::Exception& exception) {
+      LOG(error) << "Error running batched model inference: " << exception.what();
+    }
+    return false;
+  }
+
   // Reset session
 #if __has_include(<onnxruntime/core/session/onnxruntime_cxx_api.h>)
   void resetSession() { mSession.reset(new Ort::Experimental::Session{*mEnv, modelPath, sessionOptions}); }
@@ -187,12 +185,34 @@ class OnnxModel
   std::vector<std::string> mOutputNames;
   std::vector<std::vector<int64_t>> mOutputShapes;
 
+  // Objects reused by all inferences: node names as passed to Ort::Session::Run, CPU memory info of the input tensors
+  // The node names point into mInputNames and mOutputNames and are refreshed at each run, as the strings move with the model
+  std::vector<const char*> mInputNamesChar;
+  std::vector<const char*> mOutputNamesChar;
+  Ort::MemoryInfo mMemoryInfo{nullptr};
+  Ort::RunOptions mRunOptions;
+
   // Environment settings
   std::string modelPath;
   int activeThreads = 0;
   uint64_t validFrom = 0;
   uint64_t validUntil = 0;
 
+  // Internal function running the session on the given input tensors, with all the output nodes
+  std::vector<Ort::Value> run(const Ort::Value* input, std::size_t nInputs)
+  {
+    mInputNamesChar.resize(mInputNames.size());
+    for (std::size_t i = 0; i < mInputNames.size(); i++) {
+      mInputNamesChar[i] = mInputNames[i].c_str();
+    }
+    mOutputNamesChar.resize(mOutputNames.size());
+    for (std::size_t i = 0; i < mOutputNames.size(); i++) {
+      mOutputNamesChar[i] = mOutputNames[i].c_str();
+    }
+    // the base class Run is hidden by the overloads of the experimental session
+    return static_cast<Ort::Session&>(*mSession).Run(mRunOptions, mInputNamesChar.data(), input, nInputs, mOutputNamesChar.data(), mOutputNamesChar.size());
+  }
+
   // Internal function for printing the shape of tensors
   std::string printShape(const std::vector<int64_t>&);
   bool checkHyperloop(bool = true);